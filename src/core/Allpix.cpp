@@ -27,6 +27,7 @@
 
 #include "core/config/exceptions.h"
 #include "core/utils/log.h"
+#include "core/utils/numa.h"
 #include "core/utils/unit.h"
 
 #include "tools/units.h"
@@ -95,6 +96,9 @@ Allpix::Allpix(std::string config_file_name,
         Log::addStream(log_file_);
     }
 
+    // Hand log messages to a background thread for formatting and writing
+    Log::setAsynchronous(global_config.get<bool>("async_logging", false));
+
     // Wait for the first detailed messages until level and format are properly set
     LOG(TRACE) << "Global log level is set to " << log_level_string;
     LOG(TRACE) << "Global log format is set to " << log_format_string;
@@ -219,6 +223,37 @@ void Allpix::initialize() {
 void Allpix::run() {
     if(!terminate_) {
         LOG(TRACE) << "Running Allpix";
+        Configuration& global_config = conf_mgr_->getGlobalConfiguration();
+
+        // Interleave electric field and doping profile before replicating, such that the combined grid is copied as well
+        if(global_config.get<bool>("fuse_fields", false)) {
+            LOG(STATUS) << "Combining electric field and doping profile grids for a single field lookup";
+            for(auto& detector : geo_mgr_->getDetectors()) {
+                detector->setFuseFields(true);
+            }
+        }
+
+        // Copy the field grids to all NUMA nodes such that bound workers read them from local memory
+        if(global_config.get<bool>("replicate_fields", false)) {
+            // Unbound threads always read the copy of the first node, replicating would only waste memory
+            if(!global_config.get<bool>("multithreading") ||
+               global_config.get<std::string>("worker_affinity", "none") == "none") {
+                LOG(WARNING) << "Workers are not bound to CPUs, field grids are not replicated";
+            } else {
+                LOG(STATUS) << "Replicating field grids on " << NumaTopology::nodeCount() << " NUMA node(s)";
+                for(auto& detector : geo_mgr_->getDetectors()) {
+                    detector->replicateFields();
+                }
+            }
+        }
+
+        if(global_config.get<bool>("compact_pixels", false)) {
+            LOG(STATUS) << "Storing compact pixels, resolving pixel geometry through the detectors";
+            for(auto& detector : geo_mgr_->getDetectors()) {
+                detector->setCompactPixels(true);
+            }
+        }
+
         mod_mgr_->run(seeder_modules_);
 
         // Set that we have run and want to finalize as well
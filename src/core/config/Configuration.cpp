@@ -41,6 +41,34 @@ void Configuration::AccessMarker::registerMarker(const std::string& key) {
     markers_.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple());
 }
 
+Configuration::ValueCache& Configuration::ValueCache::operator=(const Configuration::ValueCache&) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    values_.clear();
+    return *this;
+}
+
+Configuration::ValueCache& Configuration::ValueCache::operator=(Configuration::ValueCache&&) noexcept {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    values_.clear();
+    return *this;
+}
+
+void Configuration::ValueCache::invalidate(const std::string& key) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    values_.erase(key);
+}
+
+std::vector<std::string> Configuration::ValueCache::getTrackedKeys() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return {tracked_keys_.begin(), tracked_keys_.end()};
+}
+
+std::atomic<bool> Configuration::access_tracking_{false};
+
+void Configuration::setAccessTracking(bool track) {
+    access_tracking_.store(track);
+}
+
 Configuration::Configuration(std::string name, std::filesystem::path path)
     : name_(std::move(name)), path_(std::move(path)) {}
 
@@ -78,6 +106,27 @@ std::string Configuration::getText(const std::string& key, const std::string& de
     return getText(key);
 }
 
+/**
+ * @throws MissingKeyError If the requested key is not defined
+ * @throws InvalidKeyError If the array cannot be parsed
+ */
+std::vector<std::string> Configuration::getTextArray(const std::string& key) const {
+    try {
+        auto node = parse_value(config_.at(key));
+        used_keys_.markUsed(key);
+
+        std::vector<std::string> array;
+        for(auto& child : node->children) {
+            array.push_back(child->value);
+        }
+        return array;
+    } catch(std::out_of_range& e) {
+        throw MissingKeyError(key, getName());
+    } catch(std::invalid_argument& e) {
+        throw InvalidKeyError(key, getName(), config_.at(key), typeid(std::vector<std::string>), e.what());
+    }
+}
+
 /**
  * @throws InvalidValueError If the path did not exists while the check_exists parameter is given
  *
@@ -147,6 +196,7 @@ std::filesystem::path Configuration::path_to_absolute(std::filesystem::path path
 
 void Configuration::setText(const std::string& key, const std::string& val) {
     config_[key] = val;
+    cache_.invalidate(key);
     used_keys_.registerMarker(key);
 }
 
@@ -159,6 +209,7 @@ void Configuration::setAlias(const std::string& new_key, const std::string& old_
     }
     try {
         config_[new_key] = config_.at(old_key);
+        cache_.invalidate(new_key);
         used_keys_.registerMarker(new_key);
         used_keys_.markUsed(old_key);
     } catch(std::out_of_range& e) {
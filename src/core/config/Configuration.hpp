@@ -12,12 +12,19 @@
 #ifndef ALLPIX_CONFIGURATION_H
 #define ALLPIX_CONFIGURATION_H
 
+#include <any>
 #include <atomic>
 #include <filesystem>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <shared_mutex>
 #include <stdexcept>
 #include <string>
+#include <typeindex>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -88,6 +95,79 @@ namespace allpix {
             std::map<std::string, std::atomic<bool>> markers_;
         };
 
+        /**
+         * @brief Helper class to cache converted values of configuration keys
+         *
+         * This class stores the values of all keys which have been converted before, separately for every requested type.
+         * Repeated access to a key therefore does not parse the stored string again. The cached values of a key have to be
+         * invalidated whenever the key is changed. Copies of the cache start empty.
+         */
+        class ValueCache {
+        public:
+            /**
+             * Default constructor
+             */
+            ValueCache() = default;
+
+            /**
+             * @brief Copy constructor creating an empty cache
+             */
+            ValueCache(const ValueCache&) {}
+
+            /**
+             * @brief Copy assignment operator clearing the cache
+             */
+            ValueCache& operator=(const ValueCache& rhs);
+
+            /**
+             * @brief Move constructor creating an empty cache
+             */
+            ValueCache(ValueCache&&) noexcept {}
+
+            /**
+             * @brief Move assignment operator clearing the cache
+             */
+            ValueCache& operator=(ValueCache&& rhs) noexcept;
+
+            /**
+             * @brief Default destructor
+             */
+            ~ValueCache() = default;
+
+            /**
+             * @brief Retrieve the cached value of a key
+             * @param key Key to look up
+             * @return Copy of the cached value if the key has been converted to the requested type before
+             * @note This method is thread-safe. The access is recorded if access tracking is enabled.
+             */
+            template <typename T> std::optional<T> find(const std::string& key) const;
+
+            /**
+             * @brief Store a converted value of a key
+             * @param key Key to store the value for
+             * @param value Converted value
+             * @note This method is thread-safe
+             */
+            template <typename T> void store(const std::string& key, const T& value);
+
+            /**
+             * @brief Remove all cached values of a key
+             * @param key Key to invalidate
+             */
+            void invalidate(const std::string& key);
+
+            /**
+             * @brief Obtain all keys accessed while access tracking was enabled
+             * @return Sorted list of keys
+             */
+            std::vector<std::string> getTrackedKeys() const;
+
+        private:
+            mutable std::shared_mutex mutex_;
+            std::unordered_map<std::string, std::vector<std::pair<std::type_index, std::any>>> values_;
+            mutable std::set<std::string> tracked_keys_;
+        };
+
     public:
         /**
          * @brief Construct a configuration object
@@ -190,6 +270,14 @@ namespace allpix {
          */
         std::string getText(const std::string& key, const std::string& def) const;
 
+        /**
+         * @brief Get literal values of the elements of an array
+         * @param key Key to get values of
+         * @return List of literal values of the array elements, with the outer brackets of nested arrays removed
+         * @note This function does also not remove quotation marks in strings
+         */
+        std::vector<std::string> getTextArray(const std::string& key) const;
+
         /**
          * @brief Get absolute path to file with paths relative to the configuration
          * @param key Key to get path of
@@ -319,6 +407,20 @@ namespace allpix {
          */
         std::vector<std::string> getUnusedKeys() const;
 
+        /**
+         * @brief Enable or disable the tracking of key access for all configurations
+         * @param track True to record every key read via the typed getters, false to stop recording
+         *
+         * This is used to find keys which are read during the event loop and could be retrieved once during initialization.
+         */
+        static void setAccessTracking(bool track);
+
+        /**
+         * @brief Obtain all keys which have been accessed while access tracking was enabled
+         * @return Sorted list of keys
+         */
+        std::vector<std::string> getTrackedKeys() const { return cache_.getTrackedKeys(); }
+
     private:
         /**
          * @brief Make relative paths absolute from this configuration file
@@ -348,6 +450,9 @@ namespace allpix {
         using ConfigMap = std::map<std::string, std::string>;
         ConfigMap config_;
         mutable AccessMarker used_keys_;
+        mutable ValueCache cache_;
+
+        static std::atomic<bool> access_tracking_;
     };
 } // namespace allpix
 
@@ -10,17 +10,59 @@
  */
 
 namespace allpix {
+    template <typename T> std::optional<T> Configuration::ValueCache::find(const std::string& key) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if(access_tracking_.load(std::memory_order_relaxed)) {
+            // Upgrading the lock is not possible, the tracking mode is only meant for profiling
+            lock.unlock();
+            std::unique_lock<std::shared_mutex> unique_lock(mutex_);
+            tracked_keys_.insert(key);
+            unique_lock.unlock();
+            lock.lock();
+        }
+
+        auto iter = values_.find(key);
+        if(iter == values_.end()) {
+            return std::nullopt;
+        }
+        for(const auto& [type, value] : iter->second) {
+            if(type == typeid(T)) {
+                return std::any_cast<const T&>(value);
+            }
+        }
+        return std::nullopt;
+    }
+
+    template <typename T> void Configuration::ValueCache::store(const std::string& key, const T& value) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto& values = values_[key];
+        for(const auto& cached : values) {
+            if(cached.first == typeid(T)) {
+                return;
+            }
+        }
+        values.emplace_back(typeid(T), value);
+    }
+
     /**
      * @throws MissingKeyError If the requested key is not defined
      * @throws InvalidKeyError If the conversion to the requested type did not succeed
      * @throws InvalidKeyError If an overflow happened while converting the key
+     *
+     * The converted value is cached, such that subsequent calls for the same key and type do not parse the value again.
      */
     template <typename T> T Configuration::get(const std::string& key) const {
+        if(auto cached = cache_.find<T>(key)) {
+            return std::move(*cached);
+        }
+
         try {
             auto node = parse_value(config_.at(key));
             used_keys_.markUsed(key);
             try {
-                return allpix::from_string<T>(node->value);
+                auto value = allpix::from_string<T>(node->value);
+                cache_.store(key, value);
+                return value;
             } catch(std::invalid_argument& e) {
                 throw InvalidKeyError(key, getName(), node->value, typeid(T), e.what());
             }
@@ -37,6 +79,9 @@ namespace allpix {
      * @throws InvalidKeyError If an overflow happened while converting the key
      */
     template <typename T> T Configuration::get(const std::string& key, const T& def) const {
+        if(auto cached = cache_.find<T>(key)) {
+            return std::move(*cached);
+        }
         if(has(key)) {
             return get<T>(key);
         }
@@ -49,6 +94,10 @@ namespace allpix {
      * @throws InvalidKeyError If an overflow happened while converting the key
      */
     template <typename T> std::vector<T> Configuration::getArray(const std::string& key) const {
+        if(auto cached = cache_.find<std::vector<T>>(key)) {
+            return std::move(*cached);
+        }
+
         try {
             std::string str = config_.at(key);
             used_keys_.markUsed(key);
@@ -62,6 +111,7 @@ namespace allpix {
                     throw InvalidKeyError(key, getName(), child->value, typeid(T), e.what());
                 }
             }
+            cache_.store(key, array);
             return array;
         } catch(std::out_of_range& e) {
             throw MissingKeyError(key, getName());
@@ -88,6 +138,10 @@ namespace allpix {
      * @throws InvalidKeyError If an overflow happened while converting the key
      */
     template <typename T> Matrix<T> Configuration::getMatrix(const std::string& key) const {
+        if(auto cached = cache_.find<Matrix<T>>(key)) {
+            return std::move(*cached);
+        }
+
         try {
             std::string str = config_.at(key);
             used_keys_.markUsed(key);
@@ -110,6 +164,7 @@ namespace allpix {
                 }
                 matrix.push_back(array);
             }
+            cache_.store(key, matrix);
             return matrix;
         } catch(std::out_of_range& e) {
             throw MissingKeyError(key, getName());
@@ -133,6 +188,7 @@ namespace allpix {
 
     template <typename T> void Configuration::set(const std::string& key, const T& val, bool mark_used) {
         config_[key] = allpix::to_string(val);
+        cache_.invalidate(key);
         used_keys_.registerMarker(key);
         if(mark_used) {
             used_keys_.markUsed(key);
@@ -150,6 +206,7 @@ namespace allpix {
         }
         ret_str.pop_back();
         config_[key] = ret_str;
+        cache_.invalidate(key);
         used_keys_.registerMarker(key);
     }
 
@@ -162,6 +219,7 @@ namespace allpix {
         }
         str.pop_back();
         config_[key] = str;
+        cache_.invalidate(key);
         used_keys_.registerMarker(key);
         if(mark_used) {
             used_keys_.markUsed(key);
@@ -187,6 +245,7 @@ namespace allpix {
         str.pop_back();
         str += "]";
         config_[key] = str;
+        cache_.invalidate(key);
         used_keys_.registerMarker(key);
     }
 
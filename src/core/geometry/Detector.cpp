@@ -9,6 +9,7 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <cmath>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -19,6 +20,7 @@
 
 #include "Detector.hpp"
 #include "core/module/exceptions.h"
+#include "core/utils/unit.h"
 
 using namespace allpix;
 
@@ -49,7 +51,8 @@ Detector::Detector(std::string name,
  * model is added.
  */
 Detector::Detector(std::string name, ROOT::Math::XYZPoint position, const ROOT::Math::Rotation3D& orientation)
-    : name_(std::move(name)), position_(std::move(position)), orientation_(orientation), magnetic_field_on_(false) {}
+    : Pixel::Geometry(name), name_(std::move(name)), position_(std::move(position)), orientation_(orientation),
+      magnetic_field_on_(false) {}
 
 void Detector::set_model(std::shared_ptr<DetectorModel> model) {
     model_ = std::move(model);
@@ -58,6 +61,7 @@ void Detector::set_model(std::shared_ptr<DetectorModel> model) {
     electric_field_.set_model(model_);
     weighting_potential_.set_model(model_);
     doping_profile_.set_model(model_);
+    fused_fields_.set_model(model_);
 
     build_transform();
 }
@@ -97,18 +101,32 @@ Pixel Detector::getPixel(int x, int y) const {
 }
 
 /**
- * The pixel has internal information about the size and location specific for this detector
+ * The pixel has internal information about the size and location specific for this detector, unless compact pixels are
+ * requested. Compact pixels resolve their size and location through this detector.
  */
 Pixel Detector::getPixel(const Pixel::Index& index) const {
-    auto size = model_->getPixelSize();
     auto type = model_->getPixelType();
+    if(compact_pixels_) {
+        return {index, type, this};
+    }
 
+    auto size = model_->getPixelSize();
     auto local_center = model_->getPixelCenter(index.x(), index.y());
     auto global_center = getGlobalPosition(local_center);
 
     return {index, type, local_center, global_center, size};
 }
 
+ROOT::Math::XYZPoint Detector::getPixelLocalCenter(const Pixel::Index& index) const {
+    return model_->getPixelCenter(index.x(), index.y());
+}
+ROOT::Math::XYZPoint Detector::getPixelGlobalCenter(const Pixel::Index& index) const {
+    return getGlobalPosition(getPixelLocalCenter(index));
+}
+ROOT::Math::XYVector Detector::getPixelSize(const Pixel::Index&) const {
+    return model_->getPixelSize();
+}
+
 /**
  * The electric field is replicated for all pixels and uses flipping at each boundary (side effects are not modeled in this
  * stage). Outside of the sensor the electric field is strictly zero by definition.
@@ -120,7 +138,7 @@ ROOT::Math::XYZVector Detector::getElectricField(const ROOT::Math::XYZPoint& loc
 /**
  * @throws std::invalid_argument If the electric field dimensions are incorrect or the thickness domain is outside the sensor
  */
-void Detector::setElectricFieldGrid(const std::shared_ptr<std::vector<double>>& field,
+void Detector::setElectricFieldGrid(FieldGrid field,
                                     std::array<size_t, 3> bins,
                                     std::array<double, 3> size,
                                     FieldMapping mapping,
@@ -128,13 +146,15 @@ void Detector::setElectricFieldGrid(const std::shared_ptr<std::vector<double>>&
                                     std::array<double, 2> offset,
                                     std::pair<double, double> thickness_domain) {
     check_field_match(size, mapping, scales, thickness_domain);
-    electric_field_.setGrid(field, bins, size, mapping, scales, offset, thickness_domain);
+    electric_field_.setGrid(std::move(field), bins, size, mapping, scales, offset, thickness_domain);
+    update_fused_fields();
 }
 
 void Detector::setElectricFieldFunction(FieldFunction<ROOT::Math::XYZVector> function,
                                         std::pair<double, double> thickness_domain,
                                         FieldType type) {
     electric_field_.setFunction(std::move(function), thickness_domain, type);
+    update_fused_fields();
 }
 
 /**
@@ -153,7 +173,7 @@ double Detector::getWeightingPotential(const ROOT::Math::XYZPoint& local_pos, co
  * @throws std::invalid_argument If the weighting potential dimensions are incorrect or the thickness domain is outside the
  * sensor
  */
-void Detector::setWeightingPotentialGrid(const std::shared_ptr<std::vector<double>>& potential,
+void Detector::setWeightingPotentialGrid(FieldGrid potential,
                                          std::array<size_t, 3> bins,
                                          std::array<double, 3> size,
                                          FieldMapping mapping,
@@ -161,7 +181,7 @@ void Detector::setWeightingPotentialGrid(const std::shared_ptr<std::vector<doubl
                                          std::array<double, 2> offset,
                                          std::pair<double, double> thickness_domain) {
     check_field_match(size, mapping, scales, thickness_domain);
-    weighting_potential_.setGrid(potential, bins, size, mapping, scales, offset, thickness_domain);
+    weighting_potential_.setGrid(std::move(potential), bins, size, mapping, scales, offset, thickness_domain);
 }
 
 void Detector::setWeightingPotentialFunction(FieldFunction<double> function,
@@ -184,6 +204,18 @@ ROOT::Math::XYZVector Detector::getMagneticField(const ROOT::Math::XYZPoint&) co
     return magnetic_field_;
 }
 
+void Detector::replicateFields() {
+    electric_field_.replicate();
+    weighting_potential_.replicate();
+    doping_profile_.replicate();
+    fused_fields_.replicate();
+}
+
+void Detector::setFuseFields(bool fuse) {
+    fuse_fields_ = fuse;
+    update_fused_fields();
+}
+
 /**
  * The doping profile is replicated for all pixels and uses flipping at each boundary (side effects are not modeled in this
  * stage). Outside of the sensor the doping profile is strictly zero by definition.
@@ -199,7 +231,7 @@ double Detector::getDopingConcentration(const ROOT::Math::XYZPoint& pos) const {
  * The doping profile is stored as a large flat array. If the sizes are denoted as respectively X_SIZE, Y_ SIZE and Z_SIZE,
  * each position (x, y, z) has one index, calculated as x*Y_SIZE*Z_SIZE+y*Z_SIZE+z
  */
-void Detector::setDopingProfileGrid(std::shared_ptr<std::vector<double>> field,
+void Detector::setDopingProfileGrid(FieldGrid field,
                                     std::array<size_t, 3> bins,
                                     std::array<double, 3> size,
                                     FieldMapping mapping,
@@ -208,6 +240,7 @@ void Detector::setDopingProfileGrid(std::shared_ptr<std::vector<double>> field,
                                     std::pair<double, double> thickness_domain) {
     check_field_match(size, mapping, scales, thickness_domain);
     doping_profile_.setGrid(std::move(field), bins, size, mapping, scales, offset, thickness_domain);
+    update_fused_fields();
 }
 
 void Detector::setDopingProfileFunction(FieldFunction<double> function, FieldType type) {
@@ -215,6 +248,121 @@ void Detector::setDopingProfileFunction(FieldFunction<double> function, FieldTyp
                                 {model_->getSensorCenter().z() - model_->getSensorSize().z() / 2,
                                  model_->getSensorCenter().z() + model_->getSensorSize().z() / 2},
                                 type);
+    update_fused_fields();
+}
+
+/**
+ * The electric field is only defined within its thickness domain while the doping profile is extrapolated along z. The
+ * interleaved grid is therefore queried with extrapolation and the electric field is discarded outside its domain.
+ */
+FieldSample Detector::getFields(const ROOT::Math::XYZPoint& local_pos) const {
+    if(fused_fields_.getType() != FieldType::GRID) {
+        FieldSample sample;
+        sample.electric_field = electric_field_.get(local_pos);
+        sample.doping_concentration = doping_profile_.get(local_pos, true);
+        return sample;
+    }
+
+    auto sample = fused_fields_.get(local_pos, true);
+    auto z_ind = fused_fields_.get_z_index(local_pos.z());
+    if(z_ind < 0 || z_ind >= static_cast<int>(fused_fields_.bins_[2])) {
+        sample.electric_field = {};
+    }
+    return sample;
+}
+
+FieldSample Detector::getFields(const ROOT::Math::XYZPoint& local_pos, const Pixel::Index& reference) const {
+    auto sample = getFields(local_pos);
+    sample.weighting_potential = getWeightingPotential(local_pos, reference);
+    return sample;
+}
+
+/**
+ * Both fields need to share the grid binning as well as mapping, scaling, offset and thickness domain. The interleaved grid
+ * stores the three electric field components followed by the doping concentration for every grid point. Grids stored with
+ * reduced precision are not interleaved to not increase their memory footprint again. Nothing is built unless fusing has
+ * been enabled via setFuseFields(). The interleaved grid is only used if its lookups reproduce the separate lookups at a set
+ * of probe points.
+ */
+void Detector::update_fused_fields() {
+    fused_fields_.field_ = {};
+    fused_fields_.replicas_.clear();
+    fused_fields_.type_ = FieldType::NONE;
+
+    if(!fuse_fields_) {
+        return;
+    }
+    if(electric_field_.getType() != FieldType::GRID || doping_profile_.getType() != FieldType::GRID) {
+        return;
+    }
+    if(electric_field_.bins_ != doping_profile_.bins_ || electric_field_.mapping_ != doping_profile_.mapping_ ||
+       electric_field_.normalization_ != doping_profile_.normalization_ ||
+       electric_field_.offset_ != doping_profile_.offset_ ||
+       electric_field_.thickness_domain_ != doping_profile_.thickness_domain_) {
+        LOG(DEBUG) << "Electric field and doping profile grids of detector " << name_
+                   << " differ, using separate field lookups";
+        return;
+    }
+    if(electric_field_.field_.getPrecision() != FieldPrecision::DOUBLE ||
+       doping_profile_.field_.getPrecision() != FieldPrecision::DOUBLE) {
+        LOG(DEBUG) << "Electric field and doping profile grids of detector " << name_
+                   << " are stored with reduced precision, using separate field lookups";
+        return;
+    }
+
+    const auto& efield = electric_field_.field_.getValues();
+    const auto& doping = doping_profile_.field_.getValues();
+    auto fused = std::make_shared<std::vector<double>>();
+    fused->reserve(doping.size() * 4);
+    for(size_t i = 0; i < doping.size(); ++i) {
+        fused->push_back(efield[3 * i]);
+        fused->push_back(efield[3 * i + 1]);
+        fused->push_back(efield[3 * i + 2]);
+        fused->push_back(doping[i]);
+    }
+
+    fused_fields_.field_ = std::move(fused);
+    fused_fields_.bins_ = electric_field_.bins_;
+    fused_fields_.mapping_ = electric_field_.mapping_;
+    fused_fields_.normalization_ = electric_field_.normalization_;
+    fused_fields_.offset_ = electric_field_.offset_;
+    fused_fields_.thickness_domain_ = electric_field_.thickness_domain_;
+    fused_fields_.type_ = FieldType::GRID;
+
+    // Compare with the separate lookups close to the pixel edges and at all bin boundaries along z, including the edges of
+    // the thickness domain beyond which the electric field vanishes while the doping profile is extrapolated
+    auto pitch = model_->getPixelSize();
+    auto n_pixels = model_->getNPixels();
+    const auto& domain = fused_fields_.thickness_domain_;
+    size_t probes = 0;
+    for(const auto& [px, py] : {std::make_pair(0, 0),
+                                std::make_pair(static_cast<int>(n_pixels.x()) - 1, static_cast<int>(n_pixels.y()) - 1)}) {
+        auto center = model_->getPixelCenter(px, py);
+        for(auto dx : {-0.49, 0., 0.49}) {
+            for(auto dy : {-0.49, 0., 0.49}) {
+                for(size_t bin = 0; bin <= fused_fields_.bins_[2]; ++bin) {
+                    auto z = domain.first + (domain.second - domain.first) * static_cast<double>(bin) /
+                                                static_cast<double>(fused_fields_.bins_[2]);
+                    for(auto probe_z : {std::nextafter(z, -INFINITY), z, std::nextafter(z, INFINITY)}) {
+                        ROOT::Math::XYZPoint probe(center.x() + dx * pitch.x(), center.y() + dy * pitch.y(), probe_z);
+                        auto sample = getFields(probe);
+                        if(sample.electric_field != electric_field_.get(probe) ||
+                           sample.doping_concentration != doping_profile_.get(probe, true)) {
+                            LOG(WARNING) << "Interleaved electric field and doping profile grid of detector " << name_
+                                         << " differs from the separate field lookups at "
+                                         << Units::display(probe, {"mm", "um"}) << ", using separate field lookups";
+                            fused_fields_.field_ = {};
+                            fused_fields_.type_ = FieldType::NONE;
+                            return;
+                        }
+                        ++probes;
+                    }
+                }
+            }
+        }
+    }
+    LOG(INFO) << "Using interleaved electric field and doping profile grid for detector " << name_
+              << ", matching the separate field lookups at " << probes << " points";
 }
 
 void Detector::check_field_match(std::array<double, 3> size,
@@ -36,9 +36,9 @@ namespace allpix {
      * @brief Instantiation of a detector model in the world
      *
      * Contains the detector in the world with several unique properties (like the electric field). All model specific
-     * properties are stored in its DetectorModel instead.
+     * properties are stored in its DetectorModel instead. The detector provides the geometry of compact pixels.
      */
-    class Detector {
+    class Detector : public Pixel::Geometry {
         friend class GeometryManager;
 
     public:
@@ -102,6 +102,33 @@ namespace allpix {
          */
         Pixel getPixel(const Pixel::Index& index) const;
 
+        /**
+         * @brief Get center position of a pixel in local coordinates
+         * @param index Index of the pixel
+         * @return Local center position
+         */
+        ROOT::Math::XYZPoint getPixelLocalCenter(const Pixel::Index& index) const override;
+        /**
+         * @brief Get center position of a pixel in global coordinates
+         * @param index Index of the pixel
+         * @return Global center position
+         */
+        ROOT::Math::XYZPoint getPixelGlobalCenter(const Pixel::Index& index) const override;
+        /**
+         * @brief Get size of a pixel
+         * @param index Index of the pixel
+         * @return Pixel size
+         */
+        ROOT::Math::XYVector getPixelSize(const Pixel::Index& index) const override;
+
+        /**
+         * @brief Set whether pixels returned by this detector are compact
+         * @param compact True to only store the index with the pixels and resolve location and size through this detector
+         *
+         * This should only be called before the event loop.
+         */
+        void setCompactPixels(bool compact) { compact_pixels_ = compact; }
+
         /**
          * @brief Returns if the detector has an electric field in the sensor
          * @return True if the detector has an electric field, false otherwise
@@ -130,7 +157,7 @@ namespace allpix {
          * @param offset Offset of the field, given in fractions of the field size in x and y
          * @param thickness_domain Domain in local coordinates in the thickness direction where the field holds
          */
-        void setElectricFieldGrid(const std::shared_ptr<std::vector<double>>& field,
+        void setElectricFieldGrid(FieldGrid field,
                                   std::array<size_t, 3> bins,
                                   std::array<double, 3> size,
                                   FieldMapping mapping,
@@ -175,7 +202,7 @@ namespace allpix {
          * @param offset Offset of the field, given in fractions of the field size in x and y
          * @param thickness_domain Domain in local coordinates in the thickness direction where the profile holds
          */
-        void setDopingProfileGrid(std::shared_ptr<std::vector<double>> field,
+        void setDopingProfileGrid(FieldGrid field,
                                   std::array<size_t, 3> bins,
                                   std::array<double, 3> size,
                                   FieldMapping mapping,
@@ -219,7 +246,7 @@ namespace allpix {
          * @param offset Offset of the field, given in fractions of the field size in x and y
          * @param thickness_domain Domain in local coordinates in the thickness direction where the potential holds
          */
-        void setWeightingPotentialGrid(const std::shared_ptr<std::vector<double>>& potential,
+        void setWeightingPotentialGrid(FieldGrid potential,
                                        std::array<size_t, 3> bins,
                                        std::array<double, 3> size,
                                        FieldMapping mapping,
@@ -236,6 +263,25 @@ namespace allpix {
                                            std::pair<double, double> thickness_domain,
                                            FieldType type = FieldType::CUSTOM);
 
+        /**
+         * @brief Get electric field and doping concentration in the sensor at a local position from a single lookup
+         * @param local_pos Position in the local frame
+         * @return Combined sample of the electric field and the doping concentration at the queried point
+         *
+         * If electric field and doping profile are both provided as grids with identical binning, mapping and domain, the
+         * values are stored interleaved and retrieved with a single index computation. Otherwise, the individual fields are
+         * queried. The results are identical to calling \ref getElectricField and \ref getDopingConcentration.
+         */
+        FieldSample getFields(const ROOT::Math::XYZPoint& local_pos) const;
+
+        /**
+         * @brief Get electric field, doping concentration and weighting potential in the sensor at a local position
+         * @param local_pos Position in the local frame
+         * @param reference Index of the pixel for which the weighting potential is requested
+         * @return Combined sample of all sensor fields at the queried point
+         */
+        FieldSample getFields(const ROOT::Math::XYZPoint& local_pos, const Pixel::Index& reference) const;
+
         /**
          * @brief Set the magnetic field in the detector
          * @param b_field Vector indicating strength and direction of the magnetic field
@@ -254,6 +300,23 @@ namespace allpix {
          */
         ROOT::Math::XYZVector getMagneticField(const ROOT::Math::XYZPoint& local_pos) const;
 
+        /**
+         * @brief Create copies of all field grids on every NUMA node of the system
+         *
+         * Threads bound to a NUMA node read the fields from the copy on their own node. This should only be called before
+         * the event loop, after all fields have been set.
+         */
+        void replicateFields();
+
+        /**
+         * @brief Set whether the electric field and doping profile grids are combined into an interleaved grid
+         * @param fuse True to build the interleaved grid if both fields are compatible grids
+         *
+         * The interleaved grid is stored in addition to the individual fields and doubles the memory required for them. This
+         * should only be called before the event loop, after all fields have been set.
+         */
+        void setFuseFields(bool fuse);
+
         /**
          * @brief Get the model of this detector
          * @return Pointer to the constant detector model
@@ -292,8 +355,16 @@ namespace allpix {
                                std::array<double, 2> field_scale,
                                std::pair<double, double> thickness_domain) const;
 
+        /**
+         * @brief Build the interleaved grid of electric field and doping profile if both grids are compatible and stored in
+         * double precision
+         */
+        void update_fused_fields();
+
         std::string name_;
         std::shared_ptr<DetectorModel> model_;
+        bool compact_pixels_{false};
+        bool fuse_fields_{false};
 
         ROOT::Math::XYZPoint position_;
         ROOT::Math::Rotation3D orientation_;
@@ -313,6 +384,9 @@ namespace allpix {
 
         // Doping profile properties
         DetectorField<double, 1> doping_profile_;
+
+        // Interleaved electric field and doping profile, only set if requested and both are grids with identical binning
+        DetectorField<FieldSample, 4> fused_fields_;
     };
 
 } // namespace allpix
@@ -22,6 +22,8 @@
 #include <Math/Vector3D.h>
 
 #include "DetectorModel.hpp"
+#include "FieldGrid.hpp"
+#include "core/utils/numa.h"
 #include "objects/Pixel.hpp"
 #include "tools/ROOT.h"
 
@@ -87,6 +89,30 @@ namespace allpix {
      */
     template <> inline void flip_vector_components<double>(double&, bool, bool) {}
 
+    /**
+     * @brief Combined sample of the sensor fields at a single position
+     *
+     * Holds the electric field, the doping concentration and optionally the weighting potential as obtained from a single
+     * lookup. The constructor from four values allows to fill the sample directly from an interleaved field grid.
+     */
+    struct FieldSample {
+        FieldSample() = default;
+        FieldSample(double ex, double ey, double ez, double doping)
+            : electric_field(ex, ey, ez), doping_concentration(doping) {}
+
+        ROOT::Math::XYZVector electric_field{};
+        double doping_concentration{};
+        double weighting_potential{};
+    };
+
+    /*
+     * Combined field sample template specialization of helper function for field flipping
+     * Only the electric field components are inverted, the scalar quantities remain unchanged
+     */
+    template <> inline void flip_vector_components<FieldSample>(FieldSample& sample, bool x, bool y) {
+        flip_vector_components(sample.electric_field, x, y);
+    }
+
     /**
      * @brief Field instance of a detector
      *
@@ -136,7 +162,7 @@ namespace allpix {
 
         /**
          * @brief Set the field in the detector using a grid
-         * @param field Flat array of the field
+         * @param field Flat array of the field, stored with the precision of the grid
          * @param bins The bins of the flat field array
          * @param size Physical extent of the field
          * @param mapping Specification of the mapping of the field onto the pixel plane
@@ -144,7 +170,7 @@ namespace allpix {
          * @param offset Offset of the field from the pixel center, given in fractions of the field size in x and y
          * @param thickness_domain Domain in local coordinates in the thickness direction where the field holds
          */
-        void setGrid(std::shared_ptr<std::vector<double>> field,
+        void setGrid(FieldGrid field,
                      std::array<size_t, 3> bins,
                      std::array<double, 3> size,
                      FieldMapping mapping,
@@ -168,12 +194,20 @@ namespace allpix {
          */
         void set_model(const std::shared_ptr<DetectorModel>& model) { model_ = model; }
 
+        /**
+         * @brief Create a copy of the field grid on every NUMA node, used by threads bound to the respective node
+         */
+        void replicate();
+
         /**
          * @brief Helper function to retrieve the return type from a calculated index of the field data vector
+         * @param field The field data vector to read from
+         * @param decode Callable converting a stored value to double precision
          * @param offset The calculated global index to start from
          * @note The index sequence is expanded to the number of elements requested, depending on the template instance
          */
-        template <std::size_t... I> auto get_impl(size_t offset, std::index_sequence<I...>) const;
+        template <typename V, typename D, std::size_t... I>
+        auto get_impl(const std::vector<V>& field, const D& decode, size_t offset, std::index_sequence<I...>) const;
 
         /**
          * @brief Helper function to calculate the field index based on the distance from its center and to return the values
@@ -188,6 +222,13 @@ namespace allpix {
                               const bool flip_x = false,
                               const bool flip_y = false) const;
 
+        /**
+         * @brief Helper function to calculate the index of the grid bin along z containing a position
+         * @param z Position along the z axis in local coordinates
+         * @return Index of the bin, outside the range of bins for positions outside of the thickness domain
+         */
+        int get_z_index(double z) const;
+
         /**
          * Field properties
          * * bins of the field map (bins in x, y, z)
@@ -205,14 +246,18 @@ namespace allpix {
          * returning the value at each position given in local coordinates. The field is valid within the thickness domain
          * specified, the configured type is stored to allow additional checks in the modules requesting the field.
          *
-         * In case of using a field grid, the field is stored as a large flat array. If the sizes are denoted as X_SIZE, Y_
+         * In case of using a field grid, the field is stored as a large flat array with the precision selected for the grid,
+         * values are converted to double precision when read. If the sizes are denoted as X_SIZE, Y_
          * SIZE and Z_SIZE, respectively, and each position (x, y, z) has N indices, the element position of the i-th field
          * component in the flat field vector can be calculated as:
          *
          *   field_i(x, y, z) =  x * Y_SIZE* Z_SIZE * N + y * Z_SIZE * + z * N + i
          */
-        std::shared_ptr<std::vector<double>> field_;
+        FieldGrid field_;
         std::pair<double, double> thickness_domain_{};
+
+        // Copies of the field grid on every NUMA node, empty if the field is not replicated
+        std::vector<FieldGrid> replicas_;
         FieldType type_{FieldType::NONE};
         FieldFunction<T> function_;
 
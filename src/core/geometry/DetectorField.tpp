@@ -171,8 +171,7 @@ namespace allpix {
             return {};
         }
 
-        auto z_ind = static_cast<int>(std::floor(static_cast<double>(bins_[2]) * (dist.z() - thickness_domain_.first) /
-                                                 (thickness_domain_.second - thickness_domain_.first)));
+        auto z_ind = get_z_index(dist.z());
 
         // Check if we need to extrapolate along the z axis:
         if(extrapolate_z) {
@@ -185,29 +184,51 @@ namespace allpix {
         size_t tot_ind = static_cast<size_t>(x_ind) * bins_[1] * bins_[2] * N + static_cast<size_t>(y_ind) * bins_[2] * N +
                          static_cast<size_t>(z_ind) * N;
 
-        // Retrieve field
-        auto field_vector = get_impl(tot_ind, std::make_index_sequence<N>{});
+        // Retrieve field, preferring the copy on the NUMA node of the calling thread
+        const auto& field = (replicas_.empty() ? field_ : replicas_[NumaTopology::currentNode() % replicas_.size()]);
+        auto field_vector = field.visit([tot_ind, this](const auto& values, const auto& decode) {
+            return get_impl(values, decode, tot_ind, std::make_index_sequence<N>{});
+        });
         // Flip sign of vector components if necessary
         flip_vector_components(field_vector, flip_x, flip_y);
         return field_vector;
     }
 
+    template <typename T, size_t N> int DetectorField<T, N>::get_z_index(double z) const {
+        return static_cast<int>(std::floor(static_cast<double>(bins_[2]) * (z - thickness_domain_.first) /
+                                           (thickness_domain_.second - thickness_domain_.first)));
+    }
+
     /**
      * Woohoo, template magic! Using an index_sequence to construct the templated return type with a variable number of
      * elements from the flat field vector, e.g. 3 for a vector field and 1 for a scalar field. Using a braced-init-list
-     * allows to call the appropriate constructor of the return type, e.g. ROOT::Math::XYZVector or simply a double.
+     * allows to call the appropriate constructor of the return type, e.g. ROOT::Math::XYZVector or simply a double. Values
+     * stored with reduced precision are converted to double precision by the decoder of the grid.
      */
     template <typename T, size_t N>
-    template <std::size_t... I>
-    auto DetectorField<T, N>::get_impl(size_t offset, std::index_sequence<I...>) const {
-        return T{(*field_)[offset + I]...};
+    template <typename V, typename D, std::size_t... I>
+    auto DetectorField<T, N>::get_impl(const std::vector<V>& field,
+                                       const D& decode,
+                                       size_t offset,
+                                       std::index_sequence<I...>) const {
+        return T{decode(field[offset + I])...};
+    }
+
+    /**
+     * Replication is only performed for field grids on systems with more than one NUMA node.
+     */
+    template <typename T, size_t N> void DetectorField<T, N>::replicate() {
+        replicas_.clear();
+        if(type_ == FieldType::GRID && !field_.empty() && NumaTopology::nodeCount() > 1) {
+            replicas_ = field_.replicate();
+        }
     }
 
     /**
      * @throws std::invalid_argument If the field bins are incorrect or the thickness domain is outside the sensor
      */
     template <typename T, size_t N>
-    void DetectorField<T, N>::setGrid(std::shared_ptr<std::vector<double>> field, // NOLINT
+    void DetectorField<T, N>::setGrid(FieldGrid field, // NOLINT
                                       std::array<size_t, 3> bins,
                                       std::array<double, 3> size,
                                       FieldMapping mapping,
@@ -217,7 +238,7 @@ namespace allpix {
         if(model_ == nullptr) {
             throw std::invalid_argument("field not initialized with detector model parameters");
         }
-        if(bins[0] * bins[1] * bins[2] * N != field->size()) {
+        if(bins[0] * bins[1] * bins[2] * N != field.size()) {
             throw std::invalid_argument("field does not match the given dimensions");
         }
         if(thickness_domain.first + 1e-9 < model_->getSensorCenter().z() - model_->getSensorSize().z() / 2.0 ||
@@ -229,6 +250,7 @@ namespace allpix {
         }
 
         field_ = std::move(field);
+        replicas_.clear();
         bins_ = bins;
         mapping_ = mapping;
 
@@ -0,0 +1,185 @@
+/**
+ * @file
+ * @brief Implementation of field grids stored with configurable precision
+ *
+ * @copyright Copyright (c) 2023 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "FieldGrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "core/utils/numa.h"
+
+using namespace allpix;
+
+FieldGrid::FieldGrid(std::shared_ptr<std::vector<double>> values) : double_values_(std::move(values)) {
+    if(double_values_ != nullptr) {
+        for(const auto& value : *double_values_) {
+            max_value_ = std::max(max_value_, std::fabs(value));
+        }
+    }
+}
+
+/**
+ * The values are converted once and the largest absolute deviation between the converted and the original values is kept
+ * as estimate of the quantization error of the grid.
+ */
+FieldGrid::FieldGrid(const std::vector<double>& values, FieldPrecision precision) : precision_(precision) {
+    for(const auto& value : values) {
+        max_value_ = std::max(max_value_, std::fabs(value));
+    }
+
+    auto convert = [&](auto& target, auto encode, auto decode) {
+        target.reserve(values.size());
+        for(const auto& value : values) {
+            target.push_back(encode(value));
+            max_error_ = std::max(max_error_, std::fabs(decode(target.back()) - value));
+        }
+    };
+
+    switch(precision_) {
+    case FieldPrecision::FLOAT: {
+        auto converted = std::make_shared<std::vector<float>>();
+        convert(
+            *converted,
+            [](double value) { return static_cast<float>(value); },
+            [](float value) { return static_cast<double>(value); });
+        float_values_ = std::move(converted);
+        break;
+    }
+    case FieldPrecision::HALF:
+    case FieldPrecision::LOG_HALF: {
+        auto converted = std::make_shared<std::vector<uint16_t>>();
+        if(precision_ == FieldPrecision::HALF) {
+            // Scale by a power of two such that the largest value is in the range [2^14, 2^15), which is exact
+            if(max_value_ > 0 && std::isfinite(max_value_)) {
+                scale_ = std::ldexp(1., std::ilogb(max_value_) - 14);
+            }
+            convert(
+                *converted,
+                [this](double value) { return encode_half(value / scale_); },
+                [this](uint16_t value) { return decode_half(value) * scale_; });
+        } else {
+            convert(*converted, encode_log_half, decode_log_half);
+        }
+        half_values_ = std::move(converted);
+        break;
+    }
+    default: {
+        auto identity = [](double value) { return value; };
+        auto converted = std::make_shared<std::vector<double>>();
+        convert(*converted, identity, identity);
+        double_values_ = std::move(converted);
+        break;
+    }
+    }
+}
+
+size_t FieldGrid::size() const {
+    if(float_values_ != nullptr) {
+        return float_values_->size();
+    } else if(half_values_ != nullptr) {
+        return half_values_->size();
+    }
+    return double_values_ != nullptr ? double_values_->size() : 0;
+}
+
+size_t FieldGrid::getMemorySize() const {
+    if(float_values_ != nullptr) {
+        return float_values_->size() * sizeof(float);
+    } else if(half_values_ != nullptr) {
+        return half_values_->size() * sizeof(uint16_t);
+    }
+    return double_values_ != nullptr ? double_values_->size() * sizeof(double) : 0;
+}
+
+/**
+ * @throws std::logic_error If the values are stored with reduced precision
+ */
+const std::vector<double>& FieldGrid::getValues() const {
+    if(precision_ != FieldPrecision::DOUBLE || double_values_ == nullptr) {
+        throw std::logic_error("field grid values are not stored in double precision");
+    }
+    return *double_values_;
+}
+
+std::vector<FieldGrid> FieldGrid::replicate() const {
+    std::vector<FieldGrid> replicas;
+    auto add_replicas = [&](const auto& values, auto member) {
+        for(auto& copy : NumaTopology::replicate(values)) {
+            auto& replica = replicas.emplace_back(*this);
+            replica.*member = std::move(copy);
+        }
+    };
+
+    if(precision_ == FieldPrecision::FLOAT) {
+        add_replicas(float_values_, &FieldGrid::float_values_);
+    } else if(precision_ == FieldPrecision::HALF || precision_ == FieldPrecision::LOG_HALF) {
+        add_replicas(half_values_, &FieldGrid::half_values_);
+    } else if(double_values_ != nullptr) {
+        add_replicas(double_values_, &FieldGrid::double_values_);
+    }
+    return replicas;
+}
+
+/**
+ * Values are rounded to the nearest representable half precision value with ties to even. Values beyond the largest finite
+ * half precision value of 65504 are converted to infinity, values below the smallest normal value to subnormal values.
+ */
+uint16_t FieldGrid::encode_half(double value) {
+    auto sign = static_cast<uint16_t>(std::signbit(value) ? 0x8000 : 0x0000);
+    auto magnitude = std::fabs(value);
+
+    if(std::isnan(value)) {
+        return static_cast<uint16_t>(sign | 0x7e00);
+    }
+    if(magnitude >= 65520.) {
+        return static_cast<uint16_t>(sign | 0x7c00);
+    }
+
+    // Subnormal values are multiples of 2^-24
+    if(magnitude < std::ldexp(1., -14)) {
+        return static_cast<uint16_t>(sign | static_cast<uint16_t>(std::nearbyint(std::ldexp(magnitude, 24))));
+    }
+
+    // Normal values with ten bits of mantissa, a mantissa rounded up to 1024 carries over into the exponent
+    int exponent = 0;
+    auto fraction = std::frexp(magnitude, &exponent);
+    auto mantissa = static_cast<unsigned int>(std::nearbyint((2. * fraction - 1.) * 1024.));
+    return static_cast<uint16_t>(sign | ((static_cast<unsigned int>(exponent + 14) << 10U) + mantissa));
+}
+
+double FieldGrid::decode_half(uint16_t value) {
+    auto exponent = static_cast<int>((value >> 10U) & 0x1fU);
+    auto mantissa = static_cast<unsigned int>(value & 0x3ffU);
+
+    double magnitude = 0;
+    if(exponent == 0) {
+        magnitude = std::ldexp(mantissa, -24);
+    } else if(exponent == 0x1f) {
+        magnitude = (mantissa == 0 ? INFINITY : NAN);
+    } else {
+        magnitude = std::ldexp(mantissa | 0x400U, exponent - 25);
+    }
+    return (value & 0x8000U) != 0 ? -magnitude : magnitude;
+}
+
+/**
+ * The logarithm keeps the relative precision constant over many orders of magnitude, while log1p ensures a smooth transition
+ * through zero and retains the sign of the value.
+ */
+uint16_t FieldGrid::encode_log_half(double value) {
+    return encode_half(std::copysign(std::log1p(std::fabs(value)), value));
+}
+
+double FieldGrid::decode_log_half(uint16_t value) {
+    auto encoded = decode_half(value);
+    return std::copysign(std::expm1(std::fabs(encoded)), encoded);
+}
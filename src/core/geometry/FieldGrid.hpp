@@ -0,0 +1,167 @@
+/**
+ * @file
+ * @brief Definition of field grids stored with configurable precision
+ *
+ * @copyright Copyright (c) 2023 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_FIELD_GRID_H
+#define ALLPIX_FIELD_GRID_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace allpix {
+
+    /**
+     * @brief Precision the values of field grids are stored with
+     */
+    enum class FieldPrecision {
+        DOUBLE = 0, ///< Double precision, values are stored as read from file
+        FLOAT,      ///< Single precision
+        HALF,       ///< Half precision
+        LOG_HALF,   ///< Half precision of the logarithm of the magnitude, suited for values spanning orders of magnitude
+    };
+
+    /**
+     * @brief Flat array of field grid values stored with a configurable precision
+     *
+     * Values are converted to the requested precision once and decoded to double precision on every read. Reduced precision
+     * lowers the memory footprint of field grids and the memory bandwidth required for field lookups at the cost of a
+     * quantization error, which is determined during the conversion. Half precision values are scaled by a power of two to
+     * make use of the full range of the format independent of the units of the field.
+     */
+    class FieldGrid {
+    public:
+        /**
+         * @brief Construct an empty field grid
+         */
+        FieldGrid() = default;
+
+        /**
+         * @brief Construct a field grid sharing values stored in double precision
+         * @param values Shared pointer to the flat field data
+         */
+        FieldGrid(std::shared_ptr<std::vector<double>> values); // NOLINT
+
+        /**
+         * @brief Construct a field grid by converting the values to the requested precision
+         * @param values Flat field data to convert
+         * @param precision Precision to store the values with
+         */
+        FieldGrid(const std::vector<double>& values, FieldPrecision precision);
+
+        /**
+         * @brief Get the precision the values are stored with
+         * @return Precision of the values
+         */
+        FieldPrecision getPrecision() const { return precision_; }
+
+        /**
+         * @brief Get the number of values in the grid
+         * @return Number of values
+         */
+        size_t size() const;
+
+        /**
+         * @brief Check if the grid holds any values
+         * @return True if no values are stored, false otherwise
+         */
+        bool empty() const { return size() == 0; }
+
+        /**
+         * @brief Get the memory used to store the values
+         * @return Size of the values in bytes
+         */
+        size_t getMemorySize() const;
+
+        /**
+         * @brief Get the maximum absolute deviation of the stored values from the values they have been converted from
+         * @return Maximum quantization error, zero for values stored in double precision
+         */
+        double getMaximumError() const { return max_error_; }
+
+        /**
+         * @brief Get the maximum absolute value of the grid
+         * @return Largest magnitude of all values
+         */
+        double getMaximumValue() const { return max_value_; }
+
+        /**
+         * @brief Get the values of a grid stored in double precision
+         * @return Reference to the values
+         * @throws std::logic_error If the values are stored with reduced precision
+         */
+        const std::vector<double>& getValues() const;
+
+        /**
+         * @brief Call a function with the stored values and a callable decoding a single value to double precision
+         * @param func Function taking the vector of stored values and the decoding callable
+         * @return Return value of the function
+         */
+        template <typename F> decltype(auto) visit(F&& func) const {
+            switch(precision_) {
+            case FieldPrecision::FLOAT:
+                return func(*float_values_, [](float value) { return static_cast<double>(value); });
+            case FieldPrecision::HALF:
+                return func(*half_values_, [scale = scale_](uint16_t value) { return decode_half(value) * scale; });
+            case FieldPrecision::LOG_HALF:
+                return func(*half_values_, [](uint16_t value) { return decode_log_half(value); });
+            default:
+                return func(*double_values_, [](double value) { return value; });
+            }
+        }
+
+        /**
+         * @brief Create a copy of the stored values on every NUMA node
+         * @return List of grids with the values stored on the respective node
+         */
+        std::vector<FieldGrid> replicate() const;
+
+        /**
+         * @brief Convert a value to half precision
+         * @param value Value to convert, rounded to the nearest representable value
+         * @return Bit pattern of the IEEE 754 half precision value
+         */
+        static uint16_t encode_half(double value);
+        /**
+         * @brief Convert a value from half precision
+         * @param value Bit pattern of the IEEE 754 half precision value
+         * @return Converted value
+         */
+        static double decode_half(uint16_t value);
+
+        /**
+         * @brief Convert a value to the half precision logarithm of its magnitude, keeping its sign
+         * @param value Value to convert
+         * @return Bit pattern of the encoded value
+         */
+        static uint16_t encode_log_half(double value);
+        /**
+         * @brief Convert a value from the half precision logarithm of its magnitude
+         * @param value Bit pattern of the encoded value
+         * @return Converted value
+         */
+        static double decode_log_half(uint16_t value);
+
+    private:
+        FieldPrecision precision_{FieldPrecision::DOUBLE};
+
+        std::shared_ptr<const std::vector<double>> double_values_;
+        std::shared_ptr<const std::vector<float>> float_values_;
+        std::shared_ptr<const std::vector<uint16_t>> half_values_;
+
+        // Factor half precision values are multiplied with to cover the range of the original values
+        double scale_{1.};
+
+        double max_error_{};
+        double max_value_{};
+    };
+} // namespace allpix
+
+#endif /* ALLPIX_FIELD_GRID_H */
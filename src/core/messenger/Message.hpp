@@ -12,6 +12,7 @@
 #ifndef ALLPIX_MESSAGE_H
 #define ALLPIX_MESSAGE_H
 
+#include <limits>
 #include <vector>
 
 #include "core/geometry/Detector.hpp"
@@ -54,6 +55,12 @@ namespace allpix {
          */
         virtual std::vector<std::reference_wrapper<Object>> getObjectArray();
 
+        /**
+         * @brief Get an estimate of the memory occupied by the data stored in this message
+         * @return Approximate size of the payload in bytes
+         */
+        virtual size_t getMemoryUsage() const { return 0; }
+
     protected:
         /**
          * @brief Construct a general message not linked to a detector
@@ -66,7 +73,12 @@ namespace allpix {
         explicit BaseMessage(std::shared_ptr<const Detector> detector);
 
     private:
+        friend class LocalMessenger;
+
         std::shared_ptr<const Detector> detector_;
+
+        // Index of the module which dispatched this message, used by the messenger to track its receivers
+        size_t dispatcher_index_{std::numeric_limits<size_t>::max()};
     };
 
     /**
@@ -104,6 +116,12 @@ namespace allpix {
          */
         std::vector<std::reference_wrapper<Object>> getObjectArray() override;
 
+        /**
+         * @brief Get an estimate of the memory occupied by the data vector of this message
+         * @return Capacity of the data vector in bytes, not including memory owned by the individual entries
+         */
+        size_t getMemoryUsage() const override { return data_.capacity() * sizeof(T); }
+
     private:
         /**
          * @brief Returns object array for messages containing objects
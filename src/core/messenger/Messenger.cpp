@@ -11,6 +11,7 @@
 
 #include "Messenger.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -18,6 +19,8 @@
 
 #include "Message.hpp"
 #include "core/module/Module.hpp"
+#include "core/module/Tracer.hpp"
+#include "core/module/exceptions.h"
 #include "core/utils/log.h"
 #include "core/utils/type.h"
 #include "delegates.h"
@@ -105,6 +108,15 @@ void Messenger::add_delegate(const std::type_info& message_type,
         message_name = module->get_configuration().get<std::string>("input");
     }
 
+    // Assign the message slot of the module for this message type, shared by all its delegates of the same type
+    auto slot_iter = std::find_if(module->message_slots_.begin(),
+                                  module->message_slots_.end(),
+                                  [&](const auto& slot) { return slot.first == std::type_index(message_type); });
+    if(slot_iter == module->message_slots_.end()) {
+        slot_iter = module->message_slots_.emplace(slot_iter, std::type_index(message_type), slot_count_++);
+    }
+    delegate->slot_ = slot_iter->second;
+
     // Register delegate internally
     delegates_[std::type_index(message_type)][message_name].push_back(delegate);
     auto delegate_iter = --delegates_[std::type_index(message_type)][message_name].end();
@@ -127,6 +139,80 @@ void Messenger::remove_delegate(BaseDelegate* delegate) {
     }
     delegates_[std::get<0>(iter->second)][std::get<1>(iter->second)].erase(std::get<2>(iter->second));
     delegate_to_iterator_.erase(iter);
+
+    // Remove the delegate from the compiled routes, keeping the module and message slot indices valid
+    auto references = [&](const Receiver& receiver) { return receiver.delegate == delegate; };
+    for(auto& route : routes_) {
+        for(auto& typed : route.typed) {
+            typed.second.erase(std::remove_if(typed.second.begin(), typed.second.end(), references), typed.second.end());
+        }
+        route.generic.erase(std::remove_if(route.generic.begin(), route.generic.end(), references), route.generic.end());
+    }
+}
+
+void Messenger::compileRoutes(const std::list<std::shared_ptr<Module>>& modules) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    routes_.clear();
+    routes_.reserve(modules.size());
+    for(const auto& module : modules) {
+        module->messenger_index_ = routes_.size();
+        auto& route = routes_.emplace_back();
+        route.output = module->get_configuration().get<std::string>("output");
+
+        // Listeners are collected in the same order as when dispatching by name
+        std::vector<std::string> ids{route.output, "*"};
+        if(route.output.empty()) {
+            ids.emplace_back("?");
+        }
+
+        const auto unique_name = module->getUniqueName();
+        auto collect = [&](const DelegateMap::mapped_type* listeners,
+                           const std::string& id,
+                           std::vector<Receiver>& receivers) {
+            if(listeners == nullptr) {
+                return;
+            }
+            auto name_iter = listeners->find(id);
+            if(name_iter == listeners->end()) {
+                return;
+            }
+            for(const auto& delegate : name_iter->second) {
+                // Modules never receive their own messages
+                if(delegate->getUniqueName() != unique_name) {
+                    receivers.push_back({delegate.get(), delegate->getDetector()});
+                }
+            }
+        };
+
+        auto base_iter = delegates_.find(typeid(BaseMessage));
+        const auto* base_listeners = (base_iter != delegates_.end() ? &base_iter->second : nullptr);
+        for(const auto& id : ids) {
+            collect(base_listeners, id, route.generic);
+        }
+
+        // For every name, listeners of the message type come before the base message listeners
+        for(const auto& [type, listeners] : delegates_) {
+            if(type == typeid(BaseMessage)) {
+                continue;
+            }
+
+            std::vector<Receiver> receivers;
+            bool has_typed = false;
+            for(const auto& id : ids) {
+                auto count = receivers.size();
+                collect(&listeners, id, receivers);
+                has_typed = has_typed || receivers.size() != count;
+                collect(base_listeners, id, receivers);
+            }
+            if(has_typed) {
+                route.typed.emplace_back(type, std::move(receivers));
+            }
+        }
+    }
+    module_count_ = routes_.size();
+
+    LOG(DEBUG) << "Compiled message routes of " << module_count_ << " modules using " << slot_count_ << " message slots";
 }
 
 std::vector<std::pair<std::shared_ptr<BaseMessage>, std::string>> Messenger::fetchFilteredMessages(Module* module,
@@ -140,43 +226,146 @@ std::vector<std::pair<std::shared_ptr<BaseMessage>, std::string>> Messenger::fet
     }
 }
 
-LocalMessenger::LocalMessenger(Messenger& global_messenger) : global_messenger_(global_messenger) {}
+LocalMessenger::LocalMessenger(Messenger& global_messenger, std::pmr::memory_resource* resource)
+    : global_messenger_(global_messenger), messages_(global_messenger.slot_count_, resource),
+      delivered_(global_messenger.slot_count_, 0, resource), module_groups_(global_messenger.module_count_, resource),
+      pending_receivers_(global_messenger.module_count_, 0, resource) {}
 
 void LocalMessenger::dispatchMessage(Module* source, std::shared_ptr<BaseMessage> message, std::string name) { // NOLINT
-    // Get the name of the output message
-    if(name == "-") {
-        name = source->get_configuration().get<std::string>("output");
+    // Only modules known when compiling the routes have a message group in this event
+    if(source->messenger_index_ >= module_groups_.size()) {
+        throw InvalidModuleActionException("Module " + source->getUniqueName() +
+                                           " dispatched a message but is not registered with the messenger");
     }
+    Tracer::Scope span(Tracer::Category::DISPATCH, source);
 
-    bool send = false;
+    size_t receivers = 0;
+    if(name == "-" && source->messenger_index_ < global_messenger_.routes_.size()) {
+        // Send messages along the compiled route to the module output
+        receivers = dispatch_routed(source, message);
+    } else {
+        // Get the name of the output message
+        if(name == "-") {
+            name = source->get_configuration().get<std::string>("output");
+        }
 
-    // Send messages to specific listeners
-    send = dispatchMessage(source, message, name, name) || send;
+        // Send messages to specific listeners
+        receivers += dispatchMessage(source, message, name, name);
 
-    // Send to generic listeners
-    send = dispatchMessage(source, message, name, "*") || send;
+        // Send to generic listeners
+        receivers += dispatchMessage(source, message, name, "*");
 
-    // Send to listeners of unnamed messages
-    if(name.empty()) {
-        send = dispatchMessage(source, message, name, "?") || send;
+        // Send to listeners of unnamed messages
+        if(name.empty()) {
+            receivers += dispatchMessage(source, message, name, "?");
+        }
     }
 
     // Display a TRACE log message if the message is send to no receiver
-    if(!send) {
+    if(receivers == 0) {
         const BaseMessage* inst = message.get();
         LOG(TRACE) << "Dispatched message " << allpix::demangle(typeid(*inst).name()) << " from " << source->getUniqueName()
                    << " has no receivers!";
     }
 
-    // Save a copy of the sent message
-    sent_messages_.emplace_back(message);
+    // Add the message to the group of the dispatching module, which depends on all messages received by this module
+    auto& group = module_groups_[source->messenger_index_];
+    if(group == nullptr) {
+        group = std::make_shared<MessageGroup>(memory_, alive_messages_);
+        // The running module itself keeps its group alive until its messages are released
+        pending_receivers_[source->messenger_index_] = 1;
+        auto add_parent = [&](const std::shared_ptr<BaseMessage>& msg) {
+            auto index = msg->dispatcher_index_;
+            if(index < module_groups_.size() && module_groups_[index] != nullptr &&
+               std::find(group->parents.begin(), group->parents.end(), module_groups_[index]) == group->parents.end()) {
+                group->parents.push_back(module_groups_[index]);
+            }
+        };
+        for(const auto& slot : source->message_slots_) {
+            const auto& received = messages_[slot.second];
+            if(received.single != nullptr) {
+                add_parent(received.single);
+            }
+            for(const auto& msg : received.multi) {
+                add_parent(msg);
+            }
+            for(const auto& msg : received.filter_multi) {
+                add_parent(msg.first);
+            }
+        }
+    }
+
+    auto memory = message->getMemoryUsage();
+    group->memory += memory;
+    memory_ += memory;
+    peak_memory_ = std::max(peak_memory_, memory_);
+    group->messages.emplace_back(message);
+    alive_messages_++;
+
+    message->dispatcher_index_ = source->messenger_index_;
+    pending_receivers_[source->messenger_index_] += receivers;
+}
+
+size_t LocalMessenger::dispatch_routed(Module* source, const std::shared_ptr<BaseMessage>& message) {
+    const auto& route = global_messenger_.routes_[source->messenger_index_];
+
+    const BaseMessage* inst = message.get();
+    std::type_index type_idx = typeid(*inst);
+    auto detector = message->getDetector();
+
+    size_t receivers = 0;
+    auto send = [&](const Messenger::Receiver& receiver) {
+        // Only send to listeners of the detector of the message, if they are bound to one
+        if(receiver.detector != nullptr &&
+           (detector == nullptr ||
+            (receiver.detector.get() != detector.get() && receiver.detector->getName() != detector->getName()))) {
+            return;
+        }
+        LOG(TRACE) << "Sending message " << allpix::demangle(type_idx.name()) << " from " << source->getUniqueName()
+                   << " to " << receiver.delegate->getUniqueName();
+        if(deliver(receiver.delegate, message, route.output)) {
+            receivers++;
+        }
+    };
+
+    // Send messages to the listeners of this type and the base message listeners, or only to the latter if there are none
+    auto typed_iter = std::find_if(
+        route.typed.begin(), route.typed.end(), [&](const auto& typed) { return typed.first == type_idx; });
+    const auto& route_receivers = (typed_iter != route.typed.end() ? typed_iter->second : route.generic);
+    std::for_each(route_receivers.begin(), route_receivers.end(), send);
+
+    return receivers;
+}
+
+bool LocalMessenger::deliver(BaseDelegate* delegate, const std::shared_ptr<BaseMessage>& message, const std::string& name) {
+    auto slot = delegate->getSlot();
+    auto& dest = messages_[slot];
+
+    // A single bound message overwritten by a newer one is not held by the receiver anymore
+    const BaseMessage* previous = dest.single.get();
+    auto stored = delegate->process(message, name, dest);
+    delivered_[slot] = 1;
+    if(previous != nullptr && previous != dest.single.get()) {
+        release_message(previous);
+    }
+    return stored;
 }
 
-bool LocalMessenger::dispatchMessage(Module* source,
-                                     const std::shared_ptr<BaseMessage>& message,
-                                     const std::string& name,
-                                     const std::string& id) {
-    bool send = false;
+void LocalMessenger::release_message(const BaseMessage* message) {
+    release_group(message->dispatcher_index_);
+}
+
+void LocalMessenger::release_group(size_t index) {
+    if(index < pending_receivers_.size() && pending_receivers_[index] > 0 && --pending_receivers_[index] == 0) {
+        module_groups_[index].reset();
+    }
+}
+
+size_t LocalMessenger::dispatchMessage(Module* source,
+                                       const std::shared_ptr<BaseMessage>& message,
+                                       const std::string& name,
+                                       const std::string& id) {
+    size_t receivers = 0;
 
     // Create type identifier from the typeid
     const BaseMessage* inst = message.get();
@@ -192,11 +381,9 @@ bool LocalMessenger::dispatchMessage(Module* source,
                 if(check_send(source, message.get(), delegate.get())) {
                     LOG(TRACE) << "Sending message " << allpix::demangle(type_idx.name()) << " from "
                                << source->getUniqueName() << " to " << delegate->getUniqueName();
-                    // Construct BaseMessage where message should be stored
-                    auto& dest = messages_[delegate->getUniqueName()][type_idx];
-
-                    delegate->process(message, name, dest);
-                    send = true;
+                    if(deliver(delegate.get(), message, name)) {
+                        receivers++;
+                    }
                 }
             }
         }
@@ -212,41 +399,53 @@ bool LocalMessenger::dispatchMessage(Module* source,
                 if(check_send(source, message.get(), delegate.get())) {
                     LOG(TRACE) << "Sending message " << allpix::demangle(type_idx.name()) << " from "
                                << source->getUniqueName() << " to generic listener " << delegate->getUniqueName();
-                    auto& dest = messages_[delegate->getUniqueName()][typeid(BaseMessage)];
-                    delegate->process(message, name, dest);
-                    send = true;
+                    if(deliver(delegate.get(), message, name)) {
+                        receivers++;
+                    }
                 }
             }
         }
     }
 
-    return send;
+    return receivers;
+}
+
+const DelegateTypes& LocalMessenger::get_messages(Module* module, const std::type_index& type) const {
+    auto slot = module->get_message_slot(type);
+    if(delivered_[slot] == 0) {
+        throw std::out_of_range("no message delivered to slot");
+    }
+    return messages_[slot];
 }
 
 std::vector<std::pair<std::shared_ptr<BaseMessage>, std::string>> LocalMessenger::fetchFilteredMessages(Module* module) {
-    const std::type_index type_idx = typeid(BaseMessage);
-    return messages_.at(module->getUniqueName()).at(type_idx).filter_multi;
+    return get_messages(module, typeid(BaseMessage)).filter_multi;
 }
 
-bool LocalMessenger::isSatisfied(BaseDelegate* delegate) const {
-    // check our records for messages for this module
-    const std::string name = delegate->getUniqueName();
-    auto messages_iter = messages_.find(name);
-    if(messages_iter == messages_.end()) {
-        return false;
-    }
+void LocalMessenger::releaseMessages(Module* module) {
+    // The module will not dispatch further messages, its group is only kept alive by pending messages and derived groups
+    release_group(module->messenger_index_);
 
-    // check if this delegate is in our records
-    auto delegate_iter = global_messenger_.delegate_to_iterator_.find(delegate);
-    if(delegate_iter == global_messenger_.delegate_to_iterator_.end()) {
-        throw std::out_of_range("delegate not found in listeners");
+    for(const auto& slot : module->message_slots_) {
+        auto& received = messages_[slot.second];
+        if(received.single != nullptr) {
+            release_message(received.single.get());
+        }
+        for(const auto& msg : received.multi) {
+            release_message(msg.get());
+        }
+        for(const auto& msg : received.filter_multi) {
+            release_message(msg.first.get());
+        }
+        received = DelegateTypes();
+        delivered_[slot.second] = 0;
     }
 
-    // check our records for messages for this delegate
-    auto iter = messages_iter->second.find(std::get<0>(delegate_iter->second));
-    if(iter == messages_iter->second.end()) {
-        return false;
-    }
+    LOG(TRACE) << "Released messages received by " << module->getUniqueName() << ", " << alive_messages_
+               << " message(s) of this event remain";
+}
 
-    return true;
+bool LocalMessenger::isSatisfied(BaseDelegate* delegate) const {
+    // check our records for messages for the slot of this delegate
+    return delivered_[delegate->getSlot()] != 0;
 }
@@ -14,6 +14,7 @@
 
 #include <list>
 #include <memory>
+#include <memory_resource>
 #include <typeindex>
 #include <unordered_map>
 #include <utility>
@@ -112,6 +113,7 @@ namespace allpix {
          * @param event Pointer to the event to dispatch the message to
          * @param name Optional message name (defaults to - indicating that it should dispatch to the module output
          * parameter)
+         * @throws InvalidModuleActionException If the module was not registered when the message routes were compiled
          */
         template <typename T>
         void dispatchMessage(Module* module, std::shared_ptr<T> message, Event* event, const std::string& name = "-");
@@ -157,6 +159,16 @@ namespace allpix {
          */
         bool isSatisfied(BaseDelegate* delegate, Event* event) const;
 
+        /**
+         * @brief Compile the message routes of all modules
+         * @param modules List of all instantiated modules
+         *
+         * Resolves the output name and all matching listeners of every module once, such that dispatching and fetching
+         * messages in the event loop only requires indexing into arrays. Should be called after all delegates have been
+         * registered and before the first event is created.
+         */
+        void compileRoutes(const std::list<std::shared_ptr<Module>>& modules);
+
     private:
         /**
          * @brief Add a delegate to the listeners
@@ -181,6 +193,31 @@ namespace allpix {
         DelegateMap delegates_;
         DelegateIteratorMap delegate_to_iterator_;
 
+        /**
+         * @brief Listener of messages dispatched by a module, with its detector resolved at compile time
+         */
+        struct Receiver {
+            BaseDelegate* delegate;
+            std::shared_ptr<Detector> detector;
+        };
+        /**
+         * @brief Compiled routes of all messages dispatched by a module to its output
+         *
+         * The receivers of every message type include the base message listeners, in the same order as when dispatching by
+         * name: for each of the output name, the generic and the unnamed listeners, first the listeners of the type and
+         * then the base message listeners. Message types without own listeners are only sent to the generic receivers.
+         */
+        struct Route {
+            std::string output;
+            std::vector<std::pair<std::type_index, std::vector<Receiver>>> typed;
+            std::vector<Receiver> generic;
+        };
+
+        // Routes indexed by the module index, and total number of modules and message slots
+        std::vector<Route> routes_;
+        size_t module_count_{};
+        size_t slot_count_{};
+
         mutable std::mutex mutex_;
     };
 
@@ -192,13 +229,19 @@ namespace allpix {
      */
     class LocalMessenger {
     public:
-        explicit LocalMessenger(Messenger& global_messenger);
+        /**
+         * @brief Construct the local messenger
+         * @param global_messenger Messenger holding the delegates and compiled routes
+         * @param resource Memory resource to allocate the message tables of this event from
+         */
+        explicit LocalMessenger(Messenger& global_messenger,
+                                std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
         void dispatchMessage(Module* source, std::shared_ptr<BaseMessage> message, std::string name);
-        bool dispatchMessage(Module* source,
-                             const std::shared_ptr<BaseMessage>& message,
-                             const std::string& name,
-                             const std::string& id);
+        size_t dispatchMessage(Module* source,
+                               const std::shared_ptr<BaseMessage>& message,
+                               const std::string& name,
+                               const std::string& id);
 
         /**
          * @brief Check if a delegate has received its message
@@ -224,12 +267,101 @@ namespace allpix {
          */
         std::vector<std::pair<std::shared_ptr<BaseMessage>, std::string>> fetchFilteredMessages(Module* module);
 
+        /**
+         * @brief Release all messages received by a module after it has finished processing this event
+         * @param module Module which has been executed
+         *
+         * Messages are freed as soon as all of their receivers have been executed and no message derived from them is
+         * alive anymore. Objects in dispatched messages may reference objects of any message the dispatching module has
+         * received, therefore all messages of a module are kept alive together with the messages it received.
+         */
+        void releaseMessages(Module* module);
+
+        /**
+         * @brief Get the peak memory held by messages of this event
+         * @return Highest approximate payload size of all simultaneously alive messages in bytes
+         */
+        size_t getPeakMemoryUsage() const { return peak_memory_; }
+
     private:
+        /**
+         * @brief Dispatch a message along the compiled route of the source module
+         * @param source Module dispatching the message
+         * @param message Message to dispatch
+         * @return Number of receivers of the message
+         */
+        size_t dispatch_routed(Module* source, const std::shared_ptr<BaseMessage>& message);
+
+        /**
+         * @brief Store a message in the slot of the delegate
+         * @param delegate Delegate receiving the message
+         * @param message Message to store
+         * @param name Name of the message
+         * @return True if the delegate kept the message, false if it has been filtered out
+         */
+        bool deliver(BaseDelegate* delegate, const std::shared_ptr<BaseMessage>& message, const std::string& name);
+
+        /**
+         * @brief Remove one pending receiver of a message
+         * @param message Message not held by one of its receivers anymore
+         */
+        void release_message(const BaseMessage* message);
+
+        /**
+         * @brief Remove one pending receiver from the message group of a module, and free the group if none is left
+         * @param index Index of the module dispatching the messages of the group
+         */
+        void release_group(size_t index);
+
+        /**
+         * @brief Get the messages received by a module for a message type
+         * @param module Module to get the messages for
+         * @param type Type of the messages
+         * @return Container with the received messages
+         * @throws std::out_of_range If no message of this type has been delivered to the module
+         */
+        const DelegateTypes& get_messages(Module* module, const std::type_index& type) const;
+
+        /**
+         * @brief Group of all messages dispatched by a single module in this event
+         *
+         * The group holds the messages it was derived from, i.e. the groups of all messages received by the dispatching
+         * module, to keep objects referenced by the contained objects alive.
+         */
+        struct MessageGroup {
+            MessageGroup(size_t& memory, size_t& count) : memory_counter(memory), message_counter(count) {}
+            ~MessageGroup() {
+                memory_counter -= memory;
+                message_counter -= messages.size();
+            }
+
+            MessageGroup(const MessageGroup&) = delete;
+            MessageGroup& operator=(const MessageGroup&) = delete;
+            MessageGroup(MessageGroup&&) = delete;
+            MessageGroup& operator=(MessageGroup&&) = delete;
+
+            std::vector<std::shared_ptr<BaseMessage>> messages;
+            std::vector<std::shared_ptr<MessageGroup>> parents;
+            size_t memory{};
+            size_t& memory_counter;
+            size_t& message_counter;
+        };
+
         // The global messenger which contains the shared delegate information
         const Messenger& global_messenger_;
 
-        std::unordered_map<std::string, std::unordered_map<std::type_index, DelegateTypes>> messages_;
-        std::vector<std::shared_ptr<BaseMessage>> sent_messages_;
+        // Memory bookkeeping, declared before the messages to outlive all message groups
+        size_t memory_{};
+        size_t peak_memory_{};
+        size_t alive_messages_{};
+
+        // Received messages indexed by message slot, and whether any message has been delivered to the slot
+        std::pmr::vector<DelegateTypes> messages_;
+        std::pmr::vector<char> delivered_;
+
+        // Message groups indexed by the module index, kept until the module and all receivers of its messages have run
+        std::pmr::vector<std::shared_ptr<MessageGroup>> module_groups_;
+        std::pmr::vector<size_t> pending_receivers_;
     };
 } // namespace allpix
 
@@ -29,6 +29,8 @@
 // TODO [doc] This should partly move to a source file
 
 namespace allpix {
+    class Messenger;
+
     /**
      * @ingroup Delegates
      * @brief Container of the different delegate types
@@ -85,6 +87,8 @@ namespace allpix {
      * The base class is used as type-erasure for its subclasses
      */
     class BaseDelegate {
+        friend class Messenger;
+
     public:
         /**
          * @brief Construct a delegate with the supplied flags
@@ -124,6 +128,12 @@ namespace allpix {
          */
         MsgFlags getFlags() const { return flags_; }
 
+        /**
+         * @brief Get the message slot this delegate stores its messages in
+         * @return Index of the slot, shared by all delegates of a module listening to the same message type
+         */
+        size_t getSlot() const { return slot_; }
+
         /**
          * @brief Get the detector bound to a delegate
          * @return Linked detector
@@ -141,11 +151,15 @@ namespace allpix {
          * @param msg Message to process
          * @param name Name of the message
          * @param dest Destination of the message
+         * @return True if the message has been kept by the delegate, false if it has been rejected
          */
-        virtual void process(std::shared_ptr<BaseMessage> msg, std::string name, DelegateTypes& dest) = 0;
+        virtual bool process(std::shared_ptr<BaseMessage> msg, const std::string& name, DelegateTypes& dest) = 0;
 
     protected:
         MsgFlags flags_;
+
+    private:
+        size_t slot_{};
     };
 
     /**
@@ -197,10 +211,12 @@ namespace allpix {
         /**
          * @brief Stores the received message in the delegate until the end of the event
          * @param msg Message to store
+         * @return Always true, the message is kept until the end of the event
          */
-        void process(std::shared_ptr<BaseMessage> msg, std::string, DelegateTypes&) override {
+        bool process(std::shared_ptr<BaseMessage> msg, const std::string&, DelegateTypes&) override {
             // Store the message and mark as processed
             messages_.push_back(msg);
+            return true;
         }
 
     private:
@@ -228,10 +244,11 @@ namespace allpix {
          * @brief Calls the filter function with the supplied message
          * @param msg Message to process
          * @param dest Destination of the message
+         * @return True if the message passed the filter and has been stored, false otherwise
          * @warning The filter function is called directly from the delegate, no heavy processing should be done in the
          * filter function
          */
-        void process(std::shared_ptr<BaseMessage> msg, std::string, DelegateTypes& dest) override {
+        bool process(std::shared_ptr<BaseMessage> msg, const std::string&, DelegateTypes& dest) override {
 #ifndef NDEBUG
             // The type names should have been correctly resolved earlier
             const BaseMessage* inst = msg.get();
@@ -240,7 +257,9 @@ namespace allpix {
             // Filter the message, and store it if it should be kept
             if((this->obj_->*filter_)(std::static_pointer_cast<R>(msg))) {
                 dest.filter_multi.emplace_back(std::static_pointer_cast<R>(msg), "");
+                return true;
             }
+            return false;
         }
 
     private:
@@ -269,14 +288,17 @@ namespace allpix {
          * @param msg Message to process
          * @param name Name of the message
          * @param dest Destination of the message
+         * @return True if the message passed the filter and has been stored, false otherwise
          * @warning The filter function is called directly from the delegate, no heavy processing should be done in the
          * filter function
          */
-        void process(std::shared_ptr<BaseMessage> msg, std::string name, DelegateTypes& dest) override {
+        bool process(std::shared_ptr<BaseMessage> msg, const std::string& name, DelegateTypes& dest) override {
             // Filter the message, and store it if it should be kept
             if((this->obj_->*filter_)(std::static_pointer_cast<BaseMessage>(msg), name)) {
                 dest.filter_multi.emplace_back(std::static_pointer_cast<BaseMessage>(msg), name);
+                return true;
             }
+            return false;
         }
 
     private:
@@ -300,12 +322,13 @@ namespace allpix {
          * @brief Saves the message in the passed destination
          * @param msg Message to process
          * @param dest Destination of the message
+         * @return Always true, the message is stored
          * @throws UnexpectedMessageException If this delegate has already received the message after the previous reset (not
          * thrown if the \ref MsgFlags::ALLOW_OVERWRITE "ALLOW_OVERWRITE" flag is passed)
          *
          * The saved value is overwritten if the \ref MsgFlags::ALLOW_OVERWRITE "ALLOW_OVERWRITE" flag is enabled.
          */
-        void process(std::shared_ptr<BaseMessage> msg, std::string, DelegateTypes& dest) override {
+        bool process(std::shared_ptr<BaseMessage> msg, const std::string&, DelegateTypes& dest) override {
 #ifndef NDEBUG
             // The type names should have been correctly resolved earlier
             const BaseMessage* inst = msg.get();
@@ -318,6 +341,7 @@ namespace allpix {
 
             // Save the message
             dest.single = std::static_pointer_cast<R>(msg);
+            return true;
         }
     };
 
@@ -338,8 +362,9 @@ namespace allpix {
          * @brief Adds the message to the bound vector
          * @param msg Message to process
          * @param dest Destination of the message
+         * @return Always true, the message is stored
          */
-        void process(std::shared_ptr<BaseMessage> msg, std::string, DelegateTypes& dest) override {
+        bool process(std::shared_ptr<BaseMessage> msg, const std::string&, DelegateTypes& dest) override {
 #ifndef NDEBUG
             // The type names should have been correctly resolved earlier
             const BaseMessage* inst = msg.get();
@@ -347,6 +372,7 @@ namespace allpix {
 #endif
             // Add the message to the vector
             dest.multi.push_back(std::static_pointer_cast<R>(msg));
+            return true;
         }
     };
 } // namespace allpix
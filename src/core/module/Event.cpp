@@ -15,6 +15,7 @@
 #include <chrono>
 #include <list>
 #include <memory>
+#include <memory_resource>
 #include <string>
 
 #include "Module.hpp"
@@ -25,11 +26,50 @@
 using namespace allpix;
 
 std::mutex Event::stats_mutex_;
+size_t Event::scratch_size_ = 0;
+
+namespace {
+    // Arena buffer of this worker, lent to the event of which a module is currently running on the thread
+    thread_local std::unique_ptr<std::byte[]> arena_buffer; // NOLINT
+} // namespace
 
 Event::Event(Messenger& messenger, uint64_t event_num, uint64_t seed) : number(event_num), seed_(seed) {
     local_messenger_ = std::make_unique<LocalMessenger>(messenger);
 }
 
+Event::~Event() {
+    release_scratch_memory();
+}
+
+std::pmr::memory_resource* Event::getScratchResource() {
+    if(scratch_size_ == 0) {
+        return std::pmr::new_delete_resource();
+    }
+
+    if(memory_resource_ == nullptr) {
+        if(arena_buffer == nullptr) {
+            // The buffer is deliberately left uninitialized such that only the pages actually used are touched
+            arena_buffer = std::unique_ptr<std::byte[]>(new std::byte[scratch_size_]); // NOLINT
+        }
+        arena_buffer_ = std::move(arena_buffer);
+
+        // Allocations exceeding the arena are served from the heap and released together with the arena
+        memory_resource_ = std::make_unique<std::pmr::monotonic_buffer_resource>(
+            arena_buffer_.get(), scratch_size_, std::pmr::new_delete_resource());
+    }
+    return memory_resource_.get();
+}
+
+void Event::release_scratch_memory() {
+    memory_resource_.reset();
+
+    // Return the buffer to the worker unless it has been replaced in the meantime
+    if(arena_buffer_ != nullptr && arena_buffer == nullptr) {
+        arena_buffer = std::move(arena_buffer_);
+    }
+    arena_buffer_.reset();
+}
+
 void Event::set_and_seed_random_engine(RandomNumberGenerator* random_engine) {
     random_engine_ = random_engine;
     random_engine_->seed(seed_);
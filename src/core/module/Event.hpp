@@ -13,10 +13,12 @@
 #define ALLPIX_MODULE_EVENT_H
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <list>
 #include <map>
 #include <memory>
+#include <memory_resource>
 #include <mutex>
 #include <vector>
 
@@ -45,9 +47,9 @@ namespace allpix {
          */
         explicit Event(Messenger& messenger, uint64_t event_num, uint64_t seed);
         /**
-         * @brief Use default destructor
+         * @brief Return the memory arena to the worker if it is still in use
          */
-        ~Event() = default;
+        ~Event();
 
         /// @{
         /**
@@ -80,6 +82,19 @@ namespace allpix {
          */
         uint64_t getSeed() const { return seed_; }
 
+        /**
+         * @brief Access the scratch memory resource of the module currently processing this event
+         * @return Pointer to the memory arena of the worker, or the default heap resource if the arena is disabled
+         *
+         * Memory obtained from this resource, e.g. via std::pmr containers, is scratch memory of the currently running
+         * module. It is released at once when the run of the module finishes and must therefore not be referenced beyond
+         * it. The arena buffer belongs to the worker thread and is only lent to an event while one of its modules runs, such
+         * that events waiting in the buffer of sequential modules do not hold any arena memory. Messages and the objects
+         * they contain are not allocated from this resource since they outlive the module run. The resource is not
+         * thread-safe, which is sufficient since the modules of a single event are never executed concurrently.
+         */
+        std::pmr::memory_resource* getScratchResource();
+
     private:
         /**
          * @brief Sets the random engine and seed it to be used by this event
@@ -111,9 +126,25 @@ namespace allpix {
          */
         LocalMessenger* get_local_messenger() const;
 
+        /**
+         * @brief Release all memory allocated from the arena and return its buffer to the worker
+         */
+        void release_scratch_memory();
+
+        // Memory arena for the scratch memory of the running module, backed by a buffer lent by the worker
+        static size_t scratch_size_;
+        std::unique_ptr<std::byte[]> arena_buffer_;
+        std::unique_ptr<std::pmr::monotonic_buffer_resource> memory_resource_;
+
         // Local messenger used to dispatch messages in this event
         std::unique_ptr<LocalMessenger> local_messenger_;
 
+        // Module this event has already been prepared for while waiting to be processed in sequence
+        const Module* prepared_module_{nullptr};
+
+        // Time at which this event has been interrupted to wait for its turn in a sequential module
+        std::chrono::steady_clock::time_point interrupted_{};
+
         // Mutex for execution time
         static std::mutex stats_mutex_;
     };
@@ -18,6 +18,7 @@
 #include <utility>
 
 #include "core/messenger/Messenger.hpp"
+#include "core/module/Event.hpp"
 #include "core/module/exceptions.h"
 #include "core/utils/log.h"
 
@@ -167,6 +168,32 @@ bool Module::check_delegates(Messenger* messenger, Event* event) {
     });
 }
 
+/**
+ * The list of slots is small, a linear search avoids hashing the type name on every fetch
+ */
+size_t Module::get_message_slot(const std::type_index& type) const {
+    for(const auto& [slot_type, slot] : message_slots_) {
+        if(slot_type == type) {
+            return slot;
+        }
+    }
+    throw std::out_of_range("module does not listen to message type");
+}
+
 void SequentialModule::waive_sequence_requirement(bool waive) {
     sequence_required_ = !waive;
 }
+
+void SequentialModule::set_prepared(Event* event, std::any data) {
+    std::lock_guard<std::mutex> lock(prepared_mutex_);
+    prepared_[event->number] = std::move(data);
+}
+
+std::any SequentialModule::release_prepared(Event* event) {
+    std::lock_guard<std::mutex> lock(prepared_mutex_);
+    auto node = prepared_.extract(event->number);
+    if(node.empty()) {
+        return {};
+    }
+    return std::move(node.mapped());
+}
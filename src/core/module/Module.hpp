@@ -12,12 +12,15 @@
 #ifndef ALLPIX_MODULE_H
 #define ALLPIX_MODULE_H
 
+#include <any>
 #include <atomic>
 #include <condition_variable>
+#include <limits>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <typeindex>
 #include <vector>
 
 #include <TDirectory.h>
@@ -236,8 +239,25 @@ namespace allpix {
          */
         virtual void skip_event(uint64_t) {}
 
+        /**
+         * @brief Run the parallel preparation of an event before the module itself is run
+         */
+        virtual void prepare_event(Event*) {}
+
         std::vector<std::pair<Messenger*, BaseDelegate*>> delegates_;
 
+        /**
+         * @brief Get the message slot of this module for a given message type
+         * @param type Type of the message
+         * @return Index of the slot
+         * @throws std::out_of_range If the module does not listen to this message type
+         */
+        size_t get_message_slot(const std::type_index& type) const;
+
+        // Dense index of this module and message slots of its delegates, assigned by the messenger
+        size_t messenger_index_{std::numeric_limits<size_t>::max()};
+        std::vector<std::pair<std::type_index, size_t>> message_slots_;
+
         std::shared_ptr<Detector> detector_;
 
         /**
@@ -272,7 +292,49 @@ namespace allpix {
          */
         void waive_sequence_requirement(bool waive = true);
 
+        /**
+         * @brief Prepare the output of an event before it is processed in sequence
+         * @param event Pointer to the event to prepare
+         *
+         * Executed on any worker thread as soon as the event reaches this module, without waiting for the preceding events.
+         * Expensive formatting and serialization should be done here and its result stored with \ref store_prepared, such
+         * that \ref Module::run "run" only has to commit the prepared data in the correct order of events. This method is
+         * called concurrently for different events and must not modify the state of the module.
+         *
+         * Does nothing if not overloaded.
+         */
+        virtual void prepare(Event* event) { (void)event; }
+
+        /**
+         * @brief Store the prepared data of an event until it is committed
+         * @param event Pointer to the event the data belongs to
+         * @param data Prepared data
+         */
+        template <typename T> void store_prepared(Event* event, T data) { set_prepared(event, std::any(std::move(data))); }
+
+        /**
+         * @brief Retrieve and remove the prepared data of an event
+         * @param event Pointer to the event to retrieve the data for
+         * @return Prepared data
+         * @throws std::bad_any_cast If no data of this type has been prepared for the event
+         */
+        template <typename T> T take_prepared(Event* event) { return std::any_cast<T>(release_prepared(event)); }
+
     private:
+        /**
+         * @brief Calls the preparation of the event implemented by the module
+         */
+        void prepare_event(Event* event) override { prepare(event); }
+
+        /**
+         * @brief Store and retrieve type-erased prepared data of an event
+         */
+        void set_prepared(Event* event, std::any data);
+        std::any release_prepared(Event* event);
+
+        std::mutex prepared_mutex_;
+        std::map<uint64_t, std::any> prepared_;
+
         /**
          * @brief Checks if this module needs to be executed in correct event sequence
          *
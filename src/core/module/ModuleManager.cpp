@@ -11,6 +11,7 @@
 
 #include "ModuleManager.hpp"
 #include "Event.hpp"
+#include "Tracer.hpp"
 
 #include <dlfcn.h>
 #include <unistd.h>
@@ -34,6 +35,7 @@
 #include "core/geometry/GeometryManager.hpp"
 #include "core/messenger/Messenger.hpp"
 #include "core/utils/log.h"
+#include "core/utils/numa.h"
 
 // Common prefix for all modules
 // TODO [doc] Should be provided by the build system
@@ -56,6 +58,7 @@ void ModuleManager::load(Messenger* messenger, ConfigManager* conf_manager, Geom
     conf_manager_ = conf_manager;
     auto& configs = conf_manager_->getModuleConfigurations();
     Configuration& global_config = conf_manager_->getGlobalConfiguration();
+    expand_variants(configs);
 
     // Set alias for backward compatibility with the previous keyword for multithreading
     global_config.setDefault("multithreading", true);
@@ -63,6 +66,7 @@ void ModuleManager::load(Messenger* messenger, ConfigManager* conf_manager, Geom
 
     // Set default for performance plot creation:
     global_config.setDefault("performance_plots", false);
+    global_config.setDefault("profile_configuration", false);
 
     // Store the messenger
     messenger_ = messenger;
@@ -273,6 +277,68 @@ void ModuleManager::load(Messenger* messenger, ConfigManager* conf_manager, Geom
     LOG_PROGRESS(STATUS, "LOAD_LOOP") << "Loaded " << configs.size() << " modules";
 }
 
+/**
+ * @throws InvalidValueError If a variant name is empty or used twice, or a variant parameter has a wrong number of values
+ * @throws InvalidCombinationError If a section declaring variants also defines an output
+ *
+ * Every variant of a module section is instantiated with its name as output. Variants with a name already declared by an
+ * earlier section also receive it as input, unless an input is configured explicitly, such that chains of modules with the
+ * same variants process the same upstream messages independently. Parameters listed in variant_parameters hold one value
+ * per variant.
+ */
+void ModuleManager::expand_variants(std::list<Configuration>& configs) {
+    std::set<std::string> declared_variants;
+    for(auto iter = configs.begin(); iter != configs.end();) {
+        auto& config = *iter;
+        if(!config.has("variants")) {
+            ++iter;
+            continue;
+        }
+
+        auto variants = config.getArray<std::string>("variants");
+        if(config.has("output")) {
+            throw InvalidCombinationError(
+                config, {"variants", "output"}, "the output of variants is set to the name of the variant");
+        }
+        for(const auto& variant : variants) {
+            if(variant.empty() || std::count(variants.begin(), variants.end(), variant) > 1) {
+                throw InvalidValueError(config, "variants", "variant names need to be unique and non-empty");
+            }
+        }
+
+        // Split the values of all variant parameters
+        std::map<std::string, std::vector<std::string>> variant_values;
+        for(const auto& key : config.getArray<std::string>("variant_parameters", {})) {
+            auto values = config.getTextArray(key);
+            if(values.size() != variants.size()) {
+                throw InvalidValueError(config,
+                                        key,
+                                        "expected one value for each of the " + std::to_string(variants.size()) +
+                                            " variants, got " + std::to_string(values.size()));
+            }
+            variant_values[key] = values;
+        }
+
+        // Insert one section per variant in place of the original section
+        for(size_t i = 0; i < variants.size(); ++i) {
+            Configuration variant_config = config;
+            variant_config.set<std::string>("output", variants[i]);
+            if(!config.has("input") && declared_variants.count(variants[i]) != 0) {
+                variant_config.set<std::string>("input", variants[i]);
+            }
+            for(const auto& [key, values] : variant_values) {
+                variant_config.setText(key, values[i]);
+            }
+
+            LOG(DEBUG) << "Adding variant " << variants[i] << " of module " << config.getName();
+            configs.insert(iter, std::move(variant_config));
+        }
+
+        declared_variants.insert(variants.begin(), variants.end());
+        iter = configs.erase(iter);
+    }
+}
+
 /**
  * Calls config_manager->addInstanceConfiguration(identifier, config) while handling ModuleIdentifierAlreadyAddedError
  */
@@ -588,6 +654,32 @@ void ModuleManager::initialize() {
             throw InvalidValueError(global_config, "buffer_per_worker", "buffer per worker should be larger than one");
         }
         LOG(STATUS) << "Allocating a total of " << max_buffer_size_ << " event slots for buffered modules";
+
+        // Bind the workers to CPUs of the system if requested
+        auto affinity = global_config.get<std::string>("worker_affinity", "none");
+        if(affinity != "none") {
+            std::vector<unsigned int> cpus;
+            if(affinity == "list") {
+                cpus = global_config.getArray<unsigned int>("worker_cpus");
+            }
+            try {
+                worker_cpus_ = NumaTopology::placeWorkers(affinity, number_of_threads_, cpus);
+            } catch(std::invalid_argument& e) {
+                throw InvalidValueError(global_config, (affinity == "list" ? "worker_cpus" : "worker_affinity"), e.what());
+            }
+            LOG(STATUS) << "Binding workers to CPUs with " << affinity << " placement on " << NumaTopology::nodeCount()
+                        << " NUMA node(s)";
+        }
+
+        // Adapt the number of buffered events to a memory budget if requested, which allows the buffer to grow beyond the
+        // fixed buffer per worker as long as the events fit into the budget with at least 1 kB per event
+        buffer_memory_limit_ = global_config.get<size_t>("buffer_memory_limit", 0);
+        if(buffer_memory_limit_ > 0) {
+            max_buffer_size_ = std::max<size_t>(
+                max_buffer_size_, std::min<size_t>(buffer_memory_limit_ >> 10, std::numeric_limits<unsigned int>::max()));
+            LOG(STATUS) << "Adapting the number of buffered events to a memory budget of " << (buffer_memory_limit_ >> 20)
+                        << " MiB, with at most " << max_buffer_size_ << " buffered events";
+        }
     } else {
         // Issue a warning in case MT was requested but we can't actually run in MT
         if(multithreading_flag_ && !can_parallelize_) {
@@ -608,12 +700,26 @@ void ModuleManager::initialize() {
 
     // Book global performance histograms
     if(global_config.get<bool>("performance_plots")) {
+        // Limit the number of bins for large buffers allowed by a memory budget
+        auto buffer_bins = static_cast<int>(std::min<size_t>(max_buffer_size_, 4096));
         buffer_fill_level_ = CreateHistogram<TH1D>("buffer_fill_level",
                                                    "Buffer fill level;# buffered events;# events",
-                                                   static_cast<int>(max_buffer_size_),
+                                                   buffer_bins,
                                                    0,
                                                    static_cast<double>(max_buffer_size_));
+        if(buffer_memory_limit_ > 0) {
+            buffer_limit_ = CreateHistogram<TH1D>("buffer_limit",
+                                                  "Adaptive buffer limit;# buffer slots;# events",
+                                                  buffer_bins,
+                                                  0,
+                                                  static_cast<double>(max_buffer_size_));
+        }
         event_time_ = CreateHistogram<TH1D>("event_time", "processing time per event;time [s];# events", 1000, 0, 10);
+        event_message_memory_ = CreateHistogram<TH1D>("event_message_memory",
+                                                      "peak memory of messages per event;peak memory [kB];# events",
+                                                      1000,
+                                                      0,
+                                                      10000);
     }
 
     auto start_time = std::chrono::steady_clock::now();
@@ -691,25 +797,38 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
 
     // Creates the thread pool
     LOG(TRACE) << "Initializing thread pool with " << number_of_threads_ << " threads";
-    auto initialize_function =
-        [log_level = Log::getReportingLevel(), log_format = Log::getFormat(), modules_list = modules_]() {
-            // Initialize the threads to the same log level and format as the master setting
-            Log::setReportingLevel(log_level);
-            Log::setFormat(log_format);
-
-            // Call per-thread initialization of each module
-            for(const auto& module : modules_list) {
-                // Set module specific log settings
-                auto old_settings = ModuleManager::set_module_before(
-                    module->get_identifier().getUniqueName(), module->get_configuration(), "T:");
+    auto initialize_function = [log_level = Log::getReportingLevel(),
+                                log_format = Log::getFormat(),
+                                modules_list = modules_,
+                                worker_cpus = worker_cpus_]() {
+        // Initialize the threads to the same log level and format as the master setting
+        Log::setReportingLevel(log_level);
+        Log::setFormat(log_format);
+
+        // Bind the worker before any per-thread memory is allocated by the modules
+        if(!worker_cpus.empty()) {
+            auto cpu = worker_cpus[(ThreadPool::threadNum() - 1) % worker_cpus.size()];
+            if(NumaTopology::bindThread(cpu)) {
+                LOG(DEBUG) << "Bound worker " << ThreadPool::threadNum() << " to CPU " << cpu << " on NUMA node "
+                           << NumaTopology::currentNode();
+            } else {
+                LOG(WARNING) << "Could not bind worker " << ThreadPool::threadNum() << " to CPU " << cpu;
+            }
+        }
 
-                LOG(TRACE) << "Initializing thread " << std::this_thread::get_id();
-                module->initializeThread();
+        // Call per-thread initialization of each module
+        for(const auto& module : modules_list) {
+            // Set module specific log settings
+            auto old_settings = ModuleManager::set_module_before(
+                module->get_identifier().getUniqueName(), module->get_configuration(), "T:");
 
-                // Reset logging
-                ModuleManager::set_module_after(old_settings);
-            }
-        };
+            LOG(TRACE) << "Initializing thread " << std::this_thread::get_id();
+            module->initializeThread();
+
+            // Reset logging
+            ModuleManager::set_module_after(old_settings);
+        }
+    };
 
     // Finalize modules for each thread
     auto finalize_function = [modules_list = modules_]() {
@@ -726,11 +845,27 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
         }
     };
 
+    // Size of the scratch memory arena of every worker, zero disables the arena
+    Event::scratch_size_ = global_config.get<size_t>("module_scratch_size", 0);
+    if(Event::scratch_size_ > 0) {
+        LOG(DEBUG) << "Using module scratch memory arenas of " << Event::scratch_size_ << " bytes";
+    }
+
+    // Resolve message routes between all modules once instead of for every dispatched message
+    messenger_->compileRoutes(modules_);
+
     // Push 128 events for each worker to maintain enough work
     auto max_queue_size = number_of_threads_ * 128;
     thread_pool_ = std::make_unique<ThreadPool>(
         number_of_threads_, max_queue_size, max_buffer_size_, initialize_function, finalize_function);
 
+    // Start with a small buffer which grows when workers are stalled by it
+    if(buffer_memory_limit_ > 0 && number_of_threads_ > 0) {
+        thread_pool_->setBufferLimit(4 * number_of_threads_);
+        min_buffer_limit_ = max_buffer_limit_ = thread_pool_->bufferLimit();
+        last_buffer_update_ = last_buffer_pressure_ = std::chrono::steady_clock::now();
+    }
+
     // Record the run stage total time
     auto start_time = std::chrono::steady_clock::now();
 
@@ -750,6 +885,18 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
         thread_pool_->markComplete(n);
     }
 
+    // Instrument the event loop if a trace file is requested
+    auto trace = global_config.has("trace_file");
+    if(trace) {
+        for(auto& module : modules_) {
+            Tracer::registerOwner(module.get(), module->getUniqueName());
+        }
+        Tracer::enable(global_config.get<size_t>("trace_buffer_size", 1 << 16));
+    }
+
+    // Record configuration keys read from the event loop if requested
+    Configuration::setAccessTracking(global_config.get<bool>("profile_configuration"));
+
     LOG(STATUS) << "Starting event loop";
     for(uint64_t i = 1 + skip_events; i <= number_of_events + skip_events; i++) {
         // Check if run was aborted and stop pushing extra events to the threadpool
@@ -782,6 +929,13 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
                 LOG(TRACE) << "Continue with earlier event, restoring random seed";
                 event->set_and_seed_random_engine(&random_engine);
                 event->restore_random_engine_state();
+                if(Tracer::isEnabled()) {
+                    Tracer::record(Tracer::Category::SEQUENCE,
+                                   module_iter->get(),
+                                   event->number,
+                                   event->interrupted_,
+                                   std::chrono::steady_clock::now());
+                }
             }
 
             while(module_iter != modules_.end()) {
@@ -794,6 +948,7 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
                 if(!module->check_delegates(this->messenger_, event.get())) {
                     LOG(TRACE) << "Not all required messages are received for " << module->get_identifier().getUniqueName()
                                << ", skipping module!";
+                    event->get_local_messenger()->releaseMessages(module.get());
                     ++module_iter;
                     continue;
                 }
@@ -809,6 +964,11 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
                 bool stop = false;
                 bool abort = false;
                 try {
+                    // Prepare the event in parallel before it possibly has to wait for its turn in the sequence
+                    if(event->prepared_module_ != module.get()) {
+                        module->prepare_event(event.get());
+                        event->prepared_module_ = module.get();
+                    }
                     if(module->require_sequence() && event_num != thread_pool_->minimumUncompleted()) {
                         stop = true;
                     } else {
@@ -825,6 +985,9 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
                     this->terminate_ = true;
                 }
 
+                // Release the scratch memory of the module before the event possibly waits in the buffer
+                event->release_scratch_memory();
+
                 // Reset logging
                 ModuleManager::set_module_after(old_settings);
 
@@ -833,6 +996,13 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
                 auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
                 // Note: we do not need to lock a mutex because the std::map is not altered and its values are atomic.
                 this->module_execution_time_[module.get()] += duration;
+                if(Tracer::isEnabled()) {
+                    if(stop) {
+                        event->interrupted_ = end;
+                    } else {
+                        Tracer::record(Tracer::Category::RUN, module.get(), event->number, start, end);
+                    }
+                }
 
                 if(plot) {
                     std::lock_guard<std::mutex> stat_lock{event->stats_mutex_};
@@ -854,6 +1024,7 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
                     event->store_random_engine_state();
                     // Reschedule the event:
                     auto event_function = std::bind(self_func, event, module_iter, event_time, self_func);
+                    Tracer::Scope span(Tracer::Category::PUSH, nullptr, event->number);
                     auto future = thread_pool_->submit(event->number, event_function, false);
                     assert(future.valid() || !thread_pool_->valid());
                     auto buffered_events = thread_pool_->bufferedQueueSize();
@@ -862,6 +1033,9 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
                     return;
                 }
 
+                // Free messages which are not required by any of the remaining modules
+                event->get_local_messenger()->releaseMessages(module.get());
+
                 ++module_iter;
             }
 #pragma GCC diagnostic pop
@@ -871,9 +1045,22 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
             LOG(INFO) << "Finished event " << event_num << " with seed " << event_seed;
 
             auto buffered_events = thread_pool_->bufferedQueueSize();
+            auto peak_memory = static_cast<uint64_t>(event->get_local_messenger()->getPeakMemoryUsage());
+            this->total_peak_message_memory_ += peak_memory;
+            auto max_memory = this->max_peak_message_memory_.load();
+            while(peak_memory > max_memory &&
+                  !this->max_peak_message_memory_.compare_exchange_weak(max_memory, peak_memory)) {
+            }
+            if(buffer_memory_limit_ > 0 && number_of_threads_ > 0) {
+                this->adapt_buffer_limit(peak_memory);
+            }
             if(plot) {
                 this->buffer_fill_level_->Fill(static_cast<double>(buffered_events));
+                if(buffer_memory_limit_ > 0) {
+                    this->buffer_limit_->Fill(static_cast<double>(thread_pool_->bufferLimit()));
+                }
                 event_time_->Fill(static_cast<double>(event_time) * 1e-9);
+                event_message_memory_->Fill(static_cast<double>(peak_memory) / 1024.);
             }
 
             finished_events++;
@@ -884,6 +1071,7 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
         auto event_function =
             std::bind(event_function_with_module, nullptr, modules_.begin(), 0, event_function_with_module);
 
+        Tracer::Scope span(Tracer::Category::PUSH, nullptr, i);
         auto future = thread_pool_->submit(event_function);
         assert(future.valid() || !thread_pool_->valid());
         thread_pool_->checkException();
@@ -893,6 +1081,8 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
 
     // Wait for workers to finish
     thread_pool_->wait();
+    Configuration::setAccessTracking(false);
+    Tracer::disable();
 
     // Check exception for last events
     thread_pool_->checkException();
@@ -909,6 +1099,82 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
 
     LOG(TRACE) << "Destroying thread pool";
     thread_pool_.reset();
+
+    // Write the timeline of the event loop
+    if(trace) {
+        auto trace_file = std::filesystem::path(gSystem->pwd()) / global_config.get<std::string>("trace_file");
+        if(!trace_file.has_extension()) {
+            trace_file.replace_extension("json");
+        }
+        try {
+            Tracer::writeTrace(trace_file);
+        } catch(std::runtime_error& e) {
+            throw InvalidValueError(global_config, "trace_file", e.what());
+        }
+        LOG(STATUS) << "Wrote timeline of the event loop to " << trace_file;
+    }
+}
+
+/**
+ * The buffer limit is doubled if the workers are stalled because the buffer is full. It is reduced by a quarter if less than
+ * half of the buffer has been used for as long as it takes to commit the full buffer at the observed commit rate of the
+ * sequential modules. The limit never exceeds the number of events fitting into the memory budget at the observed average
+ * memory footprint per event, including the events currently processed by the workers. It is not bound by the buffer per
+ * worker, only by the capacity of the buffer derived from the memory budget.
+ */
+void ModuleManager::adapt_buffer_limit(uint64_t event_footprint) {
+    using namespace std::chrono_literals;
+
+    // Skip the update if another worker is adapting the buffer already
+    std::unique_lock<std::mutex> lock(buffer_control_mutex_, std::try_to_lock);
+    if(!lock.owns_lock()) {
+        return;
+    }
+
+    auto footprint = static_cast<double>(event_footprint);
+    event_footprint_ = (event_footprint_ > 0 ? 0.9 * event_footprint_ + 0.1 * footprint : footprint);
+
+    // Update at most every 50ms to obtain a meaningful commit rate
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration<double>(now - last_buffer_update_).count();
+    if(now - last_buffer_update_ < 50ms) {
+        return;
+    }
+    auto committed = thread_pool_->minimumUncompleted();
+    auto rate = static_cast<double>(committed - std::min(committed, committed_events_)) / elapsed;
+    commit_rate_ = (commit_rate_ > 0 ? 0.8 * commit_rate_ + 0.2 * rate : rate);
+    committed_events_ = committed;
+    last_buffer_update_ = now;
+
+    auto limit = thread_pool_->bufferLimit();
+    auto buffered = thread_pool_->bufferedQueueSize();
+    auto target = limit;
+    if(buffered + number_of_threads_ >= limit) {
+        // Workers do not take new events because the buffer is full
+        target = 2 * limit;
+        last_buffer_pressure_ = now;
+    } else if(2 * buffered < limit && commit_rate_ > 0 &&
+              std::chrono::duration<double>(now - last_buffer_pressure_).count() >
+                  static_cast<double>(limit) / commit_rate_) {
+        target = limit - limit / 4;
+        last_buffer_pressure_ = now;
+    }
+
+    // Respect the memory budget for all buffered events and the ones currently processed
+    auto memory_bound = static_cast<size_t>(static_cast<double>(buffer_memory_limit_) / std::max(event_footprint_, 1.));
+    memory_bound = (memory_bound > number_of_threads_ ? memory_bound - number_of_threads_ : 0);
+    target = std::min(target, memory_bound);
+
+    thread_pool_->setBufferLimit(target);
+    auto new_limit = thread_pool_->bufferLimit();
+    if(new_limit != limit) {
+        LOG(DEBUG) << "Changing buffer limit from " << limit << " to " << new_limit << " events (" << buffered
+                   << " buffered, " << std::round(event_footprint_ / 1024.) << "kB per event, committing "
+                   << std::round(commit_rate_) << " events/s)";
+        ++buffer_adjustments_;
+        min_buffer_limit_ = std::min(min_buffer_limit_, new_limit);
+        max_buffer_limit_ = std::max(max_buffer_limit_, new_limit);
+    }
 }
 
 static std::string nanoseconds_to_time(uint64_t nanoseconds) {
@@ -974,6 +1240,10 @@ void ModuleManager::finalize() {
 
         event_time_->Write();
         buffer_fill_level_->Write();
+        if(buffer_memory_limit_ > 0) {
+            buffer_limit_->Write();
+        }
+        event_message_memory_->Write();
 
         for(auto& module : modules_) {
             auto module_name = module->get_configuration().getName();
@@ -1028,6 +1298,29 @@ void ModuleManager::finalize() {
         }
     }
 
+    // List configuration keys which have been read during the event loop
+    if(global_config.get<bool>("profile_configuration")) {
+        for(auto& config : conf_manager_->getInstanceConfigurations()) {
+            auto tracked_keys = config.getTrackedKeys();
+            if(tracked_keys.empty()) {
+                continue;
+            }
+
+            auto unique_name = config.getName();
+            auto identifier = config.get<std::string>("identifier");
+            if(!identifier.empty()) {
+                unique_name += ":";
+                unique_name += identifier;
+            }
+            std::stringstream st;
+            st << "Configuration keys read during the event loop in section " << unique_name << ":";
+            for(auto& key : tracked_keys) {
+                st << std::endl << key;
+            }
+            LOG(WARNING) << st.str();
+        }
+    }
+
     // Find the slowest module, and accumulate the total run-time for all modules
     int64_t slowest_time = 0, total_module_time = 0;
     std::string slowest_module;
@@ -1044,6 +1337,15 @@ void ModuleManager::finalize() {
     for(auto& module : modules_) {
         LOG(INFO) << " Module " << module->getUniqueName() << " took "
                   << Units::display(module_execution_time_[module.get()].load(), {"s", "ms"});
+
+        // Report latency percentiles if the event loop has been instrumented
+        const auto* latencies = Tracer::getLatencies(module.get());
+        if(latencies != nullptr && latencies->count() > 0) {
+            auto display = [](int64_t nanoseconds) { return Units::display(nanoseconds, {"ms", "us"}); };
+            LOG(INFO) << "  latency per event: p50 " << display(latencies->quantile(0.5)) << ", p90 "
+                      << display(latencies->quantile(0.9)) << ", p99 " << display(latencies->quantile(0.99)) << ", p99.9 "
+                      << display(latencies->quantile(0.999)) << ", max " << display(latencies->max());
+        }
     }
 
     auto processing_time = std::round(run_time_ / std::max(uint64_t(1), global_config.get<uint64_t>("number_of_events")));
@@ -1052,6 +1354,17 @@ void ModuleManager::finalize() {
                 << std::round(global_config.get<double>("number_of_events") / Units::convert(run_time_, "s"))
                 << " Hz\x1B[0m";
 
+    auto average_memory =
+        total_peak_message_memory_ / std::max(uint64_t(1), global_config.get<uint64_t>("number_of_events"));
+    LOG(INFO) << "Peak memory held by messages is " << (average_memory / 1024) << "kB/event on average, "
+              << (max_peak_message_memory_ / 1024) << "kB maximum";
+
+    if(buffer_memory_limit_ > 0 && number_of_threads_ > 0) {
+        LOG(INFO) << "Adapted the buffer limit " << buffer_adjustments_ << " times between " << min_buffer_limit_ << " and "
+                  << max_buffer_limit_ << " events, with " << std::round(event_footprint_ / 1024.)
+                  << "kB/event and a commit rate of " << std::round(commit_rate_) << " events/s at the end of the run";
+    }
+
     if(global_config.get<unsigned int>("workers") > 0) {
         auto event_processing_time = std::round(processing_time * global_config.get<unsigned int>("workers"));
         LOG(STATUS) << "This corresponds to a processing time of \x1B[1m"
@@ -13,9 +13,11 @@
 #define ALLPIX_MODULE_MANAGER_H
 
 #include <atomic>
+#include <chrono>
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <queue>
 
 #include <TDirectory.h>
@@ -110,6 +112,12 @@ namespace allpix {
         void terminate();
 
     private:
+        /**
+         * @brief Replace module sections declaring variants by one section per variant
+         * @param configs List of module configurations
+         */
+        static void expand_variants(std::list<Configuration>& configs);
+
         /**
          * @brief Create unique modules
          * @param library Void pointer to the loaded library
@@ -149,6 +157,12 @@ namespace allpix {
          */
         static void set_module_after(std::tuple<LogLevel, LogFormat, std::string, uint64_t> prev);
 
+        /**
+         * @brief Adapt the number of events which can be buffered to the observed event footprint and commit rate
+         * @param event_footprint Memory held by the finished event in bytes
+         */
+        void adapt_buffer_limit(uint64_t event_footprint);
+
         using IdentifierToModuleMap = std::map<ModuleIdentifier, ModuleList::iterator>;
 
         ModuleList modules_;
@@ -163,6 +177,11 @@ namespace allpix {
         std::map<Module*, Histogram<TH1D>> module_event_time_;
         Histogram<TH1D> event_time_;
         Histogram<TH1D> buffer_fill_level_;
+        Histogram<TH1D> buffer_limit_;
+        Histogram<TH1D> event_message_memory_;
+
+        // Peak memory of messages per event in bytes
+        std::atomic<uint64_t> total_peak_message_memory_{}, max_peak_message_memory_{};
 
         // Durations in ns
         uint64_t initialize_time_{}, run_time_{}, finalize_time_{};
@@ -181,6 +200,18 @@ namespace allpix {
         unsigned int number_of_threads_{0};
         size_t max_buffer_size_{1};
 
+        // CPU assigned to every worker, empty if workers are not bound
+        std::vector<unsigned int> worker_cpus_;
+
+        // State of the adaptive buffer sizing, only used if a memory budget for the buffer is given
+        size_t buffer_memory_limit_{0};
+        std::mutex buffer_control_mutex_;
+        double event_footprint_{0}, commit_rate_{0};
+        uint64_t committed_events_{0};
+        std::chrono::steady_clock::time_point last_buffer_update_, last_buffer_pressure_;
+        size_t min_buffer_limit_{0}, max_buffer_limit_{0};
+        uint64_t buffer_adjustments_{0};
+
         // Possibility of running loaded modules in parallel
         bool can_parallelize_{true};
     };
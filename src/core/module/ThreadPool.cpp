@@ -14,6 +14,7 @@
 #include <cassert>
 
 #include "Module.hpp"
+#include "Tracer.hpp"
 
 using namespace allpix;
 
@@ -37,14 +38,15 @@ ThreadPool::ThreadPool(unsigned int num_threads,
                        unsigned int max_buffered_size,
                        const std::function<void()>& worker_init_function,
                        const std::function<void()>& worker_finalize_function)
-    : queue_(max_queue_size, max_buffered_size) {
+    : queue_(max_queue_size, max_buffered_size), max_buffered_size_(max_buffered_size),
+      min_buffered_size_(std::min(num_threads, max_buffered_size)) {
     assert(max_buffered_size == 0 || max_buffered_size >= num_threads);
     // Create threads
     try {
         for(unsigned int i = 0u; i < num_threads; ++i) {
             threads_.emplace_back(&ThreadPool::worker,
                                   this,
-                                  std::min(num_threads, max_buffered_size),
+                                  min_buffered_size_,
                                   worker_init_function,
                                   worker_finalize_function);
         }
@@ -73,6 +75,14 @@ void ThreadPool::markComplete(uint64_t n) {
     queue_.complete(n);
 }
 
+/**
+ * The limit cannot be lower than the number of workers, since every worker needs to be able to buffer the event it is
+ * currently processing.
+ */
+void ThreadPool::setBufferLimit(size_t limit) {
+    queue_.setPriorityLimit(std::clamp(limit, min_buffered_size_, max_buffered_size_));
+}
+
 void ThreadPool::checkException() {
     // If exception has been thrown, destroy pool and propagate it
     if(exception_ptr_) {
@@ -107,7 +117,12 @@ void ThreadPool::worker(size_t min_thread_buffer,
         while(!done_) {
             Task task{nullptr};
 
-            if(queue_.pop(task, min_thread_buffer)) {
+            bool popped = false;
+            {
+                Tracer::Scope span(Tracer::Category::POP, nullptr);
+                popped = queue_.pop(task, min_thread_buffer);
+            }
+            if(popped) {
                 // Execute task
                 (*task)();
                 // Fetch the future to propagate exceptions
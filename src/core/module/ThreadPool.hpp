@@ -114,6 +114,22 @@ namespace allpix {
              */
             size_t prioritySize() const;
 
+            /**
+             * @brief Limit the number of values in the priority queue taken into account when popping the standard queue
+             * @param limit Soft limit of the priority queue size, at most the maximum size of the priority queue
+             *
+             * Values from the standard queue are only popped if the priority queue holds less values than this limit.
+             * Pushing to the priority queue is still possible up to its maximum size, such that the limit can be lowered at
+             * any time.
+             */
+            void setPriorityLimit(size_t limit);
+
+            /**
+             * @brief Return the soft limit of the priority queue size
+             * @return Limit of the priority queue
+             */
+            size_t priorityLimit() const { return priority_limit_; }
+
             /**
              * @brief Invalidate the queue
              */
@@ -132,6 +148,7 @@ namespace allpix {
             std::condition_variable pop_condition_;
             const size_t max_standard_size_;
             const size_t max_priority_size_;
+            std::atomic_size_t priority_limit_;
         };
 
         /**
@@ -212,6 +229,18 @@ namespace allpix {
          */
         size_t bufferedQueueSize() const { return queue_.prioritySize(); }
 
+        /**
+         * @brief Change the number of jobs which can be buffered before workers stop taking new jobs
+         * @param limit Requested buffer limit, clamped between the number of workers and the maximum buffer size
+         */
+        void setBufferLimit(size_t limit);
+
+        /**
+         * @brief Return the current number of jobs which can be buffered before workers stop taking new jobs
+         * @return Buffer limit
+         */
+        size_t bufferLimit() const { return queue_.priorityLimit(); }
+
         /**
          * @brief Check if any worker thread has thrown an exception
          * @throw Exception thrown by worker thread, if any
@@ -271,6 +300,8 @@ namespace allpix {
         using Task = std::unique_ptr<std::packaged_task<void()>>;
         SafeQueue<Task> queue_;
         bool with_buffered_{true};
+        size_t max_buffered_size_{0};
+        size_t min_buffered_size_{0};
         std::function<void()> finalize_function_{};
 
         std::atomic_bool done_{false};
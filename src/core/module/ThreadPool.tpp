@@ -15,7 +15,8 @@
 namespace allpix {
     template <typename T>
     ThreadPool::SafeQueue<T>::SafeQueue(unsigned int max_standard_size, unsigned max_priority_size)
-        : max_standard_size_(max_standard_size), max_priority_size_(max_priority_size) {}
+        : max_standard_size_(max_standard_size), max_priority_size_(max_priority_size),
+          priority_limit_(max_priority_size) {}
 
     /*
      * Block until a value is available if the wait parameter is set to true. The wait exits when the queue is invalidated.
@@ -32,7 +33,7 @@ namespace allpix {
 
         // Wait for one of the queues to be available
         bool pop_priority = !priority_queue_.empty() && priority_queue_.top().first == current_id_;
-        bool pop_standard = !queue_.empty() && priority_queue_.size() + buffer_left <= max_priority_size_;
+        bool pop_standard = !queue_.empty() && priority_queue_.size() + buffer_left <= priority_limit_;
         while(!pop_priority && !pop_standard) {
             // Wait for new item in the queue (unlocks the mutex while waiting)
             pop_condition_.wait(lock);
@@ -40,7 +41,7 @@ namespace allpix {
                 return false;
             }
             pop_priority = !priority_queue_.empty() && priority_queue_.top().first == current_id_;
-            pop_standard = !queue_.empty() && priority_queue_.size() + buffer_left <= max_priority_size_;
+            pop_standard = !queue_.empty() && priority_queue_.size() + buffer_left <= priority_limit_;
         }
 
         // Pop the appropriate queue
@@ -157,6 +158,13 @@ namespace allpix {
 
     template <typename T> size_t ThreadPool::SafeQueue<T>::prioritySize() const { return priority_queue_size_; }
 
+    template <typename T> void ThreadPool::SafeQueue<T>::setPriorityLimit(size_t limit) {
+        std::unique_lock<std::mutex> lock{mutex_};
+        priority_limit_ = std::min(limit, max_priority_size_);
+        lock.unlock();
+        pop_condition_.notify_all();
+    }
+
     /*
      * Used to ensure no conditions are being waited for in pop when a thread or the application is trying to exit. The queue
      * is invalid after calling this method and it is an error to continue using a queue after this method has been called.
@@ -0,0 +1,236 @@
+/**
+ * @file
+ * @brief Implementation of the event loop instrumentation
+ *
+ * @copyright Copyright (c) 2023 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "Tracer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+#include "ThreadPool.hpp"
+
+using namespace allpix;
+
+std::atomic<bool> Tracer::enabled_{false};
+size_t Tracer::capacity_{0};
+std::chrono::steady_clock::time_point Tracer::origin_{};
+std::unordered_map<const void*, Tracer::Owner> Tracer::owners_;
+std::mutex Tracer::buffers_mutex_;
+std::vector<std::unique_ptr<Tracer::Buffer>> Tracer::buffers_;
+
+/**
+ * Values below 64ns are binned exactly. Above, the bin is determined by the position of the most significant bit and the
+ * five bits following it.
+ */
+size_t LatencyHistogram::bin(uint64_t value) {
+    if(value < 2 * sub_bins_) {
+        return static_cast<size_t>(value);
+    }
+
+    size_t msb = 63;
+    while((value >> msb) == 0) {
+        --msb;
+    }
+    auto mantissa = static_cast<size_t>(value >> (msb - 5));
+    return 2 * sub_bins_ + (msb - 6) * sub_bins_ + (mantissa - sub_bins_);
+}
+
+uint64_t LatencyHistogram::bin_center(size_t bin) {
+    if(bin < 2 * sub_bins_) {
+        return bin;
+    }
+
+    auto msb = (bin - 2 * sub_bins_) / sub_bins_ + 6;
+    auto mantissa = (bin - 2 * sub_bins_) % sub_bins_ + sub_bins_;
+    auto shift = msb - 5;
+    return (static_cast<uint64_t>(mantissa) << shift) + (uint64_t(1) << (shift - 1));
+}
+
+void LatencyHistogram::add(int64_t nanoseconds) {
+    auto value = static_cast<uint64_t>(std::max(int64_t(0), nanoseconds));
+    counts_[bin(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+
+    auto current_max = max_.load(std::memory_order_relaxed);
+    while(nanoseconds > current_max && !max_.compare_exchange_weak(current_max, nanoseconds, std::memory_order_relaxed)) {
+    }
+}
+
+int64_t LatencyHistogram::quantile(double quantile) const {
+    auto total = count_.load();
+    if(total == 0) {
+        return 0;
+    }
+
+    // Find the bin in which the requested number of entries is reached
+    auto target = static_cast<uint64_t>(std::ceil(std::clamp(quantile, 0., 1.) * static_cast<double>(total)));
+    uint64_t sum = 0;
+    for(size_t i = 0; i < bins_; ++i) {
+        sum += counts_[i].load(std::memory_order_relaxed);
+        if(sum >= std::max(target, uint64_t(1))) {
+            return std::min(static_cast<int64_t>(bin_center(i)), max_.load());
+        }
+    }
+    return max_.load();
+}
+
+/**
+ * Buffers are kept alive until the end of the program, such that spans of worker threads which already terminated can still
+ * be written.
+ */
+Tracer::Buffer& Tracer::local_buffer() {
+    thread_local Buffer* buffer = nullptr;
+    if(buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        buffer = buffers_.emplace_back(std::make_unique<Buffer>()).get();
+        buffer->thread_num = ThreadPool::threadNum();
+        buffer->spans.resize(capacity_);
+    }
+    return *buffer;
+}
+
+void Tracer::enable(size_t capacity) {
+    capacity_ = std::max(capacity, size_t(1));
+    origin_ = std::chrono::steady_clock::now();
+    for(auto& [owner, info] : owners_) {
+        info.latencies = std::make_unique<LatencyHistogram>();
+    }
+
+    // Discard spans of an earlier recording
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    for(auto& buffer : buffers_) {
+        buffer->spans.assign(capacity_, Span());
+        buffer->recorded = 0;
+    }
+    enabled_.store(true);
+}
+
+void Tracer::disable() {
+    enabled_.store(false);
+}
+
+void Tracer::registerOwner(const void* owner, std::string name) {
+    owners_[owner] = Owner{std::move(name), std::make_unique<LatencyHistogram>()};
+}
+
+void Tracer::record(Category category,
+                    const void* owner,
+                    uint64_t event,
+                    std::chrono::steady_clock::time_point start,
+                    std::chrono::steady_clock::time_point end) {
+    if(!isEnabled()) {
+        return;
+    }
+
+    auto& buffer = local_buffer();
+    buffer.spans[buffer.recorded % capacity_] =
+        Span{owner,
+             event,
+             std::chrono::duration_cast<std::chrono::nanoseconds>(start - origin_).count(),
+             std::chrono::duration_cast<std::chrono::nanoseconds>(end - origin_).count(),
+             category};
+    ++buffer.recorded;
+
+    // Histogram the execution time of modules
+    if(category == Category::RUN) {
+        auto iter = owners_.find(owner);
+        if(iter != owners_.end()) {
+            iter->second.latencies->add(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        }
+    }
+}
+
+const LatencyHistogram* Tracer::getLatencies(const void* owner) {
+    auto iter = owners_.find(owner);
+    if(iter == owners_.end()) {
+        return nullptr;
+    }
+    return iter->second.latencies.get();
+}
+
+/**
+ * Spans are written as complete events on the track of the thread which recorded them. Since an event waiting for a
+ * sequential module is not bound to a thread, these spans are written as asynchronous events identified by the event number.
+ *
+ * @warning This method should only be called when no other thread records spans anymore
+ */
+void Tracer::writeTrace(const std::filesystem::path& path) {
+    std::ofstream file(path);
+    if(!file) {
+        throw std::runtime_error("cannot open trace file " + path.string());
+    }
+
+    auto category_name = [](Category category) {
+        switch(category) {
+        case Category::RUN:
+            return "run";
+        case Category::SEQUENCE:
+            return "sequence";
+        case Category::PUSH:
+            return "push";
+        case Category::POP:
+            return "pop";
+        case Category::DISPATCH:
+            return "dispatch";
+        }
+        return "";
+    };
+    auto span_name = [&](const Span& span) -> std::string {
+        auto iter = owners_.find(span.owner);
+        if(iter != owners_.end()) {
+            return iter->second.name;
+        }
+        return category_name(span.category);
+    };
+
+    // Timestamps are given in microseconds, print them with nanosecond resolution independent of their magnitude
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    file << R"({"name":"process_name","ph":"M","pid":1,"tid":0,"args":{"name":"Allpix Squared"}})";
+
+    std::lock_guard<std::mutex> lock(buffers_mutex_);
+    size_t tid = 0;
+    for(const auto& buffer_ptr : buffers_) {
+        const auto& buffer = *buffer_ptr;
+        ++tid;
+        if(buffer.recorded == 0) {
+            continue;
+        }
+        file << ",\n"
+             << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << tid << R"(,"args":{"name":")"
+             << (buffer.thread_num == 0 ? std::string("main thread") : "worker " + std::to_string(buffer.thread_num))
+             << "\"}}";
+
+        auto first = (buffer.recorded > capacity_ ? buffer.recorded - capacity_ : 0);
+        for(auto n = first; n < buffer.recorded; ++n) {
+            const auto& span = buffer.spans[n % capacity_];
+            auto start = static_cast<double>(span.start) * 1e-3;
+            auto duration = static_cast<double>(span.end - span.start) * 1e-3;
+            if(span.category == Category::SEQUENCE) {
+                file << ",\n{\"name\":\"" << span_name(span) << "\",\"cat\":\"sequence\",\"ph\":\"b\",\"id\":" << span.event
+                     << ",\"pid\":1,\"tid\":" << tid << ",\"ts\":" << start << "}";
+                file << ",\n{\"name\":\"" << span_name(span) << "\",\"cat\":\"sequence\",\"ph\":\"e\",\"id\":" << span.event
+                     << ",\"pid\":1,\"tid\":" << tid << ",\"ts\":" << start + duration << "}";
+            } else {
+                file << ",\n{\"name\":\"" << span_name(span) << "\",\"cat\":\"" << category_name(span.category)
+                     << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid << ",\"ts\":" << start << ",\"dur\":" << duration
+                     << ",\"args\":{\"event\":" << span.event << "}}";
+            }
+        }
+    }
+
+    file << "\n]}\n";
+    if(!file) {
+        throw std::runtime_error("cannot write trace file " + path.string());
+    }
+}
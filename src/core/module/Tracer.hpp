@@ -0,0 +1,227 @@
+/**
+ * @file
+ * @brief Definition of the event loop instrumentation
+ *
+ * @copyright Copyright (c) 2023 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_TRACER_H
+#define ALLPIX_TRACER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace allpix {
+    /**
+     * @brief Histogram of latencies with logarithmic bins of constant relative precision
+     *
+     * Values are binned exactly below 64ns and in 32 linear sub-bins per power of two above, which limits the relative
+     * error of every quantile to about 3%. Filling the histogram is lock-free and thread-safe.
+     */
+    class LatencyHistogram {
+    public:
+        /**
+         * @brief Add a latency to the histogram
+         * @param nanoseconds Latency in nanoseconds
+         */
+        void add(int64_t nanoseconds);
+
+        /**
+         * @brief Return the total number of entries
+         */
+        uint64_t count() const { return count_.load(); }
+
+        /**
+         * @brief Return the largest latency added
+         */
+        int64_t max() const { return max_.load(); }
+
+        /**
+         * @brief Compute a quantile of the latency distribution
+         * @param quantile Quantile in the range from zero to one
+         * @return Latency in nanoseconds (center of the bin containing the quantile)
+         */
+        int64_t quantile(double quantile) const;
+
+    private:
+        static constexpr size_t sub_bins_ = 32;
+        static constexpr size_t bins_ = 2 * sub_bins_ + (63 - 6 + 1) * sub_bins_;
+
+        static size_t bin(uint64_t value);
+        static uint64_t bin_center(size_t bin);
+
+        std::array<std::atomic<uint64_t>, bins_> counts_{};
+        std::atomic<uint64_t> count_{0};
+        std::atomic<int64_t> max_{0};
+    };
+
+    /**
+     * @brief Recorder of the timeline of the event loop
+     *
+     * If enabled, time spans of module execution, events waiting for their turn in a sequential module, buffer operations of
+     * the thread pool and message dispatching are recorded in a ring buffer of fixed size per thread. The timeline can be
+     * written in the Chrome trace event format, which can be inspected with the Perfetto UI or chrome://tracing. The
+     * latencies of every module are histogrammed in addition to report percentiles of the processing time per event.
+     *
+     * When disabled, the only overhead is a relaxed atomic load at every instrumented location.
+     */
+    class Tracer {
+    public:
+        /**
+         * @brief Category of a recorded time span
+         */
+        enum class Category : uint8_t {
+            RUN = 0,  ///< Execution of a module for an event
+            SEQUENCE, ///< Event waiting for its turn in a sequential module
+            PUSH,     ///< Submission of an event to the thread pool
+            POP,      ///< Worker waiting for an event from the thread pool
+            DISPATCH, ///< Dispatching of a message to its receivers
+        };
+
+        /**
+         * @brief Enable the recording and discard all previously recorded spans
+         * @param capacity Maximum number of spans kept per thread, older spans are overwritten
+         * @warning All owners have to be registered before the recording is enabled
+         */
+        static void enable(size_t capacity);
+
+        /**
+         * @brief Disable the recording, the recorded spans are kept
+         */
+        static void disable();
+
+        /**
+         * @brief Check if spans are being recorded
+         */
+        static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Register a name for the owner of time spans, typically a module instance
+         * @param owner Pointer to the owner used to identify it when recording
+         * @param name Name to show in the timeline and latency summary
+         * @warning This method is not thread-safe and should only be called while the recording is disabled
+         */
+        static void registerOwner(const void* owner, std::string name);
+
+        /**
+         * @brief Record a time span of the calling thread
+         * @param category Category of the span
+         * @param owner Registered owner of the span or a nullptr
+         * @param event Number of the event the span belongs to, zero if not related to a specific event
+         * @param start Start time of the span
+         * @param end End time of the span
+         */
+        static void record(Category category,
+                           const void* owner,
+                           uint64_t event,
+                           std::chrono::steady_clock::time_point start,
+                           std::chrono::steady_clock::time_point end);
+
+        /**
+         * @brief Write all recorded spans to a file in the Chrome trace event format
+         * @param path Path of the file to write
+         * @throws std::runtime_error If the file cannot be written
+         */
+        static void writeTrace(const std::filesystem::path& path);
+
+        /**
+         * @brief Return the latency histogram of a registered owner
+         * @param owner Pointer to the registered owner
+         * @return Histogram of the module execution latencies or a nullptr if the owner is not registered
+         */
+        static const LatencyHistogram* getLatencies(const void* owner);
+
+        /**
+         * @brief Helper to record the time span of a scope
+         */
+        class Scope {
+        public:
+            /**
+             * @brief Start recording the span if the recording is enabled
+             * @param category Category of the span
+             * @param owner Registered owner of the span or a nullptr
+             * @param event Number of the event the span belongs to
+             */
+            Scope(Category category, const void* owner, uint64_t event = 0)
+                : category_(category), owner_(owner), event_(event), active_(isEnabled()) {
+                if(active_) {
+                    start_ = std::chrono::steady_clock::now();
+                }
+            }
+            ~Scope() {
+                if(active_) {
+                    record(category_, owner_, event_, start_, std::chrono::steady_clock::now());
+                }
+            }
+
+            /// @{
+            /**
+             * @brief Disallow copy and move
+             */
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+            Scope(Scope&&) = delete;
+            Scope& operator=(Scope&&) = delete;
+            /// @}
+
+        private:
+            Category category_;
+            const void* owner_;
+            uint64_t event_;
+            bool active_;
+            std::chrono::steady_clock::time_point start_;
+        };
+
+    private:
+        /**
+         * @brief Recorded time span relative to the moment the recording has been enabled
+         */
+        struct Span {
+            const void* owner;
+            uint64_t event;
+            int64_t start;
+            int64_t end;
+            Category category;
+        };
+
+        /**
+         * @brief Ring buffer of spans recorded by a single thread
+         */
+        struct Buffer {
+            unsigned int thread_num{};
+            std::vector<Span> spans;
+            uint64_t recorded{};
+        };
+
+        /**
+         * @brief Registered owner of spans
+         */
+        struct Owner {
+            std::string name;
+            std::unique_ptr<LatencyHistogram> latencies;
+        };
+
+        static Buffer& local_buffer();
+
+        static std::atomic<bool> enabled_;
+        static size_t capacity_;
+        static std::chrono::steady_clock::time_point origin_;
+        static std::unordered_map<const void*, Owner> owners_;
+        static std::mutex buffers_mutex_;
+        static std::vector<std::unique_ptr<Buffer>> buffers_;
+    };
+} // namespace allpix
+
+#endif /* ALLPIX_TRACER_H */
@@ -12,16 +12,20 @@
 #ifndef ALLPIX_RANDOM_DISTRIBUTIONS_H
 #define ALLPIX_RANDOM_DISTRIBUTIONS_H
 
+#include <boost/random/binomial_distribution.hpp>
 #include <boost/random/exponential_distribution.hpp>
 #include <boost/random/normal_distribution.hpp>
 #include <boost/random/piecewise_linear_distribution.hpp>
 #include <boost/random/poisson_distribution.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
 #include <boost/random/uniform_real_distribution.hpp>
 
 namespace allpix {
+    template <typename T> using binomial_distribution = boost::random::binomial_distribution<T>;
     template <typename T> using normal_distribution = boost::random::normal_distribution<T>;
     template <typename T> using piecewise_linear_distribution = boost::random::piecewise_linear_distribution<T>;
     template <typename T> using poisson_distribution = boost::random::poisson_distribution<T>;
+    template <typename T> using uniform_int_distribution = boost::random::uniform_int_distribution<T>;
     template <typename T> using uniform_real_distribution = boost::random::uniform_real_distribution<T>;
     template <typename T> using exponential_distribution = boost::random::exponential_distribution<T>;
 } // namespace allpix
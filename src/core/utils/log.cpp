@@ -13,12 +13,14 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <exception>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <ostream>
-#include <regex>
 #include <string>
 #include <thread>
 #include <unistd.h>
@@ -32,6 +34,162 @@ std::string DefaultLogger::last_message_;
 // Mutex to guard output writing
 std::mutex DefaultLogger::write_mutex_;
 
+namespace {
+    /**
+     * @brief Lock-free ring buffer handing records from a single logging thread to the background thread
+     */
+    template <typename T, size_t N> class RecordBuffer {
+    public:
+        /**
+         * @brief Add a record to the buffer, only to be called by the owning thread
+         * @param record Record to add
+         * @return True if the record was added, false if the buffer is full
+         */
+        bool push(T& record) {
+            auto head = head_.load(std::memory_order_relaxed);
+            if(head - tail_.load(std::memory_order_acquire) == N) {
+                return false;
+            }
+            records_[head % N] = std::move(record);
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Move all available records to the output, only to be called by the background thread
+         * @param output Vector to append the records to
+         * @return Number of records moved to the output
+         */
+        size_t pop_all(std::vector<T>& output) {
+            auto tail = tail_.load(std::memory_order_relaxed);
+            auto head = head_.load(std::memory_order_acquire);
+            for(; tail != head; ++tail) {
+                output.push_back(std::move(records_[tail % N]));
+            }
+            auto count = tail - tail_.load(std::memory_order_relaxed);
+            tail_.store(tail, std::memory_order_release);
+            return count;
+        }
+
+        // Flag if a thread currently writes to this buffer
+        std::atomic<bool> in_use{false};
+
+    private:
+        std::array<T, N> records_{};
+        std::atomic<size_t> head_{0};
+        std::atomic<size_t> tail_{0};
+    };
+
+    /**
+     * @brief State of the background thread and the buffers of all logging threads
+     */
+    template <typename T> struct AsyncSink {
+        using Buffer = RecordBuffer<T, 1024>;
+
+        std::mutex buffers_mutex;
+        std::vector<std::unique_ptr<Buffer>> buffers;
+
+        std::thread thread;
+        std::atomic<bool> running{false};
+
+        // Identifier of the background thread, readable by the logging threads while the thread is started
+        std::atomic<std::thread::id> thread_id;
+
+        // Next sequence number to assign, number of records pushed to the buffers, and number of records written, such
+        // that all records with a lower sequence number have been written
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<uint64_t> pushed{0};
+        std::atomic<uint64_t> written{0};
+
+        // Flag if the background thread waits for new records, only then the logging threads need to wake it
+        std::atomic<bool> sleeping{false};
+        std::mutex wake_mutex;
+        std::condition_variable wake;
+        std::condition_variable flushed;
+
+        // Terminate handler active before the background thread was started
+        std::terminate_handler previous_terminate{nullptr};
+
+        AsyncSink() = default;
+        ~AsyncSink() {
+            // Write remaining records if the logger has not been finished explicitly
+            if(thread.joinable() && std::this_thread::get_id() != thread_id.load()) {
+                running.store(false, std::memory_order_release);
+                notify();
+                thread.join();
+            }
+        }
+        AsyncSink(const AsyncSink&) = delete;
+        AsyncSink& operator=(const AsyncSink&) = delete;
+        AsyncSink(AsyncSink&&) = delete;
+        AsyncSink& operator=(AsyncSink&&) = delete;
+
+        /**
+         * @brief Handle to the buffer of the current thread, returned for reuse when the thread exits
+         */
+        struct Handle {
+            explicit Handle(AsyncSink& sink) {
+                std::lock_guard<std::mutex> lock(sink.buffers_mutex);
+                for(auto& candidate : sink.buffers) {
+                    if(!candidate->in_use.exchange(true, std::memory_order_acquire)) {
+                        buffer = candidate.get();
+                        return;
+                    }
+                }
+                buffer = sink.buffers.emplace_back(std::make_unique<Buffer>()).get();
+                buffer->in_use.store(true, std::memory_order_release);
+            }
+            ~Handle() { buffer->in_use.store(false, std::memory_order_release); }
+
+            Handle(const Handle&) = delete;
+            Handle& operator=(const Handle&) = delete;
+            Handle(Handle&&) = delete;
+            Handle& operator=(Handle&&) = delete;
+
+            Buffer* buffer;
+        };
+
+        /**
+         * @brief Get the buffer of the calling thread
+         * @return Buffer only written by this thread
+         */
+        Buffer& local_buffer() {
+            thread_local Handle handle(*this);
+            return *handle.buffer;
+        }
+
+        /**
+         * @brief Wake the background thread if it waits for new records
+         */
+        void notify() {
+            if(sleeping.load()) {
+                // Taking the mutex ensures the background thread either sees the new state or already waits
+                std::lock_guard<std::mutex> lock(wake_mutex);
+            }
+            wake.notify_one();
+        }
+
+        /**
+         * @brief Wait until all records with a lower sequence number have been written
+         * @param target Sequence number to wait for
+         */
+        void wait_written(uint64_t target) {
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            flushed.wait(lock, [&]() { return written.load() >= target || !running.load(); });
+        }
+    };
+
+    // Sequence number following the last record of the current thread, zero if it has not logged yet
+    thread_local uint64_t next_own_sequence = 0;
+
+} // namespace
+
+// Background thread writing the log records
+template <typename T> static AsyncSink<T>& get_sink() {
+    static AsyncSink<T> sink;
+    return sink;
+}
+
 /**
  * The logger will save the number of uncaught exceptions during construction to compare that with the number of exceptions
  * during destruction later.
@@ -42,6 +200,9 @@ DefaultLogger::DefaultLogger() : exception_count_(std::uncaught_exceptions()) {}
  * The output is written to the streams as soon as the logger gets out-of-scope and destructed. The destructor checks
  * specifically if an exception is thrown while output is written to the stream. In that case the log stream will not be
  * forwarded to the output streams and the message will be discarded.
+ *
+ * In asynchronous mode the record is only handed to the background thread, unless it is a fatal message which is written
+ * before returning.
  */
 DefaultLogger::~DefaultLogger() {
     // Check if an exception is thrown while adding output to the stream
@@ -49,15 +210,124 @@ DefaultLogger::~DefaultLogger() {
         return;
     }
 
-    // TODO [doc] any extra exceptions here need to be caught
+    record_.message = os.str();
+
+    // The background thread itself, e.g. when failing while writing, can only log synchronously
+    auto& sink = get_sink<Record>();
+    if(sink.running.load(std::memory_order_acquire) && std::this_thread::get_id() != sink.thread_id.load()) {
+        record_.sequence = sink.sequence.fetch_add(1);
+        next_own_sequence = record_.sequence + 1;
+        auto fatal = (record_.level == LogLevel::FATAL);
+
+        // Wait for the background thread to make space if the buffer is full
+        auto& buffer = sink.local_buffer();
+        while(!buffer.push(record_)) {
+            sink.notify();
+            std::this_thread::yield();
+        }
+        sink.pushed.fetch_add(1);
+        sink.notify();
+
+        if(fatal) {
+            flush();
+        }
+        return;
+    }
+
+    // Write synchronously
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    write_record(record_, false);
+    for(auto* stream : get_streams()) {
+        stream->flush();
+    }
+}
+
+void DefaultLogger::write_record(const Record& record, bool coalesce) {
+    std::ostringstream header;
+
+    // Add date in all except short format
+    if(record.format != LogFormat::SHORT) {
+        header << "\x1B[1m"; // BOLD
+        header << "|" << get_date(record.time) << "| ";
+        header << "\x1B[0m"; // RESET
+    }
+
+    // Add thread id only in long format
+    if(record.format == LogFormat::LONG) {
+        header << "\x1B[1m"; // BOLD
+        header << "=" << record.thread << "= ";
+        header << "\x1B[0m"; // RESET
+    }
+
+    // Set color for log level
+    if(record.level == LogLevel::FATAL || record.level == LogLevel::ERROR) {
+        header << "\x1B[31;1m"; // RED
+    } else if(record.level == LogLevel::WARNING) {
+        header << "\x1B[33;1m"; // YELLOW
+    } else if(record.level == LogLevel::STATUS) {
+        header << "\x1B[32;1m"; // GREEN
+    } else if(record.level == LogLevel::TRACE || record.level == LogLevel::DEBUG) {
+        header << "\x1B[36m"; // NON-BOLD CYAN
+    } else if(record.level == LogLevel::PRNG) {
+        header << "\x1B[90m"; // NON-BOLD GREY
+    } else {
+        header << "\x1B[36;1m"; // CYAN
+    }
+
+    // Add log level (shortly in the short format)
+    if(record.format != LogFormat::SHORT) {
+        std::string level_str = "(";
+        level_str += getStringFromLevel(record.level);
+        level_str += ")";
+        header << std::setw(9) << level_str << " ";
+    } else {
+        header << "(" << getStringFromLevel(record.level).substr(0, 1) << ") ";
+    }
+    header << "\x1B[0m"; // RESET
+
+    // Add event number if any (shortly in the short format)
+    if(record.event_num != 0) {
+        if(record.format != LogFormat::SHORT) {
+            header << "(Event " << record.event_num << ") ";
+        } else {
+            header << "(E: " << record.event_num << ") ";
+        }
+    }
+
+    // Add section if available
+    if(!record.section.empty()) {
+        header << "\x1B[1m"; // BOLD
+        header << "[" << record.section << "] ";
+        header << "\x1B[0m"; // RESET
+    }
+
+    // Print function name and line number information in debug format
+    if(record.format == LogFormat::LONG) {
+        header << "\x1B[1m"; // BOLD
+        header << "<" << record.file << "/" << record.function << ":L" << record.line << "> ";
+        header << "\x1B[0m"; // RESET
+    }
 
     // Get output string
-    std::string out(os.str());
+    std::string out = header.str();
+
+    // Save the indent count to fix with newlines
+    size_t indent_count = 0;
+    size_t prev = 0, pos = 0;
+    while((pos = out.find("\x1B[", prev)) != std::string::npos) {
+        indent_count += pos - prev;
+        prev = out.find('m', pos) + 1;
+        if(prev == std::string::npos) {
+            break;
+        }
+    }
 
     // Replace every newline by indented code if necessary
-    auto start_pos = out.find('\n');
+    auto start_pos = out.size();
+    out += record.message;
+    start_pos = out.find('\n', start_pos);
     if(start_pos != std::string::npos) {
-        std::string spcs(indent_count_ + 1, ' ');
+        std::string spcs(indent_count + 1, ' ');
         spcs[0] = '\n';
         do {
             out.replace(start_pos, 1, spcs);
@@ -65,12 +335,9 @@ DefaultLogger::~DefaultLogger() {
         } while((start_pos = out.find('\n', start_pos)) != std::string::npos);
     }
 
-    // Lock the mutex to guard last identifier usage
-    std::unique_lock<std::mutex> lock(write_mutex_);
-
     // Add extra spaces if necessary
     size_t extra_spaces = 0;
-    if(!identifier_.empty() && last_identifier_ == identifier_) {
+    if(!record.identifier.empty() && last_identifier_ == record.identifier) {
         // Put carriage return for process logs
         out = '\r' + out;
 
@@ -82,11 +349,13 @@ DefaultLogger::~DefaultLogger() {
         // End process log and continue normal logging
         out = '\n' + out;
     }
-    last_identifier_ = identifier_;
+    last_identifier_ = record.identifier;
 
-    // Save last message
-    last_message_ = out;
-    last_message_ += " ";
+    // Save last message shown on terminals
+    if(!coalesce) {
+        last_message_ = out;
+        last_message_ += " ";
+    }
 
     // Add extra spaces if required
     if(extra_spaces > 0) {
@@ -94,13 +363,13 @@ DefaultLogger::~DefaultLogger() {
     }
 
     // Add final newline if not a progress log
-    if(identifier_.empty()) {
+    if(record.identifier.empty()) {
         out += '\n';
     }
 
     // Create a version without any special terminal characters
     std::string out_no_special;
-    size_t prev = 0, pos = 0;
+    prev = 0;
     while((pos = out.find("\x1B[", prev)) != std::string::npos) {
         out_no_special += out.substr(prev, pos - prev);
         prev = out.find('m', pos) + 1;
@@ -111,21 +380,144 @@ DefaultLogger::~DefaultLogger() {
     out_no_special += out.substr(prev);
 
     // Replace carriage return by newline:
-    try {
-        out_no_special = std::regex_replace(out_no_special, std::regex("\\\r"), "\n");
-    } catch(std::regex_error&) {
-    }
+    std::replace(out_no_special.begin(), out_no_special.end(), '\r', '\n');
 
-    // Print output to streams
+    // Print output to streams, progress messages superseded by the next one are skipped on terminals
     for(auto* stream : get_streams()) {
         if(is_terminal(*stream)) {
-            (*stream) << out;
+            if(!coalesce) {
+                (*stream) << out;
+            }
         } else {
             (*stream) << out_no_special;
         }
-        (*stream).flush();
     }
-    lock.unlock();
+}
+
+/**
+ * Records are collected from the buffers of all threads and written strictly in the order of their sequence numbers. A
+ * thread might be interrupted between taking its sequence number and handing over the record, so records following such a
+ * gap are kept until the missing record arrives. The streams are only flushed once per batch of records.
+ */
+void DefaultLogger::sink_loop() {
+    auto& sink = get_sink<Record>();
+    sink.thread_id.store(std::this_thread::get_id());
+
+    std::vector<Record> pending;
+    uint64_t popped = 0;
+    while(true) {
+        auto stopping = !sink.running.load(std::memory_order_acquire);
+        {
+            std::lock_guard<std::mutex> lock(sink.buffers_mutex);
+            for(auto& buffer : sink.buffers) {
+                popped += buffer->pop_all(pending);
+            }
+        }
+
+        // Select the records continuing the sequence of written records
+        std::sort(
+            pending.begin(), pending.end(), [](const Record& a, const Record& b) { return a.sequence < b.sequence; });
+        auto next = sink.written.load();
+        size_t count = 0;
+        while(count < pending.size() && pending[count].sequence == next + count) {
+            ++count;
+        }
+
+        if(count == 0) {
+            if(stopping && pending.empty() && next == sink.sequence.load()) {
+                break;
+            }
+            if(stopping) {
+                // A record is still being handed over
+                std::this_thread::yield();
+                continue;
+            }
+
+            // Wait until further records are handed over or the logger is stopped
+            std::unique_lock<std::mutex> lock(sink.wake_mutex);
+            sink.sleeping.store(true);
+            sink.wake.wait(lock, [&]() { return sink.pushed.load() > popped || !sink.running.load(); });
+            sink.sleeping.store(false);
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            for(size_t i = 0; i < count; ++i) {
+                auto coalesce = !pending[i].identifier.empty() && i + 1 < count &&
+                                pending[i + 1].identifier == pending[i].identifier;
+                write_record(pending[i], coalesce);
+            }
+            for(auto* stream : get_streams()) {
+                stream->flush();
+            }
+        }
+        pending.erase(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(count));
+
+        {
+            std::lock_guard<std::mutex> lock(sink.wake_mutex);
+            sink.written.store(next + count);
+        }
+        sink.flushed.notify_all();
+    }
+
+    // Release threads waiting for records which will not be written anymore
+    {
+        std::lock_guard<std::mutex> lock(sink.wake_mutex);
+    }
+    sink.flushed.notify_all();
+}
+
+void DefaultLogger::setAsynchronous(bool asynchronous) {
+    auto& sink = get_sink<Record>();
+    if(asynchronous == sink.running.load()) {
+        return;
+    }
+
+    if(asynchronous) {
+        sink.running.store(true, std::memory_order_release);
+        sink.thread = std::thread(&DefaultLogger::sink_loop);
+
+        // Write all pending messages before terminating due to an unhandled exception
+        sink.previous_terminate = std::set_terminate([]() {
+            auto& terminating_sink = get_sink<Record>();
+            if(terminating_sink.running.load() && std::this_thread::get_id() != terminating_sink.thread_id.load()) {
+                terminating_sink.wait_written(terminating_sink.sequence.load());
+            }
+            if(terminating_sink.previous_terminate != nullptr) {
+                terminating_sink.previous_terminate();
+            }
+            std::abort();
+        });
+    } else {
+        // The background thread writes all remaining records before stopping, but cannot wait for itself
+        sink.running.store(false, std::memory_order_release);
+        sink.notify();
+        if(std::this_thread::get_id() != sink.thread_id.load()) {
+            sink.thread.join();
+        } else {
+            sink.thread.detach();
+        }
+        sink.thread_id.store(std::thread::id());
+        std::set_terminate(sink.previous_terminate);
+    }
+}
+
+bool DefaultLogger::isAsynchronous() {
+    return get_sink<Record>().running.load();
+}
+
+/**
+ * Only waits for the messages of the calling thread, all messages logged before by other threads are written before as well
+ * since records are written in order. Returns immediately if called from the background thread.
+ */
+void DefaultLogger::flush() {
+    auto& sink = get_sink<Record>();
+    if(!sink.running.load(std::memory_order_acquire) || std::this_thread::get_id() == sink.thread_id.load()) {
+        return;
+    }
+
+    sink.wait_written(next_own_sequence);
 }
 
 /**
@@ -133,6 +525,9 @@ DefaultLogger::~DefaultLogger() {
  * @note Does not close the streams
  */
 void DefaultLogger::finish() {
+    // Write all pending messages and stop the background thread
+    setAsynchronous(false);
+
     // Lock the mutex to guard output writing
     std::lock_guard<std::mutex> lock(write_mutex_);
 
@@ -160,83 +555,19 @@ void DefaultLogger::finish() {
 
 /**
  * This method is typically automatically called by the \ref LOG macro to return a stream after constructing the logger. The
- * header of the stream is added before returning the output stream.
+ * information required for the header of the message is stored, the header itself is only formatted when writing the
+ * message.
  */
-std::ostringstream&
-DefaultLogger::getStream(LogLevel level, const std::string& file, const std::string& function, uint32_t line) {
-    // Add date in all except short format
-    if(get_format() != LogFormat::SHORT) {
-        os << "\x1B[1m"; // BOLD
-        os << "|" << get_current_date() << "| ";
-        os << "\x1B[0m"; // RESET
-    }
-
-    // Add thread id only in long format
-    if(get_format() == LogFormat::LONG) {
-        os << "\x1B[1m"; // BOLD
-        os << "=" << std::this_thread::get_id() << "= ";
-        os << "\x1B[0m"; // RESET
-    }
-
-    // Set color for log level
-    if(level == LogLevel::FATAL || level == LogLevel::ERROR) {
-        os << "\x1B[31;1m"; // RED
-    } else if(level == LogLevel::WARNING) {
-        os << "\x1B[33;1m"; // YELLOW
-    } else if(level == LogLevel::STATUS) {
-        os << "\x1B[32;1m"; // GREEN
-    } else if(level == LogLevel::TRACE || level == LogLevel::DEBUG) {
-        os << "\x1B[36m"; // NON-BOLD CYAN
-    } else if(level == LogLevel::PRNG) {
-        os << "\x1B[90m"; // NON-BOLD GREY
-    } else {
-        os << "\x1B[36;1m"; // CYAN
-    }
-
-    // Add log level (shortly in the short format)
-    if(get_format() != LogFormat::SHORT) {
-        std::string level_str = "(";
-        level_str += getStringFromLevel(level);
-        level_str += ")";
-        os << std::setw(9) << level_str << " ";
-    } else {
-        os << "(" << getStringFromLevel(level).substr(0, 1) << ") ";
-    }
-    os << "\x1B[0m"; // RESET
-
-    // Add event number if any (shortly in the short format)
-    if(getEventNum() != 0) {
-        if(get_format() != LogFormat::SHORT) {
-            os << "(Event " << getEventNum() << ") ";
-        } else {
-            os << "(E: " << getEventNum() << ") ";
-        }
-    }
-
-    // Add section if available
-    if(!get_section().empty()) {
-        os << "\x1B[1m"; // BOLD
-        os << "[" << get_section() << "] ";
-        os << "\x1B[0m"; // RESET
-    }
-
-    // Print function name and line number information in debug format
-    if(get_format() == LogFormat::LONG) {
-        os << "\x1B[1m"; // BOLD
-        os << "<" << file << "/" << function << ":L" << line << "> ";
-        os << "\x1B[0m"; // RESET
-    }
-
-    // Save the indent count to fix with newlines
-    size_t prev = 0, pos = 0;
-    std::string out = os.str();
-    while((pos = out.find("\x1B[", prev)) != std::string::npos) {
-        indent_count_ += static_cast<unsigned int>(pos - prev);
-        prev = out.find('m', pos) + 1;
-        if(prev == std::string::npos) {
-            break;
-        }
-    }
+std::ostringstream& DefaultLogger::getStream(LogLevel level, const char* file, const char* function, uint32_t line) {
+    record_.level = level;
+    record_.format = get_format();
+    record_.time = std::chrono::system_clock::now();
+    record_.thread = std::this_thread::get_id();
+    record_.event_num = getEventNum();
+    record_.section = get_section();
+    record_.file = file;
+    record_.function = function;
+    record_.line = line;
     return os;
 }
 
@@ -245,7 +576,7 @@ DefaultLogger::getStream(LogLevel level, const std::string& file, const std::str
  * underscore.
  */
 std::ostringstream& DefaultLogger::getProcessStream(
-    std::string identifier, LogLevel level, const std::string& file, const std::string& function, uint32_t line) {
+    std::string identifier, LogLevel level, const char* file, const char* function, uint32_t line) {
     // Get the standard process stream
     std::ostringstream& stream = getStream(level, file, function, line);
 
@@ -253,7 +584,7 @@ std::ostringstream& DefaultLogger::getProcessStream(
     if(identifier.empty()) {
         identifier = "_";
     }
-    identifier_ = std::move(identifier);
+    record_.identifier = std::move(identifier);
 
     return stream;
 }
@@ -353,6 +684,7 @@ std::vector<std::ostream*>& DefaultLogger::get_streams() {
     return streams;
 }
 void DefaultLogger::clearStreams() {
+    std::lock_guard<std::mutex> lock(write_mutex_);
     get_streams().clear();
 }
 /**
@@ -362,6 +694,8 @@ void DefaultLogger::clearStreams() {
  * @note Streams cannot be individually removed at the moment and only all at once using \ref clearStreams().
  */
 void DefaultLogger::addStream(std::ostream& stream) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+
     // Disable cursor if stream supports it
     if(is_terminal(stream)) {
         stream << "\x1B[?25l";
@@ -402,16 +736,15 @@ uint64_t DefaultLogger::getEventNum() {
 /**
  * The date is returned in the hh:mm:ss.ms format
  */
-std::string DefaultLogger::get_current_date() {
-    // FIXME: revise this to get microseconds in a better way
-    auto now = std::chrono::system_clock::now();
-    auto in_time_t = std::chrono::system_clock::to_time_t(now);
+std::string DefaultLogger::get_date(std::chrono::system_clock::time_point time) {
+    auto in_time_t = std::chrono::system_clock::to_time_t(time);
 
     std::stringstream ss;
     ss << std::put_time(std::localtime(&in_time_t), "%X");
 
-    auto seconds_from_epoch = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch());
-    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch() - seconds_from_epoch).count();
+    auto seconds_from_epoch = std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch());
+    auto millis =
+        std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch() - seconds_from_epoch).count();
     ss << ".";
     ss << std::setfill('0') << std::setw(3);
     ss << millis;
@@ -16,11 +16,13 @@
 #define __func__ __FUNCTION__
 #endif
 
+#include <chrono>
 #include <cstring>
 #include <mutex>
 #include <ostream>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace allpix {
@@ -52,6 +54,10 @@ namespace allpix {
      *
      * Should almost never be instantiated directly. The \ref LOG macro should be used instead to pass all the information.
      * This leads to a cleaner interface for sending log messages.
+     *
+     * In asynchronous mode, messages are only captured on the calling thread and handed to a background thread via a
+     * lock-free buffer per thread. The background thread formats and writes the messages, and coalesces consecutive
+     * progress messages on terminals. Fatal messages are always flushed before the logger returns.
      */
     // TODO [DOC] This just be renamed to Log?
     class DefaultLogger {
@@ -89,10 +95,8 @@ namespace allpix {
          * @param line The line number of the log message
          * @return A C++ stream to write to
          */
-        std::ostringstream& getStream(LogLevel level = LogLevel::INFO,
-                                      const std::string& file = "",
-                                      const std::string& function = "",
-                                      uint32_t line = 0);
+        std::ostringstream&
+        getStream(LogLevel level = LogLevel::INFO, const char* file = "", const char* function = "", uint32_t line = 0);
 
         /**
          * @brief Gives a process stream which updates the same line as long as it is the same
@@ -105,8 +109,8 @@ namespace allpix {
          */
         std::ostringstream& getProcessStream(std::string identifier,
                                              LogLevel level = LogLevel::INFO,
-                                             const std::string& file = "",
-                                             const std::string& function = "",
+                                             const char* file = "",
+                                             const char* function = "",
                                              uint32_t line = 0);
 
         /**
@@ -114,6 +118,23 @@ namespace allpix {
          */
         static void finish();
 
+        /**
+         * @brief Enable or disable writing log messages from a background thread
+         * @param asynchronous True to hand messages to the background thread, false to write them on the calling thread
+         * @note All pending messages are written before switching to synchronous logging
+         */
+        static void setAsynchronous(bool asynchronous);
+        /**
+         * @brief Check if log messages are written from a background thread
+         * @return True if asynchronous logging is active, false otherwise
+         */
+        static bool isAsynchronous();
+
+        /**
+         * @brief Wait until all log messages sent so far by the calling thread have been written to the streams
+         */
+        static void flush();
+
         /**
          * @brief Get the reporting level for logging
          * @return The current log level
@@ -201,10 +222,29 @@ namespace allpix {
 
     private:
         /**
-         * @brief Get the current date as a printable string
-         * @return Current date as a string
+         * @brief Log message with all information required to format it
          */
-        std::string get_current_date();
+        struct Record {
+            uint64_t sequence{};
+            LogLevel level{LogLevel::INFO};
+            LogFormat format{LogFormat::DEFAULT};
+            std::chrono::system_clock::time_point time;
+            std::thread::id thread;
+            uint64_t event_num{};
+            std::string section;
+            const char* file{""};
+            const char* function{""};
+            uint32_t line{};
+            std::string identifier;
+            std::string message;
+        };
+
+        /**
+         * @brief Get the given time as a printable string
+         * @param time Time point to print
+         * @return Time as a string
+         */
+        static std::string get_date(std::chrono::system_clock::time_point time);
 
         /**
          * @brief Return if a stream is likely a terminal screen (supporting colors etc.)
@@ -212,13 +252,27 @@ namespace allpix {
          */
         static bool is_terminal(std::ostream& stream);
 
+        /**
+         * @brief Format a record and write it to all streams
+         * @param record Record to write
+         * @param coalesce True if a progress message is superseded by the next one and should not be shown on terminals
+         * @warning The write mutex has to be held by the caller
+         */
+        static void write_record(const Record& record, bool coalesce);
+
+        /**
+         * @brief Main loop of the background thread writing all records handed over by the logging threads
+         */
+        static void sink_loop();
+
         // Output stream
         std::ostringstream os;
 
         // Number of exceptions to prevent abort
         int exception_count_{};
-        // Saved value of the length of the header indent
-        unsigned int indent_count_{};
+
+        // Record of this message, filled when the stream is requested
+        Record record_;
 
         // Internal methods to store static values
         static std::string& get_section();
@@ -227,8 +281,7 @@ namespace allpix {
         static LogFormat& get_format();
         static std::vector<std::ostream*>& get_streams();
 
-        // Name of the process to log or empty if a normal log message
-        std::string identifier_{};
+        // Last message and identifier printed (for identifying process logs)
         static std::string last_message_;
         static std::string last_identifier_;
 
@@ -256,8 +309,7 @@ namespace allpix {
  */
 #define LOG(level)                                                                                                          \
     if(allpix::LogLevel::level <= allpix::Log::getReportingLevel() && !allpix::Log::getStreams().empty())                   \
-    allpix::Log().getStream(                                                                                                \
-        allpix::LogLevel::level, __FILE_NAME__, std::string(static_cast<const char*>(__func__)), __LINE__)
+    allpix::Log().getStream(allpix::LogLevel::level, __FILE_NAME__, static_cast<const char*>(__func__), __LINE__)
 
 /**
  * @brief Create a logging stream that overwrites the line if the previous message has the same identifier
@@ -267,7 +319,7 @@ namespace allpix {
 #define LOG_PROGRESS(level, identifier)                                                                                     \
     if(allpix::LogLevel::level <= allpix::Log::getReportingLevel() && !allpix::Log::getStreams().empty())                   \
     allpix::Log().getProcessStream(                                                                                         \
-        identifier, allpix::LogLevel::level, __FILE_NAME__, std::string(static_cast<const char*>(__func__)), __LINE__)
+        identifier, allpix::LogLevel::level, __FILE_NAME__, static_cast<const char*>(__func__), __LINE__)
 
 /**
  * @brief Create a logging stream if the reporting level is high enough and this message has not yet been logged
@@ -298,8 +350,7 @@ namespace allpix {
     GENERATE_LOG_VAR(max_log_count);                                                                                        \
     if(GET_LOG_VARIABLE() > 0)                                                                                              \
         if(allpix::LogLevel::level <= allpix::Log::getReportingLevel() && !allpix::Log::getStreams().empty())               \
-    allpix::Log().getStream(                                                                                                \
-        allpix::LogLevel::level, __FILE_NAME__, std::string(static_cast<const char*>(__func__)), __LINE__)                  \
+    allpix::Log().getStream(allpix::LogLevel::level, __FILE_NAME__, static_cast<const char*>(__func__), __LINE__)           \
         << ((--GET_LOG_VARIABLE() == 0) ? "[further messages suppressed] " : "")
 
     /**
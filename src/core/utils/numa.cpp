@@ -0,0 +1,211 @@
+/**
+ * @file
+ * @brief Implementation of the NUMA utilities
+ *
+ * @copyright Copyright (c) 2023 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "numa.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "text.h"
+
+using namespace allpix;
+
+thread_local size_t NumaTopology::current_node_{0};
+std::mutex NumaTopology::replicas_mutex_;
+std::map<const void*, std::pair<std::weak_ptr<const void>, std::vector<std::weak_ptr<const void>>>>
+    NumaTopology::replicas_;
+
+/**
+ * @brief Parse a list of CPUs in the format used by the kernel, e.g. "0-3,8,10-11"
+ */
+static std::set<unsigned int> parse_cpu_list(const std::string& list) {
+    std::set<unsigned int> cpus;
+    for(auto& range : split<std::string>(trim(list), ",")) {
+        auto dash = range.find('-');
+        auto first = static_cast<unsigned int>(std::stoul(range.substr(0, dash)));
+        auto last = (dash == std::string::npos ? first : static_cast<unsigned int>(std::stoul(range.substr(dash + 1))));
+        for(auto cpu = first; cpu <= last; ++cpu) {
+            cpus.insert(cpu);
+        }
+    }
+    return cpus;
+}
+
+/**
+ * Only CPUs the process is allowed to run on are taken into account. Nodes without any of these CPUs are skipped.
+ */
+NumaTopology::NumaTopology() {
+    std::set<unsigned int> allowed;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if(sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for(unsigned int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if(CPU_ISSET(cpu, &set)) {
+                allowed.insert(cpu);
+            }
+        }
+    }
+#endif
+    if(allowed.empty()) {
+        for(unsigned int cpu = 0; cpu < std::max(std::thread::hardware_concurrency(), 1u); ++cpu) {
+            allowed.insert(cpu);
+        }
+    }
+
+    // Read the CPUs of every NUMA node
+    std::map<unsigned int, std::vector<unsigned int>> nodes;
+    try {
+        std::filesystem::path node_dir("/sys/devices/system/node");
+        if(std::filesystem::is_directory(node_dir)) {
+            for(const auto& entry : std::filesystem::directory_iterator(node_dir)) {
+                auto name = entry.path().filename().string();
+                if(name.rfind("node", 0) != 0 || name.size() == 4 ||
+                   !std::all_of(name.begin() + 4, name.end(), [](char c) { return std::isdigit(c) != 0; })) {
+                    continue;
+                }
+
+                std::ifstream file(entry.path() / "cpulist");
+                std::string list;
+                if(!std::getline(file, list) || trim(list).empty()) {
+                    continue;
+                }
+                for(auto cpu : parse_cpu_list(list)) {
+                    if(allowed.count(cpu) != 0) {
+                        nodes[static_cast<unsigned int>(std::stoul(name.substr(4)))].push_back(cpu);
+                    }
+                }
+            }
+        }
+    } catch(std::exception&) {
+        // Fall back to a single node if the topology cannot be read
+        nodes.clear();
+    }
+
+    for(auto& [index, cpus] : nodes) {
+        if(!cpus.empty()) {
+            nodes_.push_back(cpus);
+        }
+    }
+    if(nodes_.empty()) {
+        nodes_.emplace_back(allowed.begin(), allowed.end());
+    }
+    for(size_t node = 0; node < nodes_.size(); ++node) {
+        for(auto cpu : nodes_[node]) {
+            cpu_nodes_[cpu] = node;
+        }
+    }
+}
+
+const NumaTopology& NumaTopology::get() {
+    static NumaTopology topology;
+    return topology;
+}
+
+size_t NumaTopology::nodeCount() {
+    return get().nodes_.size();
+}
+
+const std::vector<unsigned int>& NumaTopology::nodeCpus(size_t node) {
+    return get().nodes_.at(node);
+}
+
+std::vector<unsigned int>
+NumaTopology::placeWorkers(const std::string& policy, unsigned int workers, const std::vector<unsigned int>& cpus) {
+    const auto& topology = get();
+
+    std::vector<unsigned int> placement;
+    if(policy == "compact") {
+        // Fill one node after the other
+        std::vector<unsigned int> all_cpus;
+        for(const auto& node : topology.nodes_) {
+            all_cpus.insert(all_cpus.end(), node.begin(), node.end());
+        }
+        for(unsigned int worker = 0; worker < workers; ++worker) {
+            placement.push_back(all_cpus[worker % all_cpus.size()]);
+        }
+    } else if(policy == "scatter") {
+        // Distribute the workers round-robin over the nodes
+        auto node_count = topology.nodes_.size();
+        for(unsigned int worker = 0; worker < workers; ++worker) {
+            const auto& node = topology.nodes_[worker % node_count];
+            placement.push_back(node[(worker / node_count) % node.size()]);
+        }
+    } else if(policy == "list") {
+        if(cpus.empty()) {
+            throw std::invalid_argument("list of CPUs is empty");
+        }
+        for(auto cpu : cpus) {
+            if(topology.cpu_nodes_.count(cpu) == 0) {
+                throw std::invalid_argument("CPU " + std::to_string(cpu) + " is not available");
+            }
+        }
+        for(unsigned int worker = 0; worker < workers; ++worker) {
+            placement.push_back(cpus[worker % cpus.size()]);
+        }
+    } else {
+        throw std::invalid_argument("unknown placement policy '" + policy +
+                                    "', possible values are compact, scatter or list");
+    }
+    return placement;
+}
+
+bool NumaTopology::bindThread(unsigned int cpu) {
+    const auto& topology = get();
+    auto node = topology.cpu_nodes_.find(cpu);
+    if(node == topology.cpu_nodes_.end()) {
+        return false;
+    }
+
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if(pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        return false;
+    }
+    current_node_ = node->second;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool NumaTopology::bindThreadToNode(size_t node) {
+    const auto& topology = get();
+    if(node >= topology.nodes_.size()) {
+        return false;
+    }
+
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(auto cpu : topology.nodes_[node]) {
+        CPU_SET(cpu, &set);
+    }
+    if(pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        return false;
+    }
+    current_node_ = node;
+    return true;
+#else
+    return false;
+#endif
+}
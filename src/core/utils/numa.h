@@ -0,0 +1,151 @@
+/**
+ * @file
+ * @brief Utilities to place threads and data onto the NUMA nodes of the system
+ *
+ * @copyright Copyright (c) 2023 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_NUMA_H
+#define ALLPIX_NUMA_H
+
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace allpix {
+
+    /**
+     * @brief Topology of the CPUs and NUMA nodes available to the process
+     *
+     * The topology is read once from the system. On systems without NUMA information, all CPUs available to the process are
+     * assigned to a single node. Binding threads to CPUs is only supported on Linux, on other systems threads are left
+     * unbound.
+     */
+    class NumaTopology {
+    public:
+        /**
+         * @brief Get the number of NUMA nodes with CPUs available to the process
+         * @return Number of nodes, at least one
+         */
+        static size_t nodeCount();
+
+        /**
+         * @brief Get the CPUs available to the process on a NUMA node
+         * @param node Index of the node
+         * @return List of CPU identifiers
+         */
+        static const std::vector<unsigned int>& nodeCpus(size_t node);
+
+        /**
+         * @brief Assign a CPU to every worker thread following a placement policy
+         * @param policy Either "compact" to fill one node after the other, "scatter" to distribute workers round-robin over
+         * the nodes, or "list" to use the provided CPUs
+         * @param workers Number of workers to place
+         * @param cpus List of CPUs to use for the "list" policy, assigned in order to the workers
+         * @return CPU identifier for every worker
+         * @throws std::invalid_argument If the policy is unknown or a requested CPU is not available to the process
+         */
+        static std::vector<unsigned int>
+        placeWorkers(const std::string& policy, unsigned int workers, const std::vector<unsigned int>& cpus = {});
+
+        /**
+         * @brief Bind the calling thread to a CPU and remember the NUMA node it is placed on
+         * @param cpu CPU identifier
+         * @return True if the thread has been bound, false if binding is not supported or failed
+         */
+        static bool bindThread(unsigned int cpu);
+
+        /**
+         * @brief Bind the calling thread to all CPUs of a NUMA node
+         * @param node Index of the node
+         * @return True if the thread has been bound, false if binding is not supported or failed
+         */
+        static bool bindThreadToNode(size_t node);
+
+        /**
+         * @brief Get the NUMA node the calling thread has been bound to
+         * @return Index of the node, zero for threads which have not been bound
+         */
+        static size_t currentNode() { return current_node_; }
+
+        /**
+         * @brief Create a copy of an object on every NUMA node
+         * @param original Object to copy
+         * @return Copies of the object indexed by NUMA node, allocated by a thread bound to the respective node
+         *
+         * The memory of every copy is touched first by a thread bound to the respective node, such that the operating
+         * system places it on that node. Repeated requests for the same object return the same copies as long as they are
+         * still in use, the copies are not kept alive by this cache.
+         */
+        template <typename T> static std::vector<std::shared_ptr<const T>> replicate(const std::shared_ptr<T>& original);
+
+    private:
+        NumaTopology();
+        static const NumaTopology& get();
+
+        std::vector<std::vector<unsigned int>> nodes_;
+        std::map<unsigned int, size_t> cpu_nodes_;
+
+        static thread_local size_t current_node_;
+
+        static std::mutex replicas_mutex_;
+        static std::map<const void*, std::pair<std::weak_ptr<const void>, std::vector<std::weak_ptr<const void>>>>
+            replicas_;
+    };
+
+    template <typename T>
+    std::vector<std::shared_ptr<const T>> NumaTopology::replicate(const std::shared_ptr<T>& original) {
+        std::lock_guard<std::mutex> lock(replicas_mutex_);
+
+        // Forget objects which have been released in the meantime
+        for(auto iter = replicas_.begin(); iter != replicas_.end();) {
+            iter = (iter->second.first.expired() ? replicas_.erase(iter) : std::next(iter));
+        }
+
+        // Return earlier copies if the object is still the same and all copies are still in use
+        std::vector<std::shared_ptr<const T>> copies;
+        auto iter = replicas_.find(original.get());
+        if(iter != replicas_.end() && iter->second.first.lock() == original) {
+            for(auto& copy : iter->second.second) {
+                auto shared_copy = copy.lock();
+                if(shared_copy == nullptr) {
+                    copies.clear();
+                    break;
+                }
+                copies.push_back(std::static_pointer_cast<const T>(shared_copy));
+            }
+            if(!copies.empty()) {
+                return copies;
+            }
+        }
+
+        // Copy the object from a thread bound to every node
+        copies.resize(nodeCount());
+        std::vector<std::thread> threads;
+        for(size_t node = 0; node < copies.size(); ++node) {
+            threads.emplace_back([&copies, &original, node]() {
+                bindThreadToNode(node);
+                copies[node] = std::make_shared<const T>(*original);
+            });
+        }
+        for(auto& thread : threads) {
+            thread.join();
+        }
+
+        auto& entry = replicas_[original.get()];
+        entry.first = original;
+        entry.second.assign(copies.begin(), copies.end());
+        return copies;
+    }
+} // namespace allpix
+
+#endif /* ALLPIX_NUMA_H */
@@ -82,11 +82,58 @@ void CorryvreckanWriterModule::initialize() {
     time_ = 0;
 }
 
-// Make instantiations of Corryvreckan pixels, and store these in the trees during run time
+// Make instantiations of Corryvreckan pixels and MC particles, timestamps relative to the start of the event
+void CorryvreckanWriterModule::prepare(Event* event) {
+    auto pixel_messages = messenger_->fetchMultiMessage<PixelHitMessage>(this, event);
+
+    auto prepared = std::make_shared<PreparedEvent>();
+
+    // Loop through all received messages
+    for(auto& message : pixel_messages) {
+
+        auto detector_name = message->getDetector()->getName();
+        LOG(DEBUG) << "Received " << message->getData().size() << " pixel hits from detector " << detector_name;
+
+        auto& prepared_detector = prepared->emplace_back();
+        prepared_detector.name = detector_name;
+
+        // Fill the branch vector
+        for(const auto& apx_pixel : message->getData()) {
+            prepared_detector.pixels.push_back(std::make_unique<corryvreckan::Pixel>(
+                detector_name,
+                apx_pixel.getPixel().getIndex().X(),
+                apx_pixel.getPixel().getIndex().Y(),
+                static_cast<int>(apx_pixel.getSignal()),
+                apx_pixel.getSignal(),
+                (timing_global_ ? apx_pixel.getGlobalTime() : apx_pixel.getLocalTime())));
+
+            // If writing MC truth then also write out associated particle info
+            if(!output_mc_truth_) {
+                continue;
+            }
+
+            // Get all associated particles
+            auto mcp = apx_pixel.getMCParticles();
+            LOG(DEBUG) << "Received " << mcp.size() << " Monte Carlo particles from pixel hit";
+            for(auto& particle : mcp) {
+                prepared_detector.particles.push_back(std::make_unique<corryvreckan::MCParticle>(
+                    detector_name,
+                    particle->getParticleID(),
+                    particle->getLocalStartPoint(),
+                    particle->getLocalEndPoint(),
+                    (timing_global_ ? particle->getGlobalTime() : particle->getLocalTime())));
+            }
+        }
+    }
+
+    store_prepared(event, std::move(prepared));
+}
+
+// Store the prepared objects in the trees in sequence
 void CorryvreckanWriterModule::run(Event* event) {
-    auto root_lock = root_process_lock();
+    auto prepared = take_prepared<std::shared_ptr<PreparedEvent>>(event);
 
-    auto pixel_messages = messenger_->fetchMultiMessage<PixelHitMessage>(this, event);
+    auto root_lock = root_process_lock();
 
     // Retrieve current object count:
     auto object_count = TProcessID::GetObjectCount();
@@ -102,12 +149,8 @@ void CorryvreckanWriterModule::run(Event* event) {
     // Events start with 1, pre-filling only with empty events before:
     auto event_id = event->number - 1;
 
-    // Loop through all received messages
-    for(auto& message : pixel_messages) {
-
-        auto detector_name = message->getDetector()->getName();
-        LOG(DEBUG) << "Received " << message->getData().size() << " pixel hits from detector " << detector_name;
-
+    for(auto& prepared_detector : *prepared) {
+        const auto& detector_name = prepared_detector.name;
         if(write_list_px_.find(detector_name) == write_list_px_.end()) {
             write_list_px_[detector_name] = new std::vector<corryvreckan::Pixel*>();
             pixel_tree_->Bronch(detector_name.c_str(),
@@ -141,33 +184,19 @@ void CorryvreckanWriterModule::run(Event* event) {
             }
         }
 
-        // Fill the branch vector
-        for(const auto& apx_pixel : message->getData()) {
-            auto* corry_pixel = new corryvreckan::Pixel(
-                detector_name,
-                apx_pixel.getPixel().getIndex().X(),
-                apx_pixel.getPixel().getIndex().Y(),
-                static_cast<int>(apx_pixel.getSignal()),
-                apx_pixel.getSignal(),
-                (timing_global_ ? event_->start() + apx_pixel.getGlobalTime() : apx_pixel.getLocalTime()));
-            write_list_px_[detector_name]->push_back(corry_pixel);
-
-            // If writing MC truth then also write out associated particle info
-            if(!output_mc_truth_) {
-                continue;
+        // Global timestamps are only known relative to the event until the event time is assigned in sequence
+        for(auto& pixel : prepared_detector.pixels) {
+            if(timing_global_) {
+                pixel->setTimestamp(event_->start() + pixel->timestamp());
             }
-
-            // Get all associated particles
-            auto mcp = apx_pixel.getMCParticles();
-            LOG(DEBUG) << "Received " << mcp.size() << " Monte Carlo particles from pixel hit";
-            for(auto& particle : mcp) {
-                auto* mcParticle = new corryvreckan::MCParticle(
-                    detector_name,
-                    particle->getParticleID(),
-                    particle->getLocalStartPoint(),
-                    particle->getLocalEndPoint(),
-                    (timing_global_ ? event_->start() + particle->getGlobalTime() : particle->getLocalTime()));
-                write_list_mcp_[detector_name]->push_back(mcParticle);
+            write_list_px_[detector_name]->push_back(pixel.release());
+        }
+        if(output_mc_truth_) {
+            for(auto& particle : prepared_detector.particles) {
+                if(timing_global_) {
+                    particle->setTimestamp(event_->start() + particle->timestamp());
+                }
+                write_list_mcp_[detector_name]->push_back(particle.release());
             }
         }
     }
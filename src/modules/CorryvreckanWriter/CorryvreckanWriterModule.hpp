@@ -52,7 +52,12 @@ namespace allpix {
         void initialize() override;
 
         /**
-         * @brief Take the digitised pixel hits and write them into the output file
+         * @brief Convert the digitised pixel hits into Corryvreckan objects
+         */
+        void prepare(Event* event) override;
+
+        /**
+         * @brief Write the converted pixel hits into the output file
          */
         void run(Event* event) override;
 
@@ -84,5 +89,13 @@ namespace allpix {
         std::unique_ptr<TTree> mcparticle_tree_;
         std::map<std::string, std::vector<corryvreckan::Pixel*>*> write_list_px_;
         std::map<std::string, std::vector<corryvreckan::MCParticle*>*> write_list_mcp_;
+
+        // Converted objects of an event waiting to be written, global timestamps relative to the event start
+        struct PreparedDetector {
+            std::string name;
+            std::vector<std::unique_ptr<corryvreckan::Pixel>> pixels;
+            std::vector<std::unique_ptr<corryvreckan::MCParticle>> particles;
+        };
+        using PreparedEvent = std::vector<PreparedDetector>;
     };
 } // namespace allpix
@@ -11,6 +11,12 @@
 
 #include "DefaultDigitizerModule.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory_resource>
+#include <vector>
+
 #include "core/utils/distributions.h"
 #include "core/utils/unit.h"
 #include "objects/PixelHit.hpp"
@@ -43,6 +49,10 @@ DefaultDigitizerModule::DefaultDigitizerModule(Configuration& config,
     if(!config_.has("gain_function")) {
         config_.setDefault<double>("gain", 1.0);
     }
+    config_.setDefault<bool>("tabulate_gain", false);
+    config_.setDefault<ROOT::Math::XYVector>("gain_table_range",
+                                             ROOT::Math::XYVector(Units::get(-10, "ke"), Units::get(500, "ke")));
+    config_.setDefault<double>("gain_table_precision", 1e-6);
 
     config_.setDefault<int>("threshold", Units::get(600, "e"));
     config_.setDefault<int>("threshold_smearing", Units::get(30, "e"));
@@ -105,6 +115,8 @@ DefaultDigitizerModule::DefaultDigitizerModule(Configuration& config,
         gain_function_->SetParameter(0, config_.get<double>("gain"));
     }
 
+    tabulate_gain_ = config_.get<bool>("tabulate_gain");
+
     saturation_ = config_.get<bool>("saturation");
     saturation_mean_ = config_.get<unsigned int>("saturation_mean");
     saturation_width_ = config_.get<unsigned int>("saturation_width");
@@ -142,6 +154,10 @@ void DefaultDigitizerModule::initialize() {
                   << ((1 << tdc_resolution_) - 1);
     }
 
+    if(tabulate_gain_) {
+        tabulate_gain_function();
+    }
+
     if(output_plots_) {
         LOG(TRACE) << "Creating output plots";
 
@@ -215,24 +231,107 @@ void DefaultDigitizerModule::initialize() {
     }
 }
 
+void DefaultDigitizerModule::tabulate_gain_function() {
+    auto range = config_.get<ROOT::Math::XYVector>("gain_table_range");
+    auto precision = config_.get<double>("gain_table_precision");
+    if(range.x() >= range.y()) {
+        throw InvalidValueError(config_, "gain_table_range", "lower boundary has to be smaller than upper boundary");
+    }
+    if(precision <= 0) {
+        throw InvalidValueError(config_, "gain_table_precision", "precision has to be positive");
+    }
+
+    // Refine an equidistant grid until linear interpolation reproduces the gain function at all interval centers within
+    // the requested relative precision. An absolute floor of one electron avoids excessive refinement around zero.
+    constexpr size_t max_table_size = 1 << 20;
+    for(size_t intervals = 256; intervals <= max_table_size; intervals *= 2) {
+        auto step = (range.y() - range.x()) / static_cast<double>(intervals);
+        std::vector<double> table(intervals + 1);
+        bool valid = true;
+        for(size_t i = 0; i <= intervals && valid; ++i) {
+            table[i] = gain_function_->Eval(range.x() + step * static_cast<double>(i));
+            valid = std::isfinite(table[i]);
+        }
+
+        double max_deviation = 0;
+        for(size_t i = 0; i < intervals && valid; ++i) {
+            auto exact = gain_function_->Eval(range.x() + step * (static_cast<double>(i) + 0.5));
+            valid = std::isfinite(exact);
+            max_deviation =
+                std::max(max_deviation, std::abs((table[i] + table[i + 1]) / 2 - exact) / std::max(std::abs(exact), 1.));
+        }
+        if(!valid) {
+            break;
+        }
+
+        if(max_deviation <= precision) {
+            gain_table_ = std::move(table);
+            gain_table_min_ = range.x();
+            gain_table_max_ = range.y();
+            gain_table_step_ = step;
+            LOG(INFO) << "Tabulated gain function between " << Units::display(range.x(), {"e", "ke"}) << " and "
+                      << Units::display(range.y(), {"e", "ke"}) << " with " << gain_table_.size()
+                      << " nodes, maximum relative deviation " << max_deviation;
+            return;
+        }
+    }
+
+    LOG(WARNING) << "Gain function cannot be tabulated within the requested precision in the given range, evaluating it "
+                    "directly for every pixel";
+}
+
+double DefaultDigitizerModule::gain(double charge) const {
+    if(gain_table_.empty() || charge < gain_table_min_ || charge >= gain_table_max_) {
+        return gain_function_->Eval(charge);
+    }
+
+    auto position = (charge - gain_table_min_) / gain_table_step_;
+    auto bin = static_cast<size_t>(position);
+    auto fraction = position - static_cast<double>(bin);
+    return gain_table_[bin] + fraction * (gain_table_[bin + 1] - gain_table_[bin]);
+}
+
 void DefaultDigitizerModule::run(Event* event) {
     auto pixel_message = messenger_->fetchMessage<PixelChargeMessage>(this, event);
-
-    // Loop through all pixels with charges
-    std::vector<PixelHit> hits;
-    for(const auto& pixel_charge : pixel_message->getData()) {
-        auto pixel = pixel_charge.getPixel();
-        auto pixel_index = pixel.getIndex();
+    const auto& pixel_charges = pixel_message->getData();
+    auto& random_generator = event->getRandomEngine();
+
+    // Distributions are shared by all pixels of this event
+    allpix::normal_distribution<double> el_noise(0, electronics_noise_);
+    allpix::normal_distribution<double> saturation_smearing(saturation_mean_, saturation_width_);
+    allpix::normal_distribution<double> thr_smearing(threshold_, threshold_smearing_);
+    allpix::normal_distribution<double> adc_smearing(0, qdc_smearing_);
+    allpix::normal_distribution<double> tdc_smearing(0, tdc_smearing_);
+
+    auto elapsed = [](auto start, auto end) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    };
+
+    // Stage 1: analog front-end (noise, gain, saturation and threshold) for all pixels. Random numbers are drawn per pixel
+    // in a fixed order, including the QDC and TDC smearing of selected pixels, to keep the results independent of batching
+    auto stage_start = std::chrono::steady_clock::now();
+
+    auto* memory = event->getScratchResource();
+    std::pmr::vector<size_t> selected(memory);
+    std::pmr::vector<double> charges(memory), thresholds(memory), qdc_noise(memory), tdc_noise(memory);
+    selected.reserve(pixel_charges.size());
+    charges.reserve(pixel_charges.size());
+    thresholds.reserve(pixel_charges.size());
+    qdc_noise.reserve(pixel_charges.size());
+    tdc_noise.reserve(pixel_charges.size());
+
+    for(size_t i = 0; i < pixel_charges.size(); ++i) {
+        const auto& pixel_charge = pixel_charges[i];
         auto charge = static_cast<double>(pixel_charge.getAbsoluteCharge());
 
-        LOG(DEBUG) << "Received pixel " << pixel_index << ", (absolute) charge " << Units::display(charge, "e");
+        LOG(DEBUG) << "Received pixel " << pixel_charge.getPixel().getIndex() << ", (absolute) charge "
+                   << Units::display(charge, "e");
         if(output_plots_) {
             h_pxq->Fill(charge / 1e3);
         }
 
         // Add electronics noise from Gaussian:
-        allpix::normal_distribution<double> el_noise(0, electronics_noise_);
-        charge += el_noise(event->getRandomEngine());
+        charge += el_noise(random_generator);
 
         LOG(DEBUG) << "Charge with noise: " << Units::display(charge, "e");
         if(output_plots_) {
@@ -241,7 +340,7 @@ void DefaultDigitizerModule::run(Event* event) {
 
         // Apply the gain to the charge:
         auto charge_pregain = charge;
-        charge = gain_function_->Eval(charge);
+        charge = gain(charge);
         LOG(DEBUG) << "Charge after amplifier (gain): " << Units::display(charge, "e");
         if(output_plots_) {
             // Calculate gain from pre- and post-charge, offset to avoid zero-division:
@@ -251,8 +350,7 @@ void DefaultDigitizerModule::run(Event* event) {
 
         // Simulate simple front-end saturation if enabled:
         if(saturation_) {
-            allpix::normal_distribution<double> saturation_smearing(saturation_mean_, saturation_width_);
-            auto saturation = saturation_smearing(event->getRandomEngine());
+            auto saturation = saturation_smearing(random_generator);
             if(charge > saturation) {
                 LOG(DEBUG) << "Above front-end saturation, " << Units::display(charge, {"e", "ke"}) << " > "
                            << Units::display(saturation, {"e", "ke"}) << ", setting to saturation value";
@@ -265,8 +363,7 @@ void DefaultDigitizerModule::run(Event* event) {
         }
 
         // Smear the threshold, Gaussian distribution around "threshold" with width "threshold_smearing"
-        allpix::normal_distribution<double> thr_smearing(threshold_, threshold_smearing_);
-        double threshold = thr_smearing(event->getRandomEngine());
+        double threshold = thr_smearing(random_generator);
         if(output_plots_) {
             h_thr->Fill(threshold / 1e3);
         }
@@ -283,34 +380,58 @@ void DefaultDigitizerModule::run(Event* event) {
             h_pxq_thr->Fill(charge / 1e3);
         }
 
-        // Simulate QDC if resolution set to more than 0bit
-        if(qdc_resolution_ > 0) {
+        selected.push_back(i);
+        charges.push_back(charge);
+        thresholds.push_back(threshold);
+        qdc_noise.push_back(qdc_resolution_ > 0 ? adc_smearing(random_generator) : 0.);
+        tdc_noise.push_back(tdc_resolution_ > 0 ? tdc_smearing(random_generator) : 0.);
+    }
+
+    auto stage_end = std::chrono::steady_clock::now();
+    time_frontend_ += elapsed(stage_start, stage_end);
+
+    // Stage 2: QDC smearing and quantization of all selected pixels
+    stage_start = stage_end;
+    if(qdc_resolution_ > 0) {
+        for(size_t n = 0; n < selected.size(); ++n) {
             // temporarily store old charge for histogramming:
-            auto original_charge = charge;
+            auto original_charge = charges[n];
 
             // Add ADC smearing:
-            allpix::normal_distribution<double> adc_smearing(0, qdc_smearing_);
-            charge += adc_smearing(event->getRandomEngine());
+            auto charge = original_charge + qdc_noise[n];
             if(output_plots_) {
                 h_pxq_adc_smear->Fill(charge / 1e3);
             }
             LOG(DEBUG) << "Smeared for simulating limited QDC sensitivity: " << Units::display(charge, "e");
 
             // Convert to ADC units and precision, make sure ADC count is at least 1:
-            charge = static_cast<double>(std::clamp(static_cast<int>((qdc_offset_ + charge) / qdc_slope_),
-                                                    (allow_zero_qdc_ ? 0 : 1),
-                                                    (1 << qdc_resolution_) - 1));
-            LOG(DEBUG) << "Charge converted to QDC units: " << charge;
+            charges[n] = static_cast<double>(std::clamp(static_cast<int>((qdc_offset_ + charge) / qdc_slope_),
+                                                        (allow_zero_qdc_ ? 0 : 1),
+                                                        (1 << qdc_resolution_) - 1));
+            LOG(DEBUG) << "Charge converted to QDC units: " << charges[n];
 
             if(output_plots_) {
-                h_calibration->Fill(original_charge / 1e3, charge);
-                h_pxq_adc->Fill(charge);
+                h_calibration->Fill(original_charge / 1e3, charges[n]);
+                h_pxq_adc->Fill(charges[n]);
             }
-        } else if(output_plots_) {
+        }
+    } else if(output_plots_) {
+        for(auto charge : charges) {
             h_pxq_adc->Fill(charge / 1e3);
         }
+    }
 
-        auto time = time_of_arrival(pixel_charge, threshold);
+    stage_end = std::chrono::steady_clock::now();
+    time_qdc_ += elapsed(stage_start, stage_end);
+
+    // Stage 3: time-of-arrival, TDC smearing and quantization of all selected pixels
+    stage_start = stage_end;
+    std::vector<PixelHit> hits;
+    hits.reserve(selected.size());
+    for(size_t n = 0; n < selected.size(); ++n) {
+        const auto& pixel_charge = pixel_charges[selected[n]];
+
+        auto time = time_of_arrival(pixel_charge, thresholds[n]);
         LOG(DEBUG) << "Local time of arrival: " << Units::display(time, {"ns", "ps"});
         if(output_plots_) {
             h_px_toa->Fill(time);
@@ -322,8 +443,7 @@ void DefaultDigitizerModule::run(Event* event) {
         // Simulate TDC if resolution set to more than 0bit
         if(tdc_resolution_ > 0) {
             // Add TDC smearing:
-            allpix::normal_distribution<double> tdc_smearing(0, tdc_smearing_);
-            time += tdc_smearing(event->getRandomEngine());
+            time += tdc_noise[n];
             if(output_plots_) {
                 h_px_tdc_smear->Fill(time);
             }
@@ -343,9 +463,13 @@ void DefaultDigitizerModule::run(Event* event) {
         }
 
         // Add the hit to the hitmap
-        hits.emplace_back(pixel, time, pixel_charge.getGlobalTime() + original_time, charge, &pixel_charge);
+        hits.emplace_back(
+            pixel_charge.getPixel(), time, pixel_charge.getGlobalTime() + original_time, charges[n], &pixel_charge);
     }
 
+    stage_end = std::chrono::steady_clock::now();
+    time_tdc_ += elapsed(stage_start, stage_end);
+
     // Output summary and update statistics
     LOG(INFO) << "Digitized " << hits.size() << " pixel hits";
     total_hits_ += hits.size();
@@ -407,4 +531,7 @@ void DefaultDigitizerModule::finalize() {
     }
 
     LOG(INFO) << "Digitized " << total_hits_ << " pixel hits in total";
+    LOG(INFO) << "Time spent in digitization stages: front-end " << Units::display(time_frontend_.load(), {"s", "ms", "us"})
+              << ", QDC " << Units::display(time_qdc_.load(), {"s", "ms", "us"}) << ", ToA and TDC "
+              << Units::display(time_tdc_.load(), {"s", "ms", "us"});
 }
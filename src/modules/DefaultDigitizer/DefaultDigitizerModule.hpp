@@ -12,8 +12,10 @@
 #ifndef ALLPIX_DEFAULT_DIGITIZER_MODULE_H
 #define ALLPIX_DEFAULT_DIGITIZER_MODULE_H
 
+#include <atomic>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "core/config/Configuration.hpp"
 #include "core/messenger/Messenger.hpp"
@@ -74,11 +76,26 @@ namespace allpix {
          */
         double time_of_arrival(const PixelCharge& pixel_charge, double threshold) const;
 
+        /**
+         * @brief Tabulate the gain function on an equidistant grid refined until the requested precision is reached
+         */
+        void tabulate_gain_function();
+
+        /**
+         * @brief Helper function to apply the gain, interpolating the tabulated gain function where available
+         * @param  charge Input charge before amplification
+         * @return        Charge after amplification
+         */
+        double gain(double charge) const;
+
         // Configuration
         bool output_plots_{};
 
         unsigned int electronics_noise_{};
         std::unique_ptr<TFormula> gain_function_{};
+        bool tabulate_gain_{};
+        std::vector<double> gain_table_;
+        double gain_table_min_{}, gain_table_max_{}, gain_table_step_{};
 
         bool saturation_{};
         unsigned int saturation_mean_{}, saturation_width_{};
@@ -99,6 +116,7 @@ namespace allpix {
 
         // Statistics
         std::atomic<unsigned long long> total_hits_{};
+        std::atomic<uint64_t> time_frontend_{}, time_qdc_{}, time_tdc_{};
 
         // Output histograms
         Histogram<TH1D> h_pxq, h_pxq_noise, h_gain, h_pxq_gain, h_thr, h_pxq_thr, h_pxq_sat, h_pxq_adc_smear, h_pxq_adc,
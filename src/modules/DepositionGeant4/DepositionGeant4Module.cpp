@@ -12,7 +12,12 @@
 
 #include "DepositionGeant4Module.hpp"
 
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
 #include <limits>
+#include <random>
+#include <sstream>
 #include <string>
 #include <utility>
 
@@ -21,6 +26,7 @@
 #include <G4HadronicParameters.hh>
 #include <G4HadronicProcessStore.hh>
 #include <G4LogicalVolume.hh>
+#include <G4Material.hh>
 #include <G4NuclearLevelData.hh>
 #include <G4PhysListFactory.hh>
 #include <G4ProcessTable.hh>
@@ -28,6 +34,7 @@
 #include <G4StepLimiterPhysics.hh>
 #include <G4UImanager.hh>
 #include <G4UserLimits.hh>
+#include <G4Version.hh>
 #include <G4DecayPhysics.hh>
 #include "UCNModularPhysicsList.hpp"
 
@@ -85,6 +92,12 @@ DepositionGeant4Module::DepositionGeant4Module(Configuration& config, Messenger*
     // By default, only record MCTracks connected to MCParticles in the sensitive volume
     config_.setDefault<bool>("record_all_tracks", false);
 
+    // Merging of deposits is disabled by default
+    config_.setDefault<bool>("cluster_deposits", false);
+    config_.setDefault<ROOT::Math::XYZVector>(
+        "cluster_voxel_size", ROOT::Math::XYZVector(Units::get(5.0, "um"), Units::get(5.0, "um"), Units::get(5.0, "um")));
+    config_.setDefault<double>("cluster_time_window", Units::get(0.1, "ns"));
+
     // Defaults for energy deposition in implants
     config_.setDefault<bool>("deposit_in_frontside_implants", true);
     config_.setDefault<bool>("deposit_in_backside_implants", false);
@@ -228,6 +241,34 @@ void DepositionGeant4Module::initialize() {
     }
     physicsList->SetDefaultCutValue(production_cut);
 
+    // Retrieve the physics tables from the cache if they have been stored for the same inputs before
+    std::filesystem::path physics_table_dir;
+    std::string physics_table_inputs;
+    bool physics_tables_retrieved = false;
+    if(config_.has("physics_table_cache")) {
+        physics_table_inputs = physics_table_description(production_cut);
+
+        // Identify the cache entry by the FNV-1a hash of the description
+        uint64_t hash = 14695981039346656037ULL;
+        for(auto c : physics_table_inputs) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+        }
+        std::stringstream entry;
+        entry << std::hex << std::setw(16) << std::setfill('0') << hash;
+        physics_table_dir = config_.getPath("physics_table_cache") / entry.str();
+
+        std::ifstream description_file(physics_table_dir / "description.txt");
+        std::stringstream stored_inputs;
+        stored_inputs << description_file.rdbuf();
+        if(description_file && stored_inputs.str() == physics_table_inputs) {
+            LOG(INFO) << "Retrieving G4 physics tables from cache at " << physics_table_dir;
+            physicsList->SetPhysicsTableRetrieved(physics_table_dir.string());
+            physics_tables_retrieved = true;
+        } else {
+            LOG(INFO) << "No G4 physics tables found in cache, tables will be stored at " << physics_table_dir;
+        }
+    }
+
     // Set minimum remaining kinetic energy for a track
     double min_charge_creation_energy{};
     
@@ -311,10 +352,94 @@ void DepositionGeant4Module::initialize() {
         run_manager_mt->SetSDAndFieldConstruction(std::move(detector_construction));
     }
 
+    // Store the physics tables for later runs
+    if(!physics_table_dir.empty() && !physics_tables_retrieved) {
+        store_physics_tables(physicsList, physics_table_dir, physics_table_inputs);
+    }
+
     // Flush the Geant4 stream buffer because some elements in the initialization never do:
     G4cout << G4endl;
 }
 
+/**
+ * The physics tables depend on the selected physics list and its options, the production cuts, the materials in the
+ * geometry, the Geant4 version and the data sets it reads. Geant4 verifies the consistency of the stored cuts and materials
+ * when retrieving the tables, the description serves to never select an entry built from different inputs.
+ */
+std::string DepositionGeant4Module::physics_table_description(double production_cut) const {
+    std::stringstream description;
+    description << std::setprecision(std::numeric_limits<double>::max_digits10);
+    description << "geant4 " << G4VERSION_NUMBER << "\n";
+    description << "physics_list " << config_.get<std::string>("physics_list") << "\n";
+    if(config_.get<bool>("enable_pai", false)) {
+        description << "pai_model " << allpix::transform(config_.get<std::string>("pai_model"), ::tolower) << "\n";
+    }
+    description << "production_cut " << production_cut << "\n";
+
+    for(const auto* material : *G4Material::GetMaterialTable()) {
+        description << "material " << material->GetName() << " " << material->GetDensity() << " "
+                    << material->GetTemperature() << " " << material->GetPressure();
+        for(size_t i = 0; i < material->GetNumberOfElements(); ++i) {
+            description << " " << material->GetElement(static_cast<G4int>(i))->GetName() << " "
+                        << material->GetFractionVector()[i];
+        }
+        description << "\n";
+    }
+
+    for(const auto* dataset : {"G4LEDATA",
+                               "G4LEVELGAMMADATA",
+                               "G4NEUTRONXSDATA",
+                               "G4PARTICLEXSDATA",
+                               "G4PIIDATA",
+                               "G4RADIOACTIVEDATA",
+                               "G4ENSDFSTATEDATA",
+                               "G4SAIDXSDATA",
+                               "G4ABLADATA",
+                               "G4INCLDATA"}) {
+        const auto* path = std::getenv(dataset);
+        description << dataset << " " << (path == nullptr ? "" : path) << "\n";
+    }
+    return description.str();
+}
+
+/**
+ * The tables are written to a temporary directory which is renamed to the final entry afterwards. Simulations started in
+ * parallel with the same inputs thus never read incomplete tables, and only the first one finishing provides the entry.
+ */
+void DepositionGeant4Module::store_physics_tables(G4VUserPhysicsList* physics_list,
+                                                  const std::filesystem::path& directory,
+                                                  const std::string& description) {
+    // Without multithreading, the tables are only built when the first run starts
+    if(!multithreadingEnabled()) {
+        run_manager_g4_->BeamOn(0);
+    }
+
+    try {
+        std::random_device random_device;
+        auto temporary_dir = directory;
+        temporary_dir += ".tmp" + std::to_string(random_device());
+        std::filesystem::create_directories(temporary_dir);
+
+        if(!physics_list->StorePhysicsTable(temporary_dir.string())) {
+            std::filesystem::remove_all(temporary_dir);
+            LOG(WARNING) << "Could not store G4 physics tables in cache at " << directory;
+            return;
+        }
+        std::ofstream(temporary_dir / "description.txt") << description;
+
+        std::error_code error;
+        std::filesystem::rename(temporary_dir, directory, error);
+        if(error) {
+            // Another simulation already provided the entry
+            std::filesystem::remove_all(temporary_dir);
+        } else {
+            LOG(INFO) << "Stored G4 physics tables in cache at " << directory;
+        }
+    } catch(std::filesystem::filesystem_error& e) {
+        LOG(WARNING) << "Could not store G4 physics tables in cache: " << e.what();
+    }
+}
+
 void DepositionGeant4Module::initialize_g4_action() {
     auto* action_initialization =
         new ActionInitializationG4<GeneratorActionG4, GeneratorActionInitializationMaster>(config_);
@@ -414,6 +539,11 @@ void DepositionGeant4Module::finalize() {
         size_t average_charge = total_charges_ / number_of_sensors_ / last_event_num_;
         LOG(INFO) << "Deposited total of " << total_charges_ << " charges in " << number_of_sensors_
                   << " sensor(s) (average of " << average_charge << " per sensor for every event)";
+        if(config_.get<bool>("cluster_deposits") && total_raw_deposits_ > 0) {
+            LOG(INFO) << "Clustered " << total_raw_deposits_ << " deposits into " << total_deposits_ << " ("
+                      << (100.0 * static_cast<double>(total_deposits_) / static_cast<double>(total_raw_deposits_))
+                      << "%)";
+        }
     } else {
         LOG(WARNING) << "No charges deposited";
     }
@@ -474,6 +604,21 @@ void DepositionGeant4Module::construct_sensitive_detectors_and_fields() {
         // Get model of the sensitive device
         auto* sensitive_detector_action = new SensitiveDetectorActionG4(
             detector, track_info_manager_.get(), charge_creation_energy, fano_factor, cutoff_time);
+
+        // Merge deposits within a space and time voxel if requested
+        if(config_.get<bool>("cluster_deposits")) {
+            auto voxel_size = config_.get<ROOT::Math::XYZVector>("cluster_voxel_size");
+            auto time_window = config_.get<double>("cluster_time_window");
+            if(voxel_size.x() <= 0 || voxel_size.y() <= 0 || voxel_size.z() <= 0) {
+                throw InvalidValueError(config_, "cluster_voxel_size", "voxel dimensions need to be positive");
+            }
+            if(time_window <= 0) {
+                throw InvalidValueError(config_, "cluster_time_window", "time window needs to be positive");
+            }
+            LOG(DEBUG) << "Clustering deposits in " << detector->getName() << " within voxels of "
+                       << Units::display(voxel_size, {"um"}) << " and " << Units::display(time_window, {"ns", "ps"});
+            sensitive_detector_action->setDepositClustering(voxel_size, time_window);
+        }
         auto logical_volume = geo_manager_->getExternalObject<G4LogicalVolume>(detector->getName(), "sensor_log");
         if(logical_volume == nullptr) {
             throw ModuleError("Detector " + detector->getName() + " has no sensitive device (broken Geant4 geometry)");
@@ -554,5 +699,7 @@ void DepositionGeant4Module::record_module_statistics() {
     // We calculate the total deposited charges here, since sensors exist per thread
     for(auto& sensor : sensors_) {
         total_charges_ += sensor->getTotalDepositedCharge();
+        total_raw_deposits_ += sensor->getTotalRawDeposits();
+        total_deposits_ += sensor->getTotalDeposits();
     }
 }
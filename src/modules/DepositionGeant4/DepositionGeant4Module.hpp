@@ -13,6 +13,7 @@
 #define ALLPIX_SIMPLE_DEPOSITION_MODULE_H
 
 #include <atomic>
+#include <filesystem>
 #include <memory>
 #include <string>
 
@@ -33,6 +34,7 @@
 
 class G4UserLimits;
 class G4RunManager;
+class G4VUserPhysicsList;
 
 namespace allpix {
     /**
@@ -102,6 +104,23 @@ namespace allpix {
          */
         void record_module_statistics();
 
+        /**
+         * @brief Describe all inputs which determine the content of the Geant4 physics tables
+         * @param production_cut Range cut applied for the production of secondaries
+         * @return Description of the physics list, cuts, materials, data sets and Geant4 version
+         */
+        std::string physics_table_description(double production_cut) const;
+
+        /**
+         * @brief Store the physics tables built during initialization in the cache
+         * @param physics_list Physics list whose tables should be stored
+         * @param directory Directory of the cache entry
+         * @param description Description of the inputs of the tables, stored alongside to validate the entry
+         */
+        void store_physics_tables(G4VUserPhysicsList* physics_list,
+                                  const std::filesystem::path& directory,
+                                  const std::string& description);
+
         // Configuration parameters:
         bool output_plots_{};
         unsigned int number_of_particles_{};
@@ -126,6 +145,10 @@ namespace allpix {
         // Total deposited charges
         std::atomic_uint total_charges_{0};
 
+        // Total number of deposits before and after clustering
+        std::atomic_size_t total_raw_deposits_{0};
+        std::atomic_size_t total_deposits_{0};
+
         std::atomic_size_t number_of_sensors_{0};
 
         // Mutex used for the construction of histograms
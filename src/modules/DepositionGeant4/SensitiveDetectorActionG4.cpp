@@ -13,7 +13,9 @@
 #include "SensitiveDetectorActionG4.hpp"
 #include "TrackInfoG4.hpp"
 
+#include <cmath>
 #include <memory>
+#include <tuple>
 
 #include "G4DecayTable.hh"
 #include "G4HCofThisEvent.hh"
@@ -125,6 +127,68 @@ G4bool SensitiveDetectorActionG4::ProcessHits(G4Step* step, G4TouchableHistory*)
     return true;
 }
 
+void SensitiveDetectorActionG4::setDepositClustering(const ROOT::Math::XYZVector& voxel_size, double time_window) {
+    cluster_deposits_ = true;
+    cluster_voxel_size_ = voxel_size;
+    cluster_time_window_ = time_window;
+}
+
+void SensitiveDetectorActionG4::cluster_deposits() {
+    // Accumulated properties of a single cluster of deposits
+    struct Cluster {
+        ROOT::Math::XYZVector weighted_position;
+        double weighted_time{};
+        unsigned int charge{};
+        double energy{};
+        std::map<int, unsigned int> track_charge;
+    };
+
+    // Clusters are kept in order of their first deposit to retain the deposit ordering
+    std::map<std::tuple<long, long, long, long>, size_t> cluster_index;
+    std::vector<Cluster> clusters;
+    for(size_t i = 0; i < deposit_position_.size(); i++) {
+        const auto& position = deposit_position_.at(i);
+        auto key = std::make_tuple(static_cast<long>(std::floor(position.x() / cluster_voxel_size_.x())),
+                                   static_cast<long>(std::floor(position.y() / cluster_voxel_size_.y())),
+                                   static_cast<long>(std::floor(position.z() / cluster_voxel_size_.z())),
+                                   static_cast<long>(std::floor(deposit_time_.at(i) / cluster_time_window_)));
+        auto [it, inserted] = cluster_index.emplace(key, clusters.size());
+        if(inserted) {
+            clusters.emplace_back();
+        }
+
+        auto& cluster = clusters.at(it->second);
+        auto charge = deposit_charge_.at(i);
+        cluster.weighted_position += static_cast<ROOT::Math::XYZVector>(position) * charge;
+        cluster.weighted_time += deposit_time_.at(i) * charge;
+        cluster.charge += charge;
+        cluster.energy += deposit_energy_.at(i);
+        cluster.track_charge[deposit_to_id_.at(i)] += charge;
+    }
+
+    LOG(DEBUG) << "Clustered " << deposit_position_.size() << " deposits into " << clusters.size() << " in "
+               << detector_->getName();
+
+    deposit_position_.clear();
+    deposit_charge_.clear();
+    deposit_energy_.clear();
+    deposit_time_.clear();
+    deposit_to_id_.clear();
+
+    for(const auto& cluster : clusters) {
+        // Link the cluster to the track with the largest charge contribution
+        auto dominant_track = std::max_element(cluster.track_charge.begin(),
+                                               cluster.track_charge.end(),
+                                               [](const auto& l, const auto& r) { return l.second < r.second; });
+
+        deposit_position_.emplace_back(cluster.weighted_position / cluster.charge);
+        deposit_charge_.push_back(cluster.charge);
+        deposit_energy_.push_back(cluster.energy);
+        deposit_time_.push_back(cluster.weighted_time / cluster.charge);
+        deposit_to_id_.push_back(dominant_track->first);
+    }
+}
+
 std::string SensitiveDetectorActionG4::getName() const {
     return detector_->getName();
 }
@@ -220,6 +284,12 @@ void SensitiveDetectorActionG4::dispatchMessages(Module* module, Messenger* mess
     unsigned int charges = 0;
     double energies = 0.;
     if(!deposit_position_.empty()) {
+        total_raw_deposits_ += deposit_position_.size();
+        if(cluster_deposits_) {
+            cluster_deposits();
+        }
+        total_deposits_ += deposit_position_.size();
+
         // Prepare charge deposits for this event
         std::vector<DepositedCharge> deposits;
         for(size_t i = 0; i < deposit_position_.size(); i++) {
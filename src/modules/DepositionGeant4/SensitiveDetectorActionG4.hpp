@@ -87,6 +87,23 @@ namespace allpix {
          */
         void seed(uint64_t random_seed) { random_generator_.seed(random_seed); }
 
+        /**
+         * @brief Enable merging of deposits before dispatching them
+         * @param voxel_size Size of the spatial voxels within which deposits are merged
+         * @param time_window Length of the time window within which deposits are merged
+         */
+        void setDepositClustering(const ROOT::Math::XYZVector& voxel_size, double time_window);
+
+        /**
+         * @brief Get total number of deposits created from Geant4 steps, before clustering
+         */
+        size_t getTotalRawDeposits() const { return total_raw_deposits_; }
+
+        /**
+         * @brief Get total number of deposits dispatched, after clustering
+         */
+        size_t getTotalDeposits() const { return total_deposits_; }
+
         /**
          * @brief Process a single step of a particle passage through this sensor
          * @param step Information about the step
@@ -103,6 +120,14 @@ namespace allpix {
         void dispatchMessages(Module* module, Messenger* messenger, Event* event);
 
     private:
+        /**
+         * @brief Merge all deposits of this event falling into the same space and time voxel
+         *
+         * The merged deposit is placed at the charge-weighted mean position and time of its constituents and linked to the
+         * track that contributed most of its charge.
+         */
+        void cluster_deposits();
+
         std::shared_ptr<Detector> detector_;
         // Pointer to track info manager to register tracks which pass through sensitive detectors
         TrackInfoManager* track_info_manager_;
@@ -124,6 +149,13 @@ namespace allpix {
         double total_deposited_energy_{};
         double deposited_energy_{};
 
+        // Deposit clustering parameters and statistics
+        bool cluster_deposits_{};
+        ROOT::Math::XYZVector cluster_voxel_size_;
+        double cluster_time_window_{};
+        size_t total_raw_deposits_{};
+        size_t total_deposits_{};
+
         // List of positions for deposits
         std::vector<ROOT::Math::XYZPoint> deposit_position_;
         std::vector<unsigned int> deposit_charge_;
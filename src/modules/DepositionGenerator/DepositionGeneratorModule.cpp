@@ -20,6 +20,7 @@
 #include "core/utils/log.h"
 
 // Reader modules:
+#include "PrimariesReaderBuffered.hpp"
 #include "PrimariesReaderGenie.hpp"
 
 #if ALLPIX_GENERATOR_HEPMC
@@ -40,6 +41,7 @@ DepositionGeneratorModule::DepositionGeneratorModule(Configuration& config,
     waive_sequence_requirement(false);
 
     file_model_ = config_.get<PrimariesReader::FileModel>("model");
+    read_ahead_ = config_.get<size_t>("read_ahead", 16);
 
     // Force source type and position:
     config_.set("source_type", "generator");
@@ -55,11 +57,12 @@ DepositionGeneratorModule::DepositionGeneratorModule(Configuration& config,
 void DepositionGeneratorModule::initialize() {
 
     // Generate file reader instance of appropriate type
+    std::unique_ptr<PrimariesReader> reader;
     if(file_model_ == PrimariesReader::FileModel::GENIE) {
-        reader_ = std::make_shared<PrimariesReaderGenie>(config_);
+        reader = std::make_unique<PrimariesReaderGenie>(config_);
     } else if(file_model_ >= PrimariesReader::FileModel::HEPMC) {
 #if ALLPIX_GENERATOR_HEPMC
-        reader_ = std::make_shared<PrimariesReaderHepMC>(config_);
+        reader = std::make_unique<PrimariesReaderHepMC>(config_);
 #else
         throw InvalidValueError(config_, "model", "Framework has been built without support for HepMC data file model");
 #endif
@@ -67,6 +70,14 @@ void DepositionGeneratorModule::initialize() {
         throw InvalidValueError(config_, "model", "Unsupported data file model");
     }
 
+    // Read and parse upcoming events on a separate thread to keep the sequential event processing short
+    if(read_ahead_ > 0) {
+        LOG(DEBUG) << "Reading up to " << read_ahead_ << " events ahead";
+        reader_ = std::make_shared<PrimariesReaderBuffered>(std::move(reader), read_ahead_);
+    } else {
+        reader_ = std::move(reader);
+    }
+
     // Call upstream initialization method
     DepositionGeant4Module::initialize();
 }
@@ -56,6 +56,7 @@ namespace allpix {
         // The file reader for primary particles
         std::shared_ptr<PrimariesReader> reader_;
         PrimariesReader::FileModel file_model_;
+        size_t read_ahead_{};
     };
 
 } // namespace allpix
@@ -24,6 +24,7 @@ namespace allpix {
      */
     class PrimariesReader {
         friend class DepositionGeneratorModule;
+        friend class PrimariesReaderBuffered;
 
     public:
         /**
@@ -114,8 +115,9 @@ namespace allpix {
 
     private:
         /**
-         * Helper method to set the currently processed event number from the \ref DepositionGeneratorModule::run() function.
-         * This is not thread-safe and should only be called in sequential processing mode.
+         * Helper method to set the currently processed event number from the \ref DepositionGeneratorModule::run() function,
+         * or from the reading thread of the \ref PrimariesReaderBuffered. This is not thread-safe and should only be called
+         * in sequential processing mode.
          * @param event_num  Event number
          */
         void set_event_num(uint64_t event_num) { event_num_ = event_num; }
@@ -0,0 +1,100 @@
+/**
+ * @file
+ * @brief Implements the reader which reads primary particles ahead of time on a background thread
+ *
+ * @copyright Copyright (c) 2023 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "PrimariesReaderBuffered.hpp"
+
+#include "core/utils/log.h"
+
+using namespace allpix;
+
+PrimariesReaderBuffered::PrimariesReaderBuffered(std::unique_ptr<PrimariesReader> reader, size_t buffer_size)
+    : reader_(std::move(reader)), buffer_size_(buffer_size) {}
+
+PrimariesReaderBuffered::~PrimariesReaderBuffered() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    event_taken_.notify_all();
+    if(thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+std::vector<PrimariesReader::Particle> PrimariesReaderBuffered::getParticles() {
+    auto event = eventNum();
+
+    // Start reading with the first requested event, passing on the logging settings of the module
+    if(!thread_.joinable()) {
+        LOG(DEBUG) << "Starting to read up to " << buffer_size_ << " events ahead from event " << event;
+        next_event_ = event;
+        thread_ = std::thread([this, event, level = Log::getReportingLevel(), section = Log::getSection()]() {
+            Log::setReportingLevel(level);
+            Log::setSection(section);
+            read_loop(event);
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    event_read_.wait(lock, [&]() { return event < next_event_ || failed_event_.has_value(); });
+
+    // Drop events which have been read but were never requested
+    buffer_.erase(buffer_.begin(), buffer_.lower_bound(event));
+
+    auto entry = buffer_.find(event);
+    if(entry == buffer_.end()) {
+        if(failed_event_.has_value() && failed_event_.value() <= event) {
+            std::rethrow_exception(exception_);
+        }
+        LOG(WARNING) << "Event " << event << " has not been read ahead, returning empty event";
+        return {};
+    }
+
+    auto particles = std::move(entry->second);
+    buffer_.erase(entry);
+    lock.unlock();
+    event_taken_.notify_one();
+    return particles;
+}
+
+void PrimariesReaderBuffered::read_loop(uint64_t first_event) {
+    for(auto event = first_event;; event++) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            event_taken_.wait(lock, [&]() { return stop_ || buffer_.size() < buffer_size_; });
+            if(stop_) {
+                return;
+            }
+        }
+
+        Log::setEventNum(event);
+        reader_->set_event_num(event);
+
+        std::vector<Particle> particles;
+        try {
+            particles = reader_->getParticles();
+        } catch(...) {
+            // Keep the exception to raise it when the failed event is requested, and stop reading
+            std::lock_guard<std::mutex> lock(mutex_);
+            failed_event_ = event;
+            exception_ = std::current_exception();
+            event_read_.notify_one();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            buffer_.emplace(event, std::move(particles));
+            next_event_ = event + 1;
+        }
+        event_read_.notify_one();
+    }
+}
@@ -0,0 +1,90 @@
+/**
+ * @file
+ * @brief Defines a reader which reads primary particles ahead of time on a background thread
+ *
+ * @copyright Copyright (c) 2023 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_PRIMARIES_DEPOSITION_MODULE_READER_BUFFERED_H
+#define ALLPIX_PRIMARIES_DEPOSITION_MODULE_READER_BUFFERED_H
+
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "PrimariesReader.hpp"
+
+namespace allpix {
+    /**
+     * @brief Reads primary particles of upcoming events on a dedicated thread
+     *
+     * The wrapped reader is called for consecutive event numbers on a background thread, starting with the first event
+     * requested. The primary particles are stored in a bounded buffer indexed by event number, from which they are taken
+     * when the event is processed. Decompressing and parsing the input file thus no longer happens in the sequential part
+     * of the event processing.
+     */
+    class PrimariesReaderBuffered : public PrimariesReader {
+    public:
+        /**
+         * @brief Constructor for the buffered reader
+         * @param reader Reader for the file format of the input data
+         * @param buffer_size Maximum number of events read ahead
+         */
+        PrimariesReaderBuffered(std::unique_ptr<PrimariesReader> reader, size_t buffer_size);
+
+        /**
+         * @brief Stop the reading thread and wait for it to finish
+         */
+        ~PrimariesReaderBuffered() override;
+
+        /// @{
+        /**
+         * @brief Copying and moving the reader is not allowed
+         */
+        PrimariesReaderBuffered(const PrimariesReaderBuffered&) = delete;
+        PrimariesReaderBuffered& operator=(const PrimariesReaderBuffered&) = delete;
+        PrimariesReaderBuffered(PrimariesReaderBuffered&&) = delete;
+        PrimariesReaderBuffered& operator=(PrimariesReaderBuffered&&) = delete;
+        /// @}
+
+        /**
+         * Overwritten method to obtain the primary particles for the current event from the buffer, waiting for the reading
+         * thread if the event has not been read yet. Exceptions raised by the wrapped reader, such as the end of the input
+         * file, are rethrown when the event they occurred in is requested.
+         * @return Vector of primary particles
+         */
+        std::vector<Particle> getParticles() override;
+
+    private:
+        /**
+         * @brief Loop of the reading thread, filling the buffer with consecutive events
+         * @param first_event Event number to start reading from
+         */
+        void read_loop(uint64_t first_event);
+
+        std::unique_ptr<PrimariesReader> reader_;
+        size_t buffer_size_;
+
+        std::thread thread_;
+        std::mutex mutex_;
+        std::condition_variable event_read_;
+        std::condition_variable event_taken_;
+        std::map<uint64_t, std::vector<Particle>> buffer_;
+        uint64_t next_event_{};
+        bool stop_{false};
+
+        // Event at which the wrapped reader failed and the reason for the failure
+        std::optional<uint64_t> failed_event_;
+        std::exception_ptr exception_;
+    };
+} // namespace allpix
+
+#endif /* ALLPIX_PRIMARIES_DEPOSITION_MODULE_READER_BUFFERED_H */
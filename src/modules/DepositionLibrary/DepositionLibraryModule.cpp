@@ -0,0 +1,484 @@
+/**
+ * @file
+ * @brief Implementation of a module to record and replay libraries of charge deposits
+ *
+ * @copyright Copyright (c) 2023 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "DepositionLibraryModule.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <utility>
+
+#include "core/module/exceptions.h"
+#include "core/utils/distributions.h"
+#include "core/utils/log.h"
+#include "objects/DepositedCharge.hpp"
+#include "objects/MCParticle.hpp"
+#include "objects/MCTrack.hpp"
+#include "objects/exceptions.h"
+
+using namespace allpix;
+
+std::vector<DepositionLibraryModule*> DepositionLibraryModule::replay_modules_;
+
+namespace {
+    /**
+     * @brief Write an optional index, using -1 for a missing value
+     */
+    long to_index(const std::optional<size_t>& index) { return index.has_value() ? static_cast<long>(index.value()) : -1; }
+
+    /**
+     * @brief Read an optional index, where negative values indicate a missing value
+     */
+    std::optional<size_t> from_index(long index) {
+        return index < 0 ? std::nullopt : std::optional<size_t>(static_cast<size_t>(index));
+    }
+} // namespace
+
+DepositionLibraryModule::DepositionLibraryModule(Configuration& config,
+                                                 Messenger* messenger,
+                                                 std::shared_ptr<Detector> detector)
+    : Module(config, detector), messenger_(messenger), detector_(std::move(detector)) {
+    // Enable multithreading of this module if multithreading is enabled
+    allow_multithreading();
+
+    config_.setDefault("number_of_entries", 1);
+    config_.setDefault("random_translation", true);
+
+    mode_ = config_.get<Mode>("mode");
+    number_of_entries_ = config_.get<unsigned int>("number_of_entries");
+    random_translation_ = config_.get<bool>("random_translation");
+
+    // Deposits and particles are required for recording
+    if(mode_ == Mode::RECORD) {
+        messenger_->bindSingle<DepositedChargeMessage>(this, MsgFlags::REQUIRED);
+        messenger_->bindSingle<MCParticleMessage>(this, MsgFlags::REQUIRED);
+    } else {
+        replay_modules_.push_back(this);
+    }
+}
+
+DepositionLibraryModule::~DepositionLibraryModule() {
+    replay_modules_.erase(std::remove(replay_modules_.begin(), replay_modules_.end(), this), replay_modules_.end());
+}
+
+void DepositionLibraryModule::initialize() {
+    if(mode_ == Mode::RECORD) {
+        file_name_ = createOutputFile(config_.get<std::string>("file_name", "deposition_library_" + detector_->getName()),
+                                      "txt");
+        LOG(INFO) << "Recording deposition library to " << file_name_;
+    } else {
+        file_name_ = config_.getPath("file_name", true);
+        read_library();
+        LOG(INFO) << "Read " << library_.size() << " entries from deposition library " << file_name_;
+    }
+}
+
+void DepositionLibraryModule::run(Event* event) {
+    if(mode_ == Mode::RECORD) {
+        record(event);
+    } else {
+        replay(event);
+    }
+}
+
+void DepositionLibraryModule::record(Event* event) {
+    auto deposits_message = messenger_->fetchMessage<DepositedChargeMessage>(this, event);
+    auto particles_message = messenger_->fetchMessage<MCParticleMessage>(this, event);
+    const auto& mcparticles = particles_message->getData();
+
+    // The entry point of the first primary particle serves as reference for the translation during replay
+    auto primary = std::find_if(
+        mcparticles.begin(), mcparticles.end(), [](const MCParticle& particle) { return particle.getParent() == nullptr; });
+    if(primary == mcparticles.end()) {
+        LOG(DEBUG) << "No primary particle in detector " << detector_->getName() << ", skipping event";
+        skipped_events_++;
+        return;
+    }
+
+    Entry entry;
+    entry.event = event->number;
+    entry.reference = primary->getLocalStartPoint();
+
+    // Add tracks including all their ancestors, converting positions to local coordinates
+    std::map<const MCTrack*, size_t> track_index;
+    std::function<std::optional<size_t>(const MCTrack*)> add_track =
+        [&](const MCTrack* mctrack) -> std::optional<size_t> {
+        if(mctrack == nullptr) {
+            return std::nullopt;
+        }
+        auto iter = track_index.find(mctrack);
+        if(iter != track_index.end()) {
+            return iter->second;
+        }
+        auto parent = add_track(mctrack->getParent());
+        entry.tracks.push_back({detector_->getLocalPosition(mctrack->getStartPoint()),
+                                detector_->getLocalPosition(mctrack->getEndPoint()),
+                                mctrack->getOriginatingVolumeName(),
+                                mctrack->getTerminatingVolumeName(),
+                                mctrack->getCreationProcessName(),
+                                mctrack->getCreationProcessType(),
+                                mctrack->getParticleID(),
+                                mctrack->getGlobalStartTime(),
+                                mctrack->getGlobalEndTime(),
+                                mctrack->getKineticEnergyInitial(),
+                                mctrack->getKineticEnergyFinal(),
+                                mctrack->getTotalEnergyInitial(),
+                                mctrack->getTotalEnergyFinal(),
+                                parent});
+        track_index[mctrack] = entry.tracks.size() - 1;
+        return entry.tracks.size() - 1;
+    };
+
+    std::map<const MCParticle*, size_t> particle_index;
+    for(size_t i = 0; i < mcparticles.size(); ++i) {
+        particle_index[&mcparticles[i]] = i;
+    }
+    for(const auto& mcparticle : mcparticles) {
+        std::optional<size_t> parent;
+        auto iter = particle_index.find(mcparticle.getParent());
+        if(iter != particle_index.end()) {
+            parent = iter->second;
+        }
+        entry.particles.push_back({mcparticle.getLocalStartPoint(),
+                                   mcparticle.getLocalEndPoint(),
+                                   mcparticle.getParticleID(),
+                                   mcparticle.getLocalTime(),
+                                   mcparticle.getGlobalTime(),
+                                   parent,
+                                   add_track(mcparticle.getTrack())});
+    }
+
+    for(const auto& deposit : deposits_message->getData()) {
+        std::optional<size_t> particle;
+        try {
+            auto iter = particle_index.find(deposit.getMCParticle());
+            if(iter != particle_index.end()) {
+                particle = iter->second;
+            }
+        } catch(MissingReferenceException&) {
+            // Deposits without particle are replayed without link
+        }
+        entry.deposits.push_back({deposit.getLocalPosition(),
+                                  deposit.getType(),
+                                  deposit.getCharge(),
+                                  deposit.getLocalTime(),
+                                  deposit.getGlobalTime(),
+                                  particle});
+    }
+
+    LOG(DEBUG) << "Recorded " << entry.deposits.size() << " deposits from " << entry.particles.size() << " particles and "
+               << entry.tracks.size() << " tracks";
+    std::lock_guard<std::mutex> lock(library_mutex_);
+    library_.push_back(std::move(entry));
+}
+
+/**
+ * Tracks are not bound to a detector, the first replaying instance therefore samples the entries of all detectors and
+ * dispatches their tracks in a single message, followed by the particles and deposits of every detector.
+ */
+void DepositionLibraryModule::replay(Event* event) {
+    if(replay_modules_.front() != this) {
+        return;
+    }
+
+    std::vector<MCTrack> mctracks;
+    std::vector<std::optional<size_t>> track_parents;
+    std::vector<std::pair<DepositionLibraryModule*, Replay>> replays;
+    for(auto* module : replay_modules_) {
+        replays.emplace_back(module, module->sample(event, mctracks, track_parents));
+    }
+
+    // Link the objects once all vectors have their final size
+    for(size_t i = 0; i < mctracks.size(); ++i) {
+        if(track_parents[i].has_value()) {
+            mctracks[i].setParent(&mctracks[track_parents[i].value()]);
+        }
+    }
+    for(auto& [module, replay] : replays) {
+        auto& mcparticles = replay.mcparticles;
+        auto& deposits = replay.deposits;
+        std::vector<unsigned int> particle_charges(mcparticles.size(), 0);
+        for(size_t i = 0; i < deposits.size(); ++i) {
+            if(replay.deposit_particles[i].has_value()) {
+                deposits[i].setMCParticle(&mcparticles[replay.deposit_particles[i].value()]);
+                particle_charges[replay.deposit_particles[i].value()] += deposits[i].getCharge();
+            }
+        }
+        for(size_t i = 0; i < mcparticles.size(); ++i) {
+            auto [parent, track] = replay.particle_links[i];
+            if(parent.has_value()) {
+                mcparticles[i].setParent(&mcparticles[parent.value()]);
+            }
+            if(track.has_value()) {
+                mcparticles[i].setTrack(&mctracks[track.value()]);
+            }
+            mcparticles[i].setTotalDepositedCharge(particle_charges[i]);
+        }
+    }
+
+    // Dispatch the messages to the framework
+    if(!mctracks.empty()) {
+        auto mctrack_message = std::make_shared<MCTrackMessage>(std::move(mctracks));
+        messenger_->dispatchMessage(this, mctrack_message, event);
+    }
+
+    for(auto& [module, replay] : replays) {
+        LOG(DEBUG) << "Replaying " << replay.deposits.size() << " deposits in detector " << module->detector_->getName();
+
+        auto mcparticle_message = std::make_shared<MCParticleMessage>(std::move(replay.mcparticles), module->detector_);
+        messenger_->dispatchMessage(this, mcparticle_message, event);
+
+        auto deposit_message = std::make_shared<DepositedChargeMessage>(std::move(replay.deposits), module->detector_);
+        messenger_->dispatchMessage(this, deposit_message, event);
+    }
+}
+
+DepositionLibraryModule::Replay DepositionLibraryModule::sample(Event* event,
+                                                                std::vector<MCTrack>& mctracks,
+                                                                std::vector<std::optional<size_t>>& track_parents) const {
+    auto model = detector_->getModel();
+
+    Replay replay;
+    allpix::uniform_int_distribution<size_t> select_entry(0, library_.size() - 1);
+    allpix::uniform_real_distribution<double> uniform(-0.5, 0.5);
+    for(unsigned int n = 0; n < number_of_entries_; ++n) {
+        const auto& entry = library_[select_entry(event->getRandomEngine())];
+
+        // Move the reference point to a random position in the pixel it was recorded in
+        ROOT::Math::XYZVector shift;
+        if(random_translation_) {
+            auto [index_x, index_y] = model->getPixelIndex(entry.reference);
+            auto center = model->getPixelCenter(index_x, index_y);
+            auto target = ROOT::Math::XYZPoint(center.x() + uniform(event->getRandomEngine()) * model->getPixelSize().x(),
+                                               center.y() + uniform(event->getRandomEngine()) * model->getPixelSize().y(),
+                                               entry.reference.z());
+            shift = target - entry.reference;
+        }
+        LOG(DEBUG) << "Replaying library entry of event " << entry.event << " in detector " << detector_->getName()
+                   << " shifted by " << Units::display(shift, {"um", "mm"});
+
+        auto track_offset = mctracks.size();
+        for(const auto& track : entry.tracks) {
+            mctracks.emplace_back(detector_->getGlobalPosition(track.start + shift),
+                                  detector_->getGlobalPosition(track.end + shift),
+                                  track.volume_start,
+                                  track.volume_end,
+                                  track.process_name,
+                                  track.process_type,
+                                  track.particle_id,
+                                  track.start_time,
+                                  track.end_time,
+                                  track.initial_kinetic_energy,
+                                  track.final_kinetic_energy,
+                                  track.initial_total_energy,
+                                  track.final_total_energy);
+            track_parents.push_back(track.parent.has_value() ? std::optional<size_t>(track.parent.value() + track_offset)
+                                                             : std::nullopt);
+        }
+
+        auto particle_offset = replay.mcparticles.size();
+        for(const auto& particle : entry.particles) {
+            auto start = particle.start + shift;
+            auto end = particle.end + shift;
+            replay.mcparticles.emplace_back(start,
+                                            detector_->getGlobalPosition(start),
+                                            end,
+                                            detector_->getGlobalPosition(end),
+                                            particle.particle_id,
+                                            particle.local_time,
+                                            particle.global_time);
+            replay.particle_links.emplace_back(
+                particle.parent.has_value() ? std::optional<size_t>(particle.parent.value() + particle_offset)
+                                            : std::nullopt,
+                particle.track.has_value() ? std::optional<size_t>(particle.track.value() + track_offset) : std::nullopt);
+        }
+
+        for(const auto& deposit : entry.deposits) {
+            auto position = deposit.position + shift;
+            if(!model->isWithinSensor(position)) {
+                continue;
+            }
+            replay.deposits.emplace_back(position,
+                                         detector_->getGlobalPosition(position),
+                                         deposit.type,
+                                         deposit.charge,
+                                         deposit.local_time,
+                                         deposit.global_time);
+            replay.deposit_particles.push_back(deposit.particle.has_value()
+                                                   ? std::optional<size_t>(deposit.particle.value() + particle_offset)
+                                                   : std::nullopt);
+        }
+    }
+    return replay;
+}
+
+/**
+ * The library is a text file with one line per object. Every entry starts with a line holding the recorded event number and
+ * the reference point, followed by its tracks, particles and deposits. Objects are linked via their index within the entry,
+ * with -1 denoting a missing link. All positions are given in local coordinates of the detector.
+ */
+void DepositionLibraryModule::read_library() {
+    std::ifstream file(file_name_);
+    if(!file) {
+        throw InvalidValueError(config_, "file_name", "library file cannot be opened");
+    }
+
+    std::string line;
+    size_t line_number = 0;
+    while(std::getline(file, line)) {
+        ++line_number;
+        if(line.empty() || line.front() == '#') {
+            continue;
+        }
+
+        std::istringstream stream(line);
+        std::string type;
+        stream >> type;
+        if(type == "entry") {
+            Entry entry;
+            double x = NAN, y = NAN, z = NAN;
+            stream >> entry.event >> x >> y >> z;
+            entry.reference = ROOT::Math::XYZPoint(x, y, z);
+            library_.push_back(std::move(entry));
+            continue;
+        }
+        if(library_.empty()) {
+            throw InvalidValueError(config_, "file_name", "object in line " + std::to_string(line_number) + " has no entry");
+        }
+
+        auto& entry = library_.back();
+        auto read_point = [&stream]() {
+            double x = NAN, y = NAN, z = NAN;
+            stream >> x >> y >> z;
+            return ROOT::Math::XYZPoint(x, y, z);
+        };
+        long parent = -1, link = -1;
+        if(type == "track") {
+            Track track;
+            track.start = read_point();
+            track.end = read_point();
+            stream >> std::quoted(track.volume_start) >> std::quoted(track.volume_end) >> std::quoted(track.process_name) >>
+                track.process_type >> track.particle_id >> track.start_time >> track.end_time >>
+                track.initial_kinetic_energy >> track.final_kinetic_energy >> track.initial_total_energy >>
+                track.final_total_energy >> parent;
+            track.parent = from_index(parent);
+            entry.tracks.push_back(std::move(track));
+        } else if(type == "particle") {
+            Particle particle;
+            particle.start = read_point();
+            particle.end = read_point();
+            stream >> particle.particle_id >> particle.local_time >> particle.global_time >> parent >> link;
+            particle.parent = from_index(parent);
+            particle.track = from_index(link);
+            entry.particles.push_back(particle);
+        } else if(type == "deposit") {
+            Deposit deposit;
+            int carrier = 0;
+            deposit.position = read_point();
+            stream >> carrier >> deposit.charge >> deposit.local_time >> deposit.global_time >> link;
+            deposit.type = static_cast<CarrierType>(carrier);
+            deposit.particle = from_index(link);
+            entry.deposits.push_back(deposit);
+        } else {
+            throw InvalidValueError(
+                config_, "file_name", "unknown object type '" + type + "' in line " + std::to_string(line_number));
+        }
+
+        if(stream.fail()) {
+            throw InvalidValueError(config_, "file_name", "malformed object in line " + std::to_string(line_number));
+        }
+    }
+
+    // Verify the links between the objects, such that replaying never accesses invalid indices
+    for(const auto& entry : library_) {
+        auto valid = [](const std::optional<size_t>& index, size_t size) {
+            return !index.has_value() || index.value() < size;
+        };
+        bool consistent =
+            std::all_of(entry.tracks.begin(),
+                        entry.tracks.end(),
+                        [&](const Track& track) { return valid(track.parent, entry.tracks.size()); }) &&
+            std::all_of(entry.particles.begin(),
+                        entry.particles.end(),
+                        [&](const Particle& particle) {
+                            return valid(particle.parent, entry.particles.size()) &&
+                                   valid(particle.track, entry.tracks.size());
+                        }) &&
+            std::all_of(entry.deposits.begin(), entry.deposits.end(), [&](const Deposit& deposit) {
+                return valid(deposit.particle, entry.particles.size());
+            });
+        if(!consistent) {
+            throw InvalidValueError(
+                config_, "file_name", "entry of event " + std::to_string(entry.event) + " contains invalid references");
+        }
+    }
+
+    if(library_.empty()) {
+        throw InvalidValueError(config_, "file_name", "library does not contain any entries");
+    }
+}
+
+void DepositionLibraryModule::finalize() {
+    if(mode_ != Mode::RECORD) {
+        return;
+    }
+
+    // Sort the entries by event number to obtain the same library independent of the processing order
+    std::sort(library_.begin(), library_.end(), [](const Entry& a, const Entry& b) { return a.event < b.event; });
+
+    std::ofstream file(file_name_);
+    file << std::setprecision(std::numeric_limits<double>::max_digits10);
+    file << "# Allpix Squared deposition library of detector " << detector_->getName() << "\n";
+    for(const auto& entry : library_) {
+        auto write_point = [&file](const ROOT::Math::XYZPoint& point) {
+            file << " " << point.x() << " " << point.y() << " " << point.z();
+        };
+
+        file << "entry " << entry.event;
+        write_point(entry.reference);
+        file << "\n";
+        for(const auto& track : entry.tracks) {
+            file << "track";
+            write_point(track.start);
+            write_point(track.end);
+            file << " " << std::quoted(track.volume_start) << " " << std::quoted(track.volume_end) << " "
+                 << std::quoted(track.process_name) << " " << track.process_type << " " << track.particle_id << " "
+                 << track.start_time << " " << track.end_time << " " << track.initial_kinetic_energy << " "
+                 << track.final_kinetic_energy << " " << track.initial_total_energy << " " << track.final_total_energy << " "
+                 << to_index(track.parent) << "\n";
+        }
+        for(const auto& particle : entry.particles) {
+            file << "particle";
+            write_point(particle.start);
+            write_point(particle.end);
+            file << " " << particle.particle_id << " " << particle.local_time << " " << particle.global_time << " "
+                 << to_index(particle.parent) << " " << to_index(particle.track) << "\n";
+        }
+        for(const auto& deposit : entry.deposits) {
+            file << "deposit";
+            write_point(deposit.position);
+            file << " " << static_cast<int>(deposit.type) << " " << deposit.charge << " " << deposit.local_time << " "
+                 << deposit.global_time << " " << to_index(deposit.particle) << "\n";
+        }
+    }
+
+    if(!file) {
+        throw ModuleError("Could not write deposition library to " + file_name_);
+    }
+    LOG(STATUS) << "Wrote " << library_.size() << " entries to deposition library " << file_name_;
+    if(skipped_events_ > 0) {
+        LOG(WARNING) << skipped_events_ << " events without primary particle in the detector have not been recorded";
+    }
+}
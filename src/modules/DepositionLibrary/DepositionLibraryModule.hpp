@@ -0,0 +1,189 @@
+/**
+ * @file
+ * @brief Definition of a module to record and replay libraries of charge deposits
+ *
+ * @copyright Copyright (c) 2023 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/config/Configuration.hpp"
+#include "core/geometry/Detector.hpp"
+#include "core/messenger/Messenger.hpp"
+#include "core/module/Event.hpp"
+#include "core/module/Module.hpp"
+
+#include "objects/DepositedCharge.hpp"
+#include "objects/MCParticle.hpp"
+#include "objects/MCTrack.hpp"
+
+namespace allpix {
+    /**
+     * @ingroup Modules
+     * @brief Module to record charge deposits of a detector into a library and to replay them with random placement
+     *
+     * In recording mode, the deposits, Monte-Carlo particles and tracks of every event are stored in a library file. In
+     * replay mode, every event is served by a randomly selected library entry, translated to a random position within the
+     * pixel the original particle entered.
+     */
+    class DepositionLibraryModule : public Module {
+        /**
+         * @brief Mode of operation
+         */
+        enum class Mode {
+            RECORD, ///< Record the deposits of every event into the library
+            REPLAY, ///< Dispatch deposits sampled from the library
+        };
+
+        /**
+         * @brief Monte-Carlo track of a library entry, positions in local coordinates of the detector
+         */
+        struct Track {
+            ROOT::Math::XYZPoint start;
+            ROOT::Math::XYZPoint end;
+            std::string volume_start;
+            std::string volume_end;
+            std::string process_name;
+            int process_type{};
+            int particle_id{};
+            double start_time{};
+            double end_time{};
+            double initial_kinetic_energy{};
+            double final_kinetic_energy{};
+            double initial_total_energy{};
+            double final_total_energy{};
+            std::optional<size_t> parent;
+        };
+
+        /**
+         * @brief Monte-Carlo particle of a library entry, positions in local coordinates of the detector
+         */
+        struct Particle {
+            ROOT::Math::XYZPoint start;
+            ROOT::Math::XYZPoint end;
+            int particle_id{};
+            double local_time{};
+            double global_time{};
+            std::optional<size_t> parent;
+            std::optional<size_t> track;
+        };
+
+        /**
+         * @brief Charge deposit of a library entry in local coordinates of the detector
+         */
+        struct Deposit {
+            ROOT::Math::XYZPoint position;
+            CarrierType type{};
+            unsigned int charge{};
+            double local_time{};
+            double global_time{};
+            std::optional<size_t> particle;
+        };
+
+        /**
+         * @brief Library entry holding the deposits of a single recorded event
+         */
+        struct Entry {
+            uint64_t event{};
+            ROOT::Math::XYZPoint reference; ///< Entry point of the primary particle in local coordinates
+            std::vector<Track> tracks;
+            std::vector<Particle> particles;
+            std::vector<Deposit> deposits;
+        };
+
+        /**
+         * @brief Objects replayed for the detector of a module instance, linked once all tracks of the event are known
+         */
+        struct Replay {
+            std::vector<MCParticle> mcparticles;
+            std::vector<std::pair<std::optional<size_t>, std::optional<size_t>>> particle_links;
+            std::vector<DepositedCharge> deposits;
+            std::vector<std::optional<size_t>> deposit_particles;
+        };
+
+    public:
+        /**
+         * @brief Constructor for this detector-specific module
+         * @param config Configuration object for this module as retrieved from the steering file
+         * @param messenger Pointer to the messenger object to allow binding to messages on the bus
+         * @param detector Pointer to the detector for this module instance
+         */
+        DepositionLibraryModule(Configuration& config, Messenger* messenger, std::shared_ptr<Detector> detector);
+
+        /**
+         * @brief Remove this instance from the replaying modules
+         */
+        ~DepositionLibraryModule() override;
+
+        /**
+         * @brief Open the library file for recording or read the library for replay
+         */
+        void initialize() override;
+
+        /**
+         * @brief Record the deposits of the event or dispatch deposits from the library
+         */
+        void run(Event* event) override;
+
+        /**
+         * @brief Write the recorded library
+         */
+        void finalize() override;
+
+    private:
+        /**
+         * @brief Convert the messages of the event into a library entry
+         * @param event Pointer to the current event
+         */
+        void record(Event* event);
+
+        /**
+         * @brief Dispatch the content of randomly selected library entries for all replaying instances
+         * @param event Pointer to the current event
+         *
+         * Only executed by the first replaying instance, such that the tracks of all detectors are dispatched in a single
+         * message.
+         */
+        void replay(Event* event);
+
+        /**
+         * @brief Sample library entries for the detector of this instance
+         * @param event Pointer to the current event
+         * @param mctracks Tracks of the event to append the tracks of the sampled entries to
+         * @param track_parents Index of the parent of every track in the tracks of the event
+         * @return Particles and deposits of the sampled entries with their links
+         */
+        Replay sample(Event* event,
+                      std::vector<MCTrack>& mctracks,
+                      std::vector<std::optional<size_t>>& track_parents) const;
+
+        /**
+         * @brief Read all entries of the library file
+         */
+        void read_library();
+
+        Messenger* messenger_;
+        std::shared_ptr<Detector> detector_;
+
+        Mode mode_{};
+        std::string file_name_;
+        unsigned int number_of_entries_{};
+        bool random_translation_{};
+
+        std::vector<Entry> library_;
+        std::mutex library_mutex_;
+        std::atomic_size_t skipped_events_{0};
+
+        // All instances in replay mode, in the order of their construction
+        static std::vector<DepositionLibraryModule*> replay_modules_;
+    };
+} // namespace allpix
@@ -0,0 +1,483 @@
+/**
+ * @file
+ * @brief Implementation of a module for the fast deposition of charge along straight particle tracks
+ *
+ * @copyright Copyright (c) 2023 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "DepositionStraightTrackModule.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+
+#include <Math/QuantFuncMathCore.h>
+
+#include "core/module/exceptions.h"
+#include "core/utils/distributions.h"
+#include "core/utils/log.h"
+#include "objects/DepositedCharge.hpp"
+#include "objects/MCParticle.hpp"
+#include "physics/MaterialProperties.hpp"
+#include "tools/liang_barsky.h"
+
+using namespace allpix;
+
+namespace {
+    /**
+     * @brief Charged particles available as source, with PDG code and mass in MeV
+     */
+    const std::map<std::string, std::pair<int, double>> particle_types = {{"e-", {11, 0.51099895}},
+                                                                          {"e+", {-11, 0.51099895}},
+                                                                          {"mu-", {13, 105.6583755}},
+                                                                          {"mu+", {-13, 105.6583755}},
+                                                                          {"pi+", {211, 139.57039}},
+                                                                          {"pi-", {-211, 139.57039}},
+                                                                          {"kaon+", {321, 493.677}},
+                                                                          {"kaon-", {-321, 493.677}},
+                                                                          {"proton", {2212, 938.27208816}},
+                                                                          {"anti_proton", {-2212, 938.27208816}}};
+
+    /**
+     * @brief Properties of sensor materials relevant for the energy loss of charged particles
+     *
+     * Values are taken from the PDG tables of atomic and nuclear properties of materials. For compounds not listed there,
+     * the mean excitation energy and radiation length are estimated from their constituents using Bragg's additivity rule.
+     */
+    struct Absorber {
+        double density;          ///< Density in g/cm3
+        double z_over_a;         ///< Ratio of atomic number and mass in mol/g
+        double excitation_eV;    ///< Mean excitation energy in eV
+        double radiation_length; ///< Radiation length in g/cm2
+    };
+    const std::map<SensorMaterial, Absorber> absorbers = {
+        {SensorMaterial::SILICON, {2.329, 0.49848, 173.0, 21.82}},
+        {SensorMaterial::GERMANIUM, {5.323, 0.44071, 350.0, 12.25}},
+        {SensorMaterial::GALLIUM_ARSENIDE, {5.3176, 0.44247, 384.9, 12.19}},
+        {SensorMaterial::GALLIUM_NITRIDE, {6.15, 0.45385, 258.0, 14.05}},
+        {SensorMaterial::CADMIUM_TELLURIDE, {6.2, 0.41665, 539.3, 8.90}},
+        {SensorMaterial::CADMIUM_ZINC_TELLURIDE, {5.78, 0.41820, 522.0, 8.93}},
+        {SensorMaterial::DIAMOND, {3.515, 0.49955, 78.0, 42.70}},
+        {SensorMaterial::SILICON_CARBIDE, {3.21, 0.49954, 136.0, 25.56}}};
+
+    // Electron mass in MeV
+    constexpr double electron_mass = 0.51099895;
+
+    // Energy scale of the Highland formula in MeV
+    constexpr double highland_energy = 13.6;
+
+    // Speed of light in mm/ns
+    constexpr double speed_of_light = 299.792458;
+
+    // Location of the maximum of the standard Landau distribution
+    constexpr double landau_peak = -0.22278;
+
+    /**
+     * @brief Construct two unit vectors perpendicular to a direction and to each other
+     */
+    std::pair<ROOT::Math::XYZVector, ROOT::Math::XYZVector> orthonormal_basis(const ROOT::Math::XYZVector& direction) {
+        auto axis = (std::fabs(direction.x()) < 0.9 ? ROOT::Math::XYZVector(1, 0, 0) : ROOT::Math::XYZVector(0, 1, 0));
+        auto u = direction.Cross(axis).Unit();
+        return {u, direction.Cross(u)};
+    }
+} // namespace
+
+DepositionStraightTrackModule::DepositionStraightTrackModule(Configuration& config,
+                                                             Messenger* messenger,
+                                                             GeometryManager* geo_manager)
+    : Module(config), messenger_(messenger), geo_manager_(geo_manager) {
+    // Enable multithreading of this module if multithreading is enabled
+    allow_multithreading();
+
+    // Set default values for the beam and simulation parameters
+    config_.setDefault("source_position", ROOT::Math::XYZPoint(0., 0., 0.));
+    config_.setDefault("beam_direction", ROOT::Math::XYZVector(0., 0., 1.));
+    config_.setDefault("beam_size", 0.);
+    config_.setDefault("beam_divergence", ROOT::Math::XYVector(0., 0.));
+    config_.setDefault("number_of_particles", 1);
+    config_.setDefault("step_length", Units::get(1.0, "um"));
+    config_.setDefault("multiple_scattering", true);
+    config_.setDefault("delta_rays", false);
+    config_.setDefault("delta_ray_threshold", Units::get(10.0, "keV"));
+
+    auto particle_type = config_.get<std::string>("particle_type");
+    auto particle = particle_types.find(particle_type);
+    if(particle == particle_types.end()) {
+        std::string types;
+        for(const auto& [name, properties] : particle_types) {
+            types += (types.empty() ? "" : ", ") + name;
+        }
+        throw InvalidValueError(config_, "particle_type", "unknown particle type, possible values are " + types);
+    }
+    pdg_code_ = particle->second.first;
+    particle_mass_ = Units::get(particle->second.second, "MeV");
+
+    source_energy_ = config_.get<double>("source_energy");
+    if(source_energy_ <= 0) {
+        throw InvalidValueError(config_, "source_energy", "kinetic energy of the particles has to be positive");
+    }
+    source_position_ = config_.get<ROOT::Math::XYZPoint>("source_position");
+    beam_direction_ = config_.get<ROOT::Math::XYZVector>("beam_direction").Unit();
+    beam_size_ = config_.get<double>("beam_size");
+    beam_divergence_ = config_.get<ROOT::Math::XYVector>("beam_divergence");
+    number_of_particles_ = config_.get<unsigned int>("number_of_particles");
+
+    step_length_ = config_.get<double>("step_length");
+    if(step_length_ <= 0) {
+        throw InvalidValueError(config_, "step_length", "step length has to be positive");
+    }
+    multiple_scattering_ = config_.get<bool>("multiple_scattering");
+    delta_rays_ = config_.get<bool>("delta_rays");
+    delta_ray_threshold_ = config_.get<double>("delta_ray_threshold");
+
+    // Add the particle source position to the geometry
+    geo_manager_->addPoint(source_position_);
+}
+
+void DepositionStraightTrackModule::initialize() {
+    for(auto& detector : geo_manager_->getDetectors()) {
+        auto model = detector->getModel();
+        auto material = model->getSensorMaterial();
+        auto absorber = absorbers.find(material);
+        if(absorber == absorbers.end()) {
+            throw ModuleError("Sensor material of detector " + detector->getName() + " is not supported");
+        }
+        const auto& properties = absorber->second;
+
+        Sensor sensor;
+        sensor.detector = detector;
+        sensor.center = model->getSensorCenter();
+        sensor.size = model->getSensorSize();
+
+        // Half of the constant K of the Bethe formula in MeV cm2/mol, converted to the Landau width per path length
+        sensor.xi_per_length = Units::get(0.5 * 0.307075, "MeV") * properties.z_over_a * properties.density /
+                               Units::get(1.0, "cm");
+        sensor.ionization_potential = Units::get(properties.excitation_eV, "eV");
+        sensor.plasma_energy = Units::get(28.816 * std::sqrt(properties.density * properties.z_over_a), "eV");
+        sensor.radiation_length = Units::get(properties.radiation_length / properties.density, "cm");
+        sensor.range_per_mass = Units::get(1.0 / properties.density, "cm");
+
+        sensor.charge_creation_energy = config_.get<double>("charge_creation_energy", ionization_energies[material]);
+        sensor.fano_factor = config_.get<double>("fano_factor", fano_factors[material]);
+
+        LOG(DEBUG) << "Detector " << detector->getName() << ": Landau width "
+                   << Units::display(sensor.xi_per_length * Units::get(1.0, "um"), {"eV", "keV"}) << "/um, radiation length "
+                   << Units::display(sensor.radiation_length, {"mm", "cm"});
+        sensors_.push_back(std::move(sensor));
+    }
+
+    LOG(INFO) << "Transporting " << number_of_particles_ << " particle(s) of type "
+              << config_.get<std::string>("particle_type") << " with " << Units::display(source_energy_, {"MeV", "GeV"})
+              << " per event in steps of " << Units::display(step_length_, {"um", "mm"});
+}
+
+void DepositionStraightTrackModule::run(Event* event) {
+    std::vector<SensorRecord> records(sensors_.size());
+    for(unsigned int n = 0; n < number_of_particles_; ++n) {
+        transport(event, records);
+    }
+    total_tracks_ += number_of_particles_;
+
+    // Convert the records of every sensor to objects and dispatch them
+    for(size_t i = 0; i < sensors_.size(); ++i) {
+        auto& record = records[i];
+        if(record.particles.empty()) {
+            continue;
+        }
+        const auto& detector = sensors_[i].detector;
+
+        // Local times are relative to the arrival of the first particle in the sensor
+        auto time_reference = std::min_element(record.particles.begin(),
+                                               record.particles.end(),
+                                               [](const auto& a, const auto& b) { return a.time < b.time; })
+                                  ->time;
+
+        std::vector<MCParticle> mcparticles;
+        mcparticles.reserve(record.particles.size());
+        for(const auto& particle : record.particles) {
+            mcparticles.emplace_back(particle.start,
+                                     detector->getGlobalPosition(particle.start),
+                                     particle.end,
+                                     detector->getGlobalPosition(particle.end),
+                                     particle.pdg_code,
+                                     particle.time - time_reference,
+                                     particle.time);
+        }
+        for(size_t p = 0; p < record.particles.size(); ++p) {
+            if(record.particles[p].parent.has_value()) {
+                mcparticles[p].setParent(&mcparticles[record.particles[p].parent.value()]);
+            }
+        }
+
+        std::vector<unsigned int> particle_charges(mcparticles.size(), 0);
+        std::vector<DepositedCharge> deposits;
+        deposits.reserve(2 * record.deposits.size());
+        for(const auto& deposit : record.deposits) {
+            auto global_position = detector->getGlobalPosition(deposit.position);
+            auto* mcparticle = &mcparticles[deposit.particle];
+            deposits.emplace_back(deposit.position,
+                                  global_position,
+                                  CarrierType::ELECTRON,
+                                  deposit.charge,
+                                  deposit.time - time_reference,
+                                  deposit.time,
+                                  mcparticle);
+            deposits.emplace_back(deposit.position,
+                                  global_position,
+                                  CarrierType::HOLE,
+                                  deposit.charge,
+                                  deposit.time - time_reference,
+                                  deposit.time,
+                                  mcparticle);
+            particle_charges[deposit.particle] += 2 * deposit.charge;
+            total_charges_ += deposit.charge;
+        }
+        for(size_t p = 0; p < mcparticles.size(); ++p) {
+            mcparticles[p].setTotalDepositedCharge(particle_charges[p]);
+        }
+        LOG(DEBUG) << "Deposited " << deposits.size() / 2 << " charge deposits from " << mcparticles.size()
+                   << " particle(s) in detector " << detector->getName();
+
+        // Dispatch the messages to the framework
+        auto mcparticle_message = std::make_shared<MCParticleMessage>(std::move(mcparticles), detector);
+        messenger_->dispatchMessage(this, mcparticle_message, event);
+
+        auto deposit_message = std::make_shared<DepositedChargeMessage>(std::move(deposits), detector);
+        messenger_->dispatchMessage(this, deposit_message, event);
+    }
+}
+
+void DepositionStraightTrackModule::transport(Event* event, std::vector<SensorRecord>& records) {
+    // Generate the starting point and direction from the beam profile
+    auto [beam_u, beam_v] = orthonormal_basis(beam_direction_);
+    auto position = source_position_;
+    if(beam_size_ > 0) {
+        allpix::normal_distribution<double> beam_profile(0, beam_size_);
+        position += beam_profile(event->getRandomEngine()) * beam_u + beam_profile(event->getRandomEngine()) * beam_v;
+    }
+    auto direction = beam_direction_;
+    if(beam_divergence_.x() > 0 || beam_divergence_.y() > 0) {
+        allpix::normal_distribution<double> divergence_x(0, beam_divergence_.x());
+        allpix::normal_distribution<double> divergence_y(0, beam_divergence_.y());
+        direction = (direction + std::tan(divergence_x(event->getRandomEngine())) * beam_u +
+                     std::tan(divergence_y(event->getRandomEngine())) * beam_v)
+                        .Unit();
+    }
+
+    double kinetic_energy = source_energy_;
+    double time = 0;
+    std::optional<size_t> last_sensor;
+    while(kinetic_energy > 0) {
+        // Find the next sensor along the track
+        std::optional<size_t> next_sensor;
+        double next_entry = std::numeric_limits<double>::max(), next_exit = 0;
+        for(size_t i = 0; i < sensors_.size(); ++i) {
+            if(last_sensor == i) {
+                continue;
+            }
+            const auto& sensor = sensors_[i];
+            auto local_position = sensor.detector->getLocalPosition(position);
+            auto local_direction = sensor.detector->getLocalPosition(position + direction) - local_position;
+            auto intersection = LiangBarsky::intersectionDistances(
+                local_direction, local_position - static_cast<ROOT::Math::XYZVector>(sensor.center), sensor.size);
+            if(!intersection.has_value() || intersection->second <= 0) {
+                continue;
+            }
+            auto entry = std::max(intersection->first, 0.);
+            if(entry < next_entry) {
+                next_sensor = i;
+                next_entry = entry;
+                next_exit = intersection->second;
+            }
+        }
+        if(!next_sensor.has_value()) {
+            break;
+        }
+
+        // Move the particle to the entry of the sensor
+        auto gamma = 1 + kinetic_energy / particle_mass_;
+        auto beta = std::sqrt(1 - 1 / (gamma * gamma));
+        position += next_entry * direction;
+        time += next_entry / (beta * speed_of_light);
+
+        // Deposit energy along the path through the sensor
+        const auto& sensor = sensors_[next_sensor.value()];
+        auto path_length = next_exit - next_entry;
+        auto local_entry = sensor.detector->getLocalPosition(position);
+        auto local_direction = sensor.detector->getLocalPosition(position + direction) - local_entry;
+        auto energy_loss = deposit(event,
+                                   sensor,
+                                   records[next_sensor.value()],
+                                   local_entry,
+                                   local_direction,
+                                   path_length,
+                                   kinetic_energy,
+                                   time);
+        position += path_length * direction;
+        time += path_length / (beta * speed_of_light);
+        last_sensor = next_sensor;
+
+        // Apply multiple scattering as a kink at the exit of the sensor, using the Highland formula
+        if(multiple_scattering_) {
+            auto momentum = std::sqrt(kinetic_energy * (kinetic_energy + 2 * particle_mass_));
+            auto thickness = path_length / sensor.radiation_length;
+            auto theta0 = highland_energy / (beta * momentum) * std::sqrt(thickness) *
+                          (1 + 0.038 * std::log(thickness / (beta * beta)));
+            if(theta0 > 0) {
+                allpix::normal_distribution<double> scattering(0, theta0);
+                auto [u, v] = orthonormal_basis(direction);
+                direction = (direction + std::tan(scattering(event->getRandomEngine())) * u +
+                             std::tan(scattering(event->getRandomEngine())) * v)
+                                .Unit();
+            }
+        }
+
+        kinetic_energy -= energy_loss;
+    }
+}
+
+/**
+ * The energy loss in every step is sampled from the Landau distribution with the most probable value given by the
+ * Landau-Vavilov-Bichsel formula including the high-energy limit of the density effect correction. Since the Landau
+ * distribution is stable, the energy loss summed over all steps follows the distribution expected for the full path.
+ */
+double DepositionStraightTrackModule::deposit(Event* event,
+                                              const Sensor& sensor,
+                                              SensorRecord& record,
+                                              const ROOT::Math::XYZPoint& entry,
+                                              const ROOT::Math::XYZVector& direction,
+                                              double path_length,
+                                              double kinetic_energy,
+                                              double time) {
+    auto model = sensor.detector->getModel();
+
+    // Kinematic quantities of the particle
+    auto gamma = 1 + kinetic_energy / particle_mass_;
+    auto beta2 = 1 - 1 / (gamma * gamma);
+    auto betagamma2 = beta2 * gamma * gamma;
+    auto mass_ratio = electron_mass / particle_mass_;
+    auto max_energy_transfer = 2 * electron_mass * betagamma2 / (1 + 2 * gamma * mass_ratio + mass_ratio * mass_ratio);
+    auto density_correction =
+        std::max(0., 2 * std::log(sensor.plasma_energy / sensor.ionization_potential) + std::log(betagamma2) - 1);
+
+    // Landau parameters for a single step
+    auto steps = std::max(static_cast<unsigned int>(std::ceil(path_length / step_length_)), 1u);
+    auto step = path_length / steps;
+    auto xi = sensor.xi_per_length * step / beta2;
+    auto most_probable = xi * (std::log(2 * electron_mass * betagamma2 / sensor.ionization_potential) +
+                               std::log(xi / sensor.ionization_potential) + 0.2 - beta2 - density_correction);
+    auto step_time = step / (std::sqrt(beta2) * speed_of_light);
+
+    auto exit = entry + path_length * direction;
+    record.particles.push_back({entry, exit, pdg_code_, time, std::nullopt});
+    auto particle = record.particles.size() - 1;
+
+    allpix::uniform_real_distribution<double> uniform(0, 1);
+    double energy_loss = 0;
+    for(unsigned int n = 0; n < steps; ++n) {
+        auto quantile = std::clamp(uniform(event->getRandomEngine()), 1e-12, 1 - 1e-12);
+        auto loss = std::clamp(most_probable + xi * (ROOT::Math::landau_quantile(quantile) - landau_peak),
+                               0.,
+                               std::max(std::min(max_energy_transfer, kinetic_energy - energy_loss), 0.));
+        energy_loss += loss;
+
+        auto position = entry + (n + 0.5) * step * direction;
+        auto step_global_time = time + (n + 0.5) * step_time;
+
+        // Large energy transfers from the tail of the distribution are emitted as delta electrons
+        if(delta_rays_ && loss - most_probable > delta_ray_threshold_) {
+            auto delta_energy = loss - most_probable;
+            loss = most_probable;
+            emit_delta_ray(
+                event, sensor, record, particle, position, direction, delta_energy, max_energy_transfer, step_global_time);
+        }
+
+        if(!model->isWithinSensor(position)) {
+            continue;
+        }
+        auto charge = create_charge(event, sensor, loss);
+        if(charge > 0) {
+            record.deposits.push_back({position, step_global_time, charge, particle});
+        }
+    }
+
+    LOG(TRACE) << "Particle lost " << Units::display(energy_loss, {"keV", "MeV"}) << " over "
+               << Units::display(path_length, {"um", "mm"}) << " in detector " << sensor.detector->getName();
+    return energy_loss;
+}
+
+/**
+ * The emission angle follows from the kinematics of the collision with a free electron. The electron deposits its energy
+ * uniformly along its practical range, parametrized by Katz and Penfold. Energy carried out of the sensor is lost.
+ */
+void DepositionStraightTrackModule::emit_delta_ray(Event* event,
+                                                   const Sensor& sensor,
+                                                   SensorRecord& record,
+                                                   size_t parent,
+                                                   const ROOT::Math::XYZPoint& origin,
+                                                   const ROOT::Math::XYZVector& direction,
+                                                   double energy,
+                                                   double max_energy,
+                                                   double time) {
+    auto model = sensor.detector->getModel();
+
+    // Emission angle with respect to the parent particle, with uniform azimuth
+    auto momentum = std::sqrt(energy * (energy + 2 * electron_mass));
+    auto max_momentum = std::sqrt(max_energy * (max_energy + 2 * electron_mass));
+    auto cos_theta = std::min(energy / momentum * max_momentum / max_energy, 1.);
+    auto sin_theta = std::sqrt(1 - cos_theta * cos_theta);
+    auto phi = allpix::uniform_real_distribution<double>(0, 2 * M_PI)(event->getRandomEngine());
+    auto [u, v] = orthonormal_basis(direction);
+    auto delta_direction = cos_theta * direction + sin_theta * (std::cos(phi) * u + std::sin(phi) * v);
+
+    // Practical range in g/cm2 for the energy in MeV
+    auto energy_mev = Units::convert(energy, "MeV");
+    auto range_mass = (energy_mev < 2.5 ? 0.412 * std::pow(energy_mev, 1.265 - 0.0954 * std::log(energy_mev))
+                                        : 0.530 * energy_mev - 0.106);
+    auto range = range_mass * sensor.range_per_mass;
+
+    // Limit the path to the sensor volume
+    auto intersection = LiangBarsky::intersectionDistances(
+        delta_direction, origin - static_cast<ROOT::Math::XYZVector>(sensor.center), sensor.size);
+    auto path_length = std::min(range, intersection.has_value() ? std::max(intersection->second, 0.) : 0.);
+
+    record.particles.push_back({origin, origin + path_length * delta_direction, 11, time, parent});
+    auto particle = record.particles.size() - 1;
+    total_delta_rays_++;
+
+    auto steps = std::max(static_cast<unsigned int>(std::ceil(path_length / step_length_)), 1u);
+    auto step = path_length / steps;
+    for(unsigned int n = 0; n < steps; ++n) {
+        auto position = origin + (n + 0.5) * step * delta_direction;
+        if(!model->isWithinSensor(position)) {
+            continue;
+        }
+        auto charge = create_charge(event, sensor, energy * step / range);
+        if(charge > 0) {
+            record.deposits.push_back({position, time, charge, particle});
+        }
+    }
+    LOG(TRACE) << "Emitted delta electron with " << Units::display(energy, {"keV", "MeV"}) << " and range "
+               << Units::display(range, {"um", "mm"});
+}
+
+unsigned int DepositionStraightTrackModule::create_charge(Event* event, const Sensor& sensor, double energy) const {
+    // Fluctuations of the number of electron-hole pairs via the Fano factor, assuming Gaussian statistics
+    auto mean_charge = energy / sensor.charge_creation_energy;
+    allpix::normal_distribution<double> charge_fluctuation(mean_charge, std::sqrt(mean_charge * sensor.fano_factor));
+    return static_cast<unsigned int>(std::max(charge_fluctuation(event->getRandomEngine()), 0.));
+}
+
+void DepositionStraightTrackModule::finalize() {
+    LOG(STATUS) << "Transported " << total_tracks_ << " particles, depositing " << total_charges_
+                << " electron-hole pairs in total";
+    if(delta_rays_) {
+        LOG(INFO) << "Emitted " << total_delta_rays_ << " delta electrons above "
+                  << Units::display(delta_ray_threshold_, {"keV", "MeV"});
+    }
+}
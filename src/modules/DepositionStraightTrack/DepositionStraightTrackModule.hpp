@@ -0,0 +1,186 @@
+/**
+ * @file
+ * @brief Definition of a module for the fast deposition of charge along straight particle tracks
+ *
+ * @copyright Copyright (c) 2023 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/config/Configuration.hpp"
+#include "core/geometry/GeometryManager.hpp"
+#include "core/messenger/Messenger.hpp"
+#include "core/module/Event.hpp"
+#include "core/module/Module.hpp"
+
+namespace allpix {
+    /**
+     * @ingroup Modules
+     * @brief Module to deposit charge carriers along straight tracks of charged particles without Geant4
+     *
+     * Particles are generated from a beam and transported along straight lines through the sensors of all detectors. The
+     * energy loss in every step is sampled from the Landau distribution, optionally emitting delta rays for large energy
+     * transfers and applying multiple scattering at the exit of every sensor.
+     */
+    class DepositionStraightTrackModule : public Module {
+        /**
+         * @brief Properties of a sensor required for the energy loss calculation, all in framework units
+         */
+        struct Sensor {
+            std::shared_ptr<Detector> detector;
+            ROOT::Math::XYZPoint center;
+            ROOT::Math::XYZVector size;
+            double xi_per_length{};        ///< Landau width parameter per unit path length for beta and charge of one
+            double ionization_potential{}; ///< Mean excitation energy of the material
+            double plasma_energy{};        ///< Plasma energy of the material for the density effect correction
+            double radiation_length{};     ///< Radiation length of the material
+            double range_per_mass{};       ///< Conversion of an areal density in g/cm2 to a length in the material
+            double charge_creation_energy{};
+            double fano_factor{};
+        };
+
+        /**
+         * @brief Monte-Carlo particle in a sensor, converted to a MCParticle when the event has been simulated
+         */
+        struct Particle {
+            ROOT::Math::XYZPoint start;
+            ROOT::Math::XYZPoint end;
+            int pdg_code;
+            double time;
+            std::optional<size_t> parent;
+        };
+
+        /**
+         * @brief Charge deposit in a sensor, converted to a DepositedCharge when the event has been simulated
+         */
+        struct Deposit {
+            ROOT::Math::XYZPoint position;
+            double time;
+            unsigned int charge;
+            size_t particle;
+        };
+
+        /**
+         * @brief Particles and deposits of a single sensor in the current event
+         */
+        struct SensorRecord {
+            std::vector<Particle> particles;
+            std::vector<Deposit> deposits;
+        };
+
+    public:
+        /**
+         * @brief Constructor for this unique module
+         * @param config Configuration object for this module as retrieved from the steering file
+         * @param messenger Pointer to the messenger object to allow binding to messages on the bus
+         * @param geo_manager Pointer to the geometry manager, containing the detectors
+         */
+        DepositionStraightTrackModule(Configuration& config, Messenger* messenger, GeometryManager* geo_manager);
+
+        /**
+         * @brief Determine the material properties of all sensors
+         */
+        void initialize() override;
+
+        /**
+         * @brief Generate and transport the particles of the event
+         */
+        void run(Event* event) override;
+
+        /**
+         * @brief Report the number of simulated tracks and deposited charge carriers
+         */
+        void finalize() override;
+
+    private:
+        /**
+         * @brief Transport a single particle through all sensors
+         * @param event Pointer to the current event
+         * @param records Particles and deposits of every sensor
+         */
+        void transport(Event* event, std::vector<SensorRecord>& records);
+
+        /**
+         * @brief Deposit energy along the path of a particle through a sensor
+         * @param event Pointer to the current event
+         * @param sensor Sensor the particle traverses
+         * @param record Record to add the particle and deposits to
+         * @param entry Entry point in local coordinates
+         * @param direction Direction in local coordinates
+         * @param path_length Length of the path through the sensor
+         * @param kinetic_energy Kinetic energy of the particle when entering the sensor
+         * @param time Global time of the entry
+         * @return Total energy lost in the sensor
+         */
+        double deposit(Event* event,
+                       const Sensor& sensor,
+                       SensorRecord& record,
+                       const ROOT::Math::XYZPoint& entry,
+                       const ROOT::Math::XYZVector& direction,
+                       double path_length,
+                       double kinetic_energy,
+                       double time);
+
+        /**
+         * @brief Deposit the energy of a delta electron along its range
+         * @param event Pointer to the current event
+         * @param sensor Sensor the delta electron is emitted in
+         * @param record Record to add the particle and deposits to
+         * @param parent Index of the parent particle in the record
+         * @param origin Point of emission in local coordinates
+         * @param direction Direction of the parent particle in local coordinates
+         * @param energy Kinetic energy of the delta electron
+         * @param max_energy Maximum energy transfer to a free electron in a single collision
+         * @param time Global time of the emission
+         */
+        void emit_delta_ray(Event* event,
+                            const Sensor& sensor,
+                            SensorRecord& record,
+                            size_t parent,
+                            const ROOT::Math::XYZPoint& origin,
+                            const ROOT::Math::XYZVector& direction,
+                            double energy,
+                            double max_energy,
+                            double time);
+
+        /**
+         * @brief Convert deposited energy to a number of electron-hole pairs including Fano fluctuations
+         */
+        unsigned int create_charge(Event* event, const Sensor& sensor, double energy) const;
+
+        Messenger* messenger_;
+        GeometryManager* geo_manager_;
+
+        std::vector<Sensor> sensors_;
+
+        // Particle and beam parameters
+        int pdg_code_{};
+        double particle_mass_{};
+        double source_energy_{};
+        ROOT::Math::XYZPoint source_position_;
+        ROOT::Math::XYZVector beam_direction_;
+        double beam_size_{};
+        ROOT::Math::XYVector beam_divergence_;
+        unsigned int number_of_particles_{};
+
+        // Simulation parameters
+        double step_length_{};
+        bool multiple_scattering_{};
+        bool delta_rays_{};
+        double delta_ray_threshold_{};
+
+        // Statistics
+        std::atomic_uint64_t total_tracks_{0};
+        std::atomic_uint64_t total_delta_rays_{0};
+        std::atomic_uint64_t total_charges_{0};
+    };
+} // namespace allpix
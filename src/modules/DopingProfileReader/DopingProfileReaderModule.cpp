@@ -47,7 +47,7 @@ void DopingProfileReaderModule::initialize() {
         auto field_mapping = config_.get<FieldMapping>("field_mapping");
         LOG(DEBUG) << "Doping concentration maps to " << magic_enum::enum_name(field_mapping);
 
-        auto field_data = read_field();
+        auto [field_data, field_grid] = read_field_grid();
 
         // By default, set field scale from physical extent read from field file:
         std::array<double, 2> field_scale{{1.0, 1.0}};
@@ -70,7 +70,7 @@ void DopingProfileReaderModule::initialize() {
         }
         LOG(DEBUG) << "Doping profile has offset of " << offset << " fractions of the field size";
 
-        detector_->setDopingProfileGrid(field_data.getData(),
+        detector_->setDopingProfileGrid(field_grid,
                                         field_data.getDimensions(),
                                         field_data.getSize(),
                                         field_mapping,
@@ -150,6 +150,20 @@ FieldData<double> DopingProfileReaderModule::read_field() {
     }
 }
 
+/**
+ * Fields are identified by the file they are read from, which is released from the cache of the field parser after the
+ * conversion.
+ */
+FieldGridCache DopingProfileReaderModule::field_grids_("doping profile", "/cm/cm/cm");
+std::pair<FieldData<double>, FieldGrid> DopingProfileReaderModule::read_field_grid() {
+    auto file_name = config_.getPath("file_name", true);
+    return field_grids_.get(
+        std::filesystem::canonical(file_name).string(),
+        config_.get<FieldPrecision>("field_precision", FieldPrecision::DOUBLE),
+        [&]() { return read_field(); },
+        [&](const FieldData<double>&) { field_parser_.release(file_name); });
+}
+
 void DopingProfileReaderModule::create_output_plots() {
     LOG(TRACE) << "Creating output plots";
 
@@ -9,9 +9,14 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <string>
+#include <utility>
+
 #include "core/config/Configuration.hpp"
 #include "core/geometry/DetectorModel.hpp"
+#include "core/geometry/FieldGrid.hpp"
 #include "core/messenger/Messenger.hpp"
+#include "tools/field_grid_cache.h"
 #include "tools/field_parser.h"
 
 #include "core/module/Module.hpp"
@@ -58,6 +63,13 @@ namespace allpix {
         FieldData<double> read_field();
         static FieldParser<double> field_parser_;
 
+        /**
+         * @brief Read the field and store its values with the configured precision
+         * @return Data of the field without values and the grid holding the values
+         */
+        std::pair<FieldData<double>, FieldGrid> read_field_grid();
+        static FieldGridCache field_grids_;
+
         /**
          * @brief Create output plots of the doping profile
          */
@@ -11,10 +11,16 @@
 
 #include "ElectricFieldReaderModule.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <fstream>
+#include <iomanip>
 #include <limits>
 #include <memory>
 #include <new>
+#include <numeric>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -73,7 +79,7 @@ void ElectricFieldReaderModule::initialize() {
         // Read field mapping from configuration
         auto field_mapping = config_.get<FieldMapping>("field_mapping");
         LOG(DEBUG) << "Electric field maps to " << magic_enum::enum_name(field_mapping);
-        auto field_data = read_field();
+        auto [field_data, field_grid] = read_field_grid();
 
         // By default, set field scale from physical extent read from field file:
         std::array<double, 2> field_scale{{1.0, 1.0}};
@@ -96,7 +102,7 @@ void ElectricFieldReaderModule::initialize() {
         }
         LOG(DEBUG) << "Electric field has offset of " << offset << " fractions of the field size";
 
-        detector_->setElectricFieldGrid(field_data.getData(),
+        detector_->setElectricFieldGrid(field_grid,
                                         field_data.getDimensions(),
                                         field_data.getSize(),
                                         field_mapping,
@@ -272,8 +278,10 @@ FieldData<double> ElectricFieldReaderModule::read_field() {
     try {
         LOG(TRACE) << "Fetching electric field from mesh file";
 
-        // Get field from file
-        auto field_data = field_parser_.getByFileName(config_.getPath("file_name", true), "V/cm");
+        // Get field from file, or derive it from field maps simulated at different bias voltages
+        auto field_data = (config_.has("field_bias_voltage")
+                               ? read_bias_field()
+                               : field_parser_.getByFileName(config_.getPath("file_name", true), "V/cm"));
 
         // Warn at field values larger than 1MV/cm / 10 MV/mm. Simple lookup per vector component, not total field magnitude
         auto max_field = *std::max_element(std::begin(*field_data.getData()), std::end(*field_data.getData()));
@@ -296,6 +304,152 @@ FieldData<double> ElectricFieldReaderModule::read_field() {
     }
 }
 
+/**
+ * A single field map is scaled linearly to the requested bias voltage, which is a good approximation for the field of an
+ * over-depleted sensor. With several field maps, the field is linearly interpolated between the two maps simulated at the
+ * closest bias voltages below and above the requested one. Only these two maps are read. The field is derived in place
+ * in the values of the first map, which are only copied if they are still used elsewhere, and the maps read are removed
+ * from the cache of the parser afterwards. The derived field is shared between module instantiations using the same maps
+ * and bias voltage.
+ */
+std::map<std::string, FieldData<double>> ElectricFieldReaderModule::bias_fields_;
+FieldData<double> ElectricFieldReaderModule::read_bias_field() {
+    auto file_names = config_.getPathArray("file_name", true);
+    auto voltages = config_.getArray<double>("field_bias_voltage");
+    auto bias_voltage = config_.get<double>("bias_voltage");
+    if(voltages.size() != file_names.size()) {
+        throw InvalidValueError(config_, "field_bias_voltage", "one bias voltage for every field map required");
+    }
+
+    // Order the field maps by their bias voltage
+    std::vector<size_t> order(voltages.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](auto lhs, auto rhs) { return voltages[lhs] < voltages[rhs]; });
+    for(size_t i = 1; i < order.size(); ++i) {
+        if(voltages[order[i - 1]] == voltages[order[i]]) {
+            throw InvalidValueError(config_, "field_bias_voltage", "bias voltages of the field maps need to be unique");
+        }
+    }
+
+    // Select the field maps and their weights
+    std::vector<std::pair<size_t, double>> weights;
+    if(voltages.size() == 1) {
+        if(voltages.front() == 0) {
+            throw InvalidValueError(config_, "field_bias_voltage", "field map at zero bias voltage cannot be scaled");
+        }
+        weights.emplace_back(0, bias_voltage / voltages.front());
+    } else {
+        auto upper = std::find_if(order.begin(), order.end(), [&](auto idx) { return voltages[idx] >= bias_voltage; });
+        if(upper == order.end() || (upper == order.begin() && voltages[*upper] > bias_voltage)) {
+            throw InvalidValueError(config_,
+                                    "bias_voltage",
+                                    "bias voltage outside of the range " + Units::display(voltages[order.front()], "V") +
+                                        " to " + Units::display(voltages[order.back()], "V") + " covered by the field maps");
+        }
+        if(voltages[*upper] == bias_voltage) {
+            weights.emplace_back(*upper, 1.0);
+        } else {
+            auto lower = *std::prev(upper);
+            auto fraction = (bias_voltage - voltages[lower]) / (voltages[*upper] - voltages[lower]);
+            weights.emplace_back(lower, 1.0 - fraction);
+            weights.emplace_back(*upper, fraction);
+        }
+    }
+
+    // Use the field map directly if no scaling is required
+    if(weights.size() == 1 && weights.front().second == 1.0) {
+        LOG(DEBUG) << "Using field map simulated at " << Units::display(bias_voltage, "V") << " without scaling";
+        return field_parser_.getByFileName(file_names[weights.front().first], "V/cm");
+    }
+
+    // Look for a field derived with the same maps and weights
+    std::stringstream key;
+    key << std::setprecision(17);
+    for(const auto& [idx, weight] : weights) {
+        key << std::filesystem::canonical(file_names[idx]).string() << ":" << weight << ";";
+    }
+    auto cached = bias_fields_.find(key.str());
+    if(cached != bias_fields_.end()) {
+        LOG(INFO) << "Using cached field for bias voltage " << Units::display(bias_voltage, "V");
+        return cached->second;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<std::vector<double>> data;
+    FieldData<double> reference;
+    bool copied = false;
+    for(const auto& [idx, weight] : weights) {
+        LOG(DEBUG) << "Adding field map simulated at " << Units::display(voltages[idx], "V") << " with weight " << weight;
+        auto field_map = field_parser_.getByFileName(file_names[idx], "V/cm");
+        field_parser_.release(file_names[idx]);
+        auto values = field_map.getData();
+
+        if(data == nullptr) {
+            reference = FieldData<double>(field_map.getHeader(), field_map.getDimensions(), field_map.getSize(), nullptr);
+            field_map = {};
+
+            // Scale the values of the first map in place unless they are still used by other module instantiations
+            copied = (values.use_count() > 1);
+            data = (copied ? std::make_shared<std::vector<double>>(*values) : std::move(values));
+            std::transform(data->begin(), data->end(), data->begin(), [w = weight](double value) { return w * value; });
+            continue;
+        }
+        if(field_map.getDimensions() != reference.getDimensions() || field_map.getSize() != reference.getSize()) {
+            throw InvalidValueError(
+                config_, "file_name", "field maps with different binning or size cannot be interpolated");
+        }
+        std::transform(data->begin(),
+                       data->end(),
+                       values->begin(),
+                       data->begin(),
+                       [w = weight](double derived, double value) { return derived + w * value; });
+    }
+    // Duration in internal units of nanoseconds
+    auto duration = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    double max_field = 0;
+    for(size_t i = 0; i + 2 < data->size(); i += 3) {
+        max_field = std::max(max_field, std::hypot((*data)[i], (*data)[i + 1], (*data)[i + 2]));
+    }
+    LOG(INFO) << "Derived field for bias voltage " << Units::display(bias_voltage, "V") << " from " << weights.size()
+              << " field map(s) in " << Units::display(duration, {"ms", "s"}) << " with a maximum field of "
+              << Units::display(max_field, "V/cm") << ", using " << (data->size() * sizeof(double) >> 20) << " MiB"
+              << (copied ? " for a copy of a field map in use elsewhere" : "");
+
+    FieldData<double> field_data(reference.getHeader(), reference.getDimensions(), reference.getSize(), data);
+    bias_fields_.emplace(key.str(), field_data);
+    return field_data;
+}
+
+/**
+ * Fields are identified by the field maps they are read from and, if scaled to the bias voltage, the bias voltage. The
+ * field data read from file and derived for the bias voltage is released from the caches after the conversion.
+ */
+FieldGridCache ElectricFieldReaderModule::field_grids_("electric field", "V/cm");
+std::pair<FieldData<double>, FieldGrid> ElectricFieldReaderModule::read_field_grid() {
+    auto file_names = config_.getPathArray("file_name", true);
+    std::stringstream key;
+    for(const auto& file_name : file_names) {
+        key << std::filesystem::canonical(file_name).string() << ":";
+    }
+    if(config_.has("field_bias_voltage")) {
+        key << std::setprecision(17) << config_.get<double>("bias_voltage");
+    }
+
+    return field_grids_.get(
+        key.str(),
+        config_.get<FieldPrecision>("field_precision", FieldPrecision::DOUBLE),
+        [&]() { return read_field(); },
+        [&](const FieldData<double>& field_data) {
+            for(const auto& file_name : file_names) {
+                field_parser_.release(file_name);
+            }
+            for(auto iter = bias_fields_.begin(); iter != bias_fields_.end();) {
+                iter = (iter->second.getData() == field_data.getData() ? bias_fields_.erase(iter) : std::next(iter));
+            }
+        });
+}
+
 void ElectricFieldReaderModule::create_output_plots() {
     LOG(TRACE) << "Creating output plots";
 
@@ -12,11 +12,13 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "core/config/Configuration.hpp"
 #include "core/geometry/GeometryManager.hpp"
 #include "core/messenger/Messenger.hpp"
+#include "tools/field_grid_cache.h"
 #include "tools/field_parser.h"
 
 #include "core/module/Module.hpp"
@@ -86,6 +88,20 @@ namespace allpix {
         FieldData<double> read_field();
         static FieldParser<double> field_parser_;
 
+        /**
+         * @brief Derive the field for the configured bias voltage from field maps simulated at other bias voltages
+         * @return Data of the field at the configured bias voltage
+         */
+        FieldData<double> read_bias_field();
+        static std::map<std::string, FieldData<double>> bias_fields_;
+
+        /**
+         * @brief Read the field and store its values with the configured precision
+         * @return Data of the field without values and the grid holding the values
+         */
+        std::pair<FieldData<double>, FieldGrid> read_field_grid();
+        static FieldGridCache field_grids_;
+
         /**
          * @brief Create output plots of the electric field profile
          */
@@ -478,23 +478,23 @@ GenericPropagationModule::propagate(Event* event,
     // Define lambda functions to compute the charge carrier velocity with or without magnetic field
     std::function<Eigen::Vector3d(double, const Eigen::Vector3d&)> carrier_velocity_noB =
         [&](double, const Eigen::Vector3d& cur_pos) -> Eigen::Vector3d {
-        auto raw_field = detector_->getElectricField(static_cast<ROOT::Math::XYZPoint>(cur_pos));
-        Eigen::Vector3d efield(raw_field.x(), raw_field.y(), raw_field.z());
-        auto doping = detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(cur_pos));
+        auto fields = detector_->getFields(static_cast<ROOT::Math::XYZPoint>(cur_pos));
+        Eigen::Vector3d efield(fields.electric_field.x(), fields.electric_field.y(), fields.electric_field.z());
+        auto doping = fields.doping_concentration;
 
         return static_cast<int>(type) * mobility_(type, efield.norm(), doping) * efield;
     };
 
     std::function<Eigen::Vector3d(double, const Eigen::Vector3d&)> carrier_velocity_withB =
         [&](double, const Eigen::Vector3d& cur_pos) -> Eigen::Vector3d {
-        auto raw_field = detector_->getElectricField(static_cast<ROOT::Math::XYZPoint>(cur_pos));
-        Eigen::Vector3d efield(raw_field.x(), raw_field.y(), raw_field.z());
+        auto fields = detector_->getFields(static_cast<ROOT::Math::XYZPoint>(cur_pos));
+        Eigen::Vector3d efield(fields.electric_field.x(), fields.electric_field.y(), fields.electric_field.z());
 
         Eigen::Vector3d velocity;
         auto magnetic_field = detector_->getMagneticField(static_cast<ROOT::Math::XYZPoint>(cur_pos));
         Eigen::Vector3d bfield(magnetic_field.x(), magnetic_field.y(), magnetic_field.z());
 
-        auto doping = detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(cur_pos));
+        auto doping = fields.doping_concentration;
 
         auto mob = mobility_(type, efield.norm(), doping);
         auto exb = efield.cross(bfield);
@@ -545,8 +545,9 @@ GenericPropagationModule::propagate(Event* event,
                    << Units::display(static_cast<ROOT::Math::XYZPoint>(position), {"um"});
 
         // Get electric field at current position and fall back to empty field if it does not exist
-        efield = detector_->getElectricField(static_cast<ROOT::Math::XYZPoint>(position));
-        auto doping = detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(position));
+        auto fields = detector_->getFields(static_cast<ROOT::Math::XYZPoint>(position));
+        efield = fields.electric_field;
+        auto doping = fields.doping_concentration;
 
         // Apply diffusion step
         auto diffusion = carrier_diffusion(std::sqrt(efield.Mag2()), doping, timestep);
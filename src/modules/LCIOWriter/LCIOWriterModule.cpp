@@ -251,10 +251,10 @@ void LCIOWriterModule::initialize() {
     lcWriter_->writeRunHeader(run.get());
 }
 
-void LCIOWriterModule::run(Event* event) {
+void LCIOWriterModule::prepare(Event* event) {
     auto pixel_messages = messenger_->fetchMultiMessage<PixelHitMessage>(this, event);
 
-    auto evt = std::make_unique<LCEventImpl>(); // create the event
+    auto evt = std::make_shared<LCEventImpl>(); // create the event
     evt->setRunNumber(1);
     evt->setEventNumber(static_cast<int>(event->number)); // set the event attributes
     evt->parameters().setValue("EventType", 2);
@@ -314,7 +314,7 @@ void LCIOWriterModule::run(Event* event) {
             LOG(DEBUG) << "X: " << hitdata.getPixel().getIndex().x() << ", Y:" << hitdata.getPixel().getIndex().y()
                        << ", Signal: " << hitdata.getSignal();
 
-            unsigned det_id = detector_names_to_id_[hit_msg->getDetector()->getName()];
+            unsigned det_id = detector_names_to_id_.at(hit_msg->getDetector()->getName());
 
             switch(pixel_type_) {
             case 1:                                                                               // EUTelSimpleSparsePixel
@@ -420,7 +420,7 @@ void LCIOWriterModule::run(Event* event) {
         auto det_id = det_id_name_pair.second;
         auto* hit = new TrackerDataImpl();
         hit->setChargeValues(charges[det_id]);
-        auto col_index = detector_ids_to_colllection_index_[det_id];
+        auto col_index = detector_ids_to_colllection_index_.at(det_id);
         (*output_col_encoder_vec[col_index])["sensorID"] = det_id;
         (*output_col_encoder_vec[col_index])["sparsePixelType"] = pixel_type_;
         output_col_encoder_vec[col_index]->setCellID(hit);
@@ -450,6 +450,12 @@ void LCIOWriterModule::run(Event* event) {
         evt->addCollection(output_col_vec[i], collection_names_vector_[i]);
     }
 
+    // The event is written to file in sequence
+    store_prepared(event, std::move(evt));
+}
+
+void LCIOWriterModule::run(Event* event) {
+    auto evt = take_prepared<std::shared_ptr<LCEventImpl>>(event);
     lcWriter_->writeEvent(evt.get()); // write the event to the file
     write_cnt_++;
 }
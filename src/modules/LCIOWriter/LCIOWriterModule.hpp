@@ -48,7 +48,12 @@ namespace allpix {
         void initialize() override;
 
         /**
-         * @brief Receive pixel hit messages, create lcio event, add hit collection and write event to file.
+         * @brief Receive pixel hit messages, create lcio event and add hit collection
+         */
+        void prepare(Event* event) override;
+
+        /**
+         * @brief Write the prepared lcio event to file
          */
         void run(Event* event) override;
 
@@ -11,12 +11,15 @@
 
 #include "ProjectionPropagationModule.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <functional>
 #include <limits>
 #include <string>
 #include <utility>
 
+#include "core/geometry/HexagonalPixelDetectorModel.hpp"
+#include "core/geometry/PixelDetectorModel.hpp"
 #include "core/messenger/Messenger.hpp"
 #include "core/utils/distributions.h"
 #include "core/utils/log.h"
@@ -46,6 +49,9 @@ ProjectionPropagationModule::ProjectionPropagationModule(Configuration& config,
     config_.setDefault<bool>("diffuse_deposit", false);
     config_.setDefault<bool>("repulsion_deposit", false);
     config_.setDefault<double>("repulsion_attenuation_factor", 0.1);
+    config_.setDefault<bool>("integrate_diffusion", false);
+    config_.setDefault<bool>("charge_fluctuations", true);
+    config_.setDefault<unsigned int>("distance", 1);
 
     config_.setDefault<std::string>("recombination_model", "none");
 
@@ -65,6 +71,9 @@ ProjectionPropagationModule::ProjectionPropagationModule(Configuration& config,
     repulse_attenuation_factor_ = config_.get<double>("repulsion_attenuation_factor");
     charge_per_step_ = config_.get<unsigned int>("charge_per_step");
     max_charge_groups_ = config_.get<unsigned int>("max_charge_groups");
+    integrate_diffusion_ = config_.get<bool>("integrate_diffusion");
+    charge_fluctuations_ = config_.get<bool>("charge_fluctuations");
+    integration_distance_ = config_.get<unsigned int>("distance");
 
     output_plots_ = config_.get<bool>("output_plots");
     output_linegraphs_ = config_.get<bool>("output_linegraphs");
@@ -119,6 +128,23 @@ void ProjectionPropagationModule::initialize() {
         LOG(WARNING) << "A magnetic field is switched on, but is set to be ignored for this module.";
     }
 
+    // Analytic charge sharing requires rectangular pixel cells to integrate the diffusion profile over
+    if(integrate_diffusion_) {
+        if(std::dynamic_pointer_cast<PixelDetectorModel>(model_) == nullptr ||
+           std::dynamic_pointer_cast<HexagonalPixelDetectorModel>(model_) != nullptr) {
+            throw InvalidValueError(
+                config_, "integrate_diffusion", "analytic integration is only supported for rectangular pixel geometries");
+        }
+        if(output_linegraphs_) {
+            throw InvalidCombinationError(config_,
+                                          {"integrate_diffusion", "output_linegraphs"},
+                                          "line graphs cannot be produced when integrating the diffusion analytically");
+        }
+        auto matrix_size = 2 * integration_distance_ + 1;
+        LOG(INFO) << "Integrating diffusion analytically over " << matrix_size << "x" << matrix_size << " pixels"
+                  << (charge_fluctuations_ ? " with" : " without") << " charge fluctuations";
+    }
+
     // Find correct top side
     if(detector_->getElectricField({0, 0, top_z_}).z() > detector_->getElectricField({0, 0, -top_z_}).z()) {
         top_z_ *= -1;
@@ -409,7 +435,7 @@ void ProjectionPropagationModule::run(Event* event) {
 
             
             auto repulsion_width = ROOT::Math::DisplacementVector3D<ROOT::Math::Cartesian3D<double>>(0,0,0);
-            if (repulse_deposit_){
+            if (repulse_deposit_ && !integrate_diffusion_){
              repulsion_width  = carrier_repulsion(deposit.getCharge(),drift_time,position); 
             };
             LOG(DEBUG) << "Repulsion width is " << Units::display(repulsion_width.X(),"um") ; 
@@ -424,6 +450,54 @@ void ProjectionPropagationModule::run(Event* event) {
                 continue;
             }
 
+            auto global_time = deposit.getGlobalTime() + propagation_time;
+            auto local_time = deposit.getLocalTime() + propagation_time;
+
+            if(integrate_diffusion_) {
+                // Only add if within requested integration time:
+                if(local_time > integration_time_) {
+                    LOG(DEBUG) << "Charge carriers propagation time not within integration time: "
+                               << Units::display(global_time, "ns") << " global / "
+                               << Units::display(local_time, {"ns", "ps"}) << " local";
+                    continue;
+                }
+
+                // Repulsion and diffusion are independent Gaussian smearings and are added in quadrature
+                double sigma = diffusion_std_dev;
+                if(repulse_deposit_) {
+                    auto repulsion_sigma = carrier_repulsion_sigma(deposit.getCharge(), drift_time, position);
+                    sigma = std::sqrt(diffusion_std_dev * diffusion_std_dev + repulsion_sigma * repulsion_sigma);
+                }
+
+                auto shares = integrate_diffusion(position, sigma, charge_per_step, event->getRandomEngine());
+                for(const auto& [pixel_index, charge] : shares) {
+                    auto center = model_->getPixelCenter(static_cast<unsigned int>(pixel_index.x()),
+                                                         static_cast<unsigned int>(pixel_index.y()));
+                    auto local_position = ROOT::Math::XYZPoint(center.x(), center.y(), top_z_);
+                    auto global_position = detector_->getGlobalPosition(local_position);
+
+                    propagated_charges.emplace_back(local_position,
+                                                    global_position,
+                                                    deposit.getType(),
+                                                    charge,
+                                                    local_time,
+                                                    global_time,
+                                                    CarrierState::HALTED,
+                                                    &deposit);
+
+                    LOG(DEBUG) << "Collected " << charge << " " << type << " in pixel " << pixel_index << " after "
+                               << Units::display(local_time, {"ns", "ps"}) << " local";
+                    projected_charge += charge;
+                }
+
+                if(output_plots_) {
+                    initial_position_histo_->Fill(static_cast<double>(Units::convert(initial_position.z(), "um")),
+                                                  charge_per_step);
+                    group_size_histo_->Fill(charge_per_step);
+                }
+                continue;
+            }
+
             allpix::normal_distribution<double> gauss_distribution(0, diffusion_std_dev);
             double diffusion_x = gauss_distribution(event->getRandomEngine());
             double diffusion_y = gauss_distribution(event->getRandomEngine());
@@ -431,9 +505,6 @@ void ProjectionPropagationModule::run(Event* event) {
             // Find projected position
             auto local_position = ROOT::Math::XYZPoint(position.x() + diffusion_x+repulsion_width.X(), position.y() + diffusion_y + repulsion_width.Y(), top_z_);
 
-            auto global_time = deposit.getGlobalTime() + propagation_time;
-            auto local_time = deposit.getLocalTime() + propagation_time;
-
             // Only add if within requested integration time:
             if(local_time > integration_time_) {
                 LOG(DEBUG) << "Charge carriers propagation time not within integration time: "
@@ -503,6 +574,71 @@ void ProjectionPropagationModule::run(Event* event) {
     messenger_->dispatchMessage(this, propagated_charge_message, event);
 }
 
+std::vector<std::pair<Pixel::Index, unsigned int>>
+ProjectionPropagationModule::integrate_diffusion(const ROOT::Math::XYZPoint& position,
+                                                 double sigma,
+                                                 unsigned int charge,
+                                                 RandomNumberGenerator& random_generator) const {
+    std::vector<std::pair<Pixel::Index, unsigned int>> shares;
+
+    auto seed = model_->getPixelIndex(position);
+
+    // Without any smearing, all charge carriers end up in the pixel below the projected position
+    if(sigma < std::numeric_limits<double>::epsilon()) {
+        if(model_->isWithinMatrix(seed)) {
+            shares.emplace_back(seed, charge);
+        }
+        return shares;
+    }
+
+    // Fraction of a 1D Gaussian centered at x with width sigma contained in the interval [low, high]
+    auto gauss_fraction = [sigma](double x, double low, double high) {
+        return 0.5 * (std::erf((high - x) / (M_SQRT2 * sigma)) - std::erf((low - x) / (M_SQRT2 * sigma)));
+    };
+
+    auto pitch = model_->getPixelSize();
+    std::vector<std::pair<Pixel::Index, double>> fractions;
+    for(const auto& pixel_index : model_->getNeighbors(seed, integration_distance_)) {
+        auto center =
+            model_->getPixelCenter(static_cast<unsigned int>(pixel_index.x()), static_cast<unsigned int>(pixel_index.y()));
+        auto fraction = gauss_fraction(position.x(), center.x() - pitch.x() / 2, center.x() + pitch.x() / 2) *
+                        gauss_fraction(position.y(), center.y() - pitch.y() / 2, center.y() + pitch.y() / 2);
+        if(fraction > 0) {
+            fractions.emplace_back(pixel_index, fraction);
+        }
+    }
+
+    if(charge_fluctuations_) {
+        // Sample a multinomial distribution as a sequence of conditional binomial draws. The probability not covered by
+        // the integrated pixels corresponds to charge carriers lost outside the considered area or the pixel matrix
+        auto charge_remaining = charge;
+        double probability_remaining = 1.;
+        for(const auto& [pixel_index, fraction] : fractions) {
+            if(charge_remaining == 0 || probability_remaining <= 0) {
+                break;
+            }
+            allpix::binomial_distribution<unsigned int> binomial(charge_remaining,
+                                                                 std::min(1., fraction / probability_remaining));
+            auto collected = binomial(random_generator);
+            charge_remaining -= collected;
+            probability_remaining -= fraction;
+            if(collected > 0) {
+                shares.emplace_back(pixel_index, collected);
+            }
+        }
+    } else {
+        // Deterministic sharing, rounded to the nearest integer number of charge carriers per pixel
+        for(const auto& [pixel_index, fraction] : fractions) {
+            auto collected = static_cast<unsigned int>(std::lround(fraction * charge));
+            if(collected > 0) {
+                shares.emplace_back(pixel_index, collected);
+            }
+        }
+    }
+
+    return shares;
+}
+
 void ProjectionPropagationModule::finalize() {
     if(output_plots_) {
         group_size_histo_->Get()->GetXaxis()->SetRange(1, group_size_histo_->Get()->GetNbinsX() + 1);
@@ -14,6 +14,8 @@
  */
 
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <TH1D.h>
 
@@ -71,6 +73,20 @@ namespace allpix {
         std::shared_ptr<const Detector> detector_;
         std::shared_ptr<DetectorModel> model_;
 
+        /**
+         * @brief Distribute a charge carrier group analytically over the pixels surrounding its projected position
+         * @param position Position of the charge carrier group on the sensor surface before diffusion
+         * @param sigma Combined width of the diffusion and repulsion smearing
+         * @param charge Number of charge carriers in the group
+         * @param random_generator Random number generator used for the charge fluctuations
+         * @return List of pixel indices and the number of charge carriers collected by each of them
+         */
+        std::vector<std::pair<Pixel::Index, unsigned int>>
+        integrate_diffusion(const ROOT::Math::XYZPoint& position,
+                            double sigma,
+                            unsigned int charge,
+                            RandomNumberGenerator& random_generator) const;
+
         // Config parameters
         bool output_plots_{}, output_linegraphs_{};
         double integration_time_{};
@@ -79,6 +95,9 @@ namespace allpix {
         double repulse_attenuation_factor_;
         unsigned int charge_per_step_{};
         unsigned int max_charge_groups_{};
+        bool integrate_diffusion_{};
+        bool charge_fluctuations_{};
+        unsigned int integration_distance_{};
 
         // Carrier type to be propagated
         CarrierType propagate_type_;
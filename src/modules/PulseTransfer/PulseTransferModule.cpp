@@ -15,6 +15,8 @@
 #include "objects/PixelCharge.hpp"
 #include "objects/exceptions.h"
 
+#include <map>
+#include <memory_resource>
 #include <set>
 #include <string>
 #include <utility>
@@ -95,8 +97,8 @@ void PulseTransferModule::run(Event* event) {
     auto propagated_message = messenger_->fetchMessage<PropagatedChargeMessage>(this, event);
 
     // Create map for all pixels: pulse and propagated charges
-    std::map<Pixel::Index, Pulse> pixel_pulse_map;
-    std::map<Pixel::Index, std::set<const PropagatedCharge*>> pixel_charge_map;
+    std::pmr::map<Pixel::Index, Pulse> pixel_pulse_map(event->getScratchResource());
+    std::pmr::map<Pixel::Index, std::set<const PropagatedCharge*>> pixel_charge_map(event->getScratchResource());
 
     LOG(DEBUG) << "Received " << propagated_message->getData().size() << " propagated charge objects.";
     for(const auto& propagated_charge : propagated_message->getData()) {
@@ -362,9 +362,40 @@ void RCEWriterModule::initialize() {
     write_proteus_config(device_path, geometry_path, detector_names, *geo_mgr_, *getConfigManager());
 }
 
-void RCEWriterModule::run(Event* event) {
+void RCEWriterModule::prepare(Event* event) {
     auto pixel_hit_messages = messenger_->fetchMultiMessage<PixelHitMessage>(this, event);
 
+    PreparedEvent prepared;
+
+    // Loop over the pixel hit messages
+    for(const auto& hit_msg : pixel_hit_messages) {
+        const auto& detector_name = hit_msg->getDetector()->getName();
+        auto& hits = prepared[detector_name];
+
+        // Loop over all the hits
+        for(const auto& hit : hit_msg->getData()) {
+            if(sensor_data::kMaxHits <= static_cast<Int_t>(hits.size())) {
+                LOG(ERROR) << "More than " << sensor_data::kMaxHits << " in detector " << detector_name;
+                continue;
+            }
+
+            // Assumes that time is correctly digitized
+            hits.push_back({hit.getPixel().getIndex().x(),
+                            hit.getPixel().getIndex().y(),
+                            static_cast<Int_t>(hit.getSignal()),
+                            static_cast<Int_t>(hit.getLocalTime())});
+
+            LOG(TRACE) << detector_name << " x=" << hit.getPixel().getIndex().x() << " y=" << hit.getPixel().getIndex().y()
+                       << " t=" << hit.getLocalTime() << " signal=" << hit.getSignal();
+        }
+    }
+
+    store_prepared(event, std::move(prepared));
+}
+
+void RCEWriterModule::run(Event* event) {
+    auto prepared = take_prepared<PreparedEvent>(event);
+
     // fill per-event data
     timestamp_ = 0;
     frame_number_ = event->number;
@@ -380,31 +411,18 @@ void RCEWriterModule::run(Event* event) {
         item.second.nhits_ = 0;
     }
 
-    // Loop over the pixel hit messages
-    for(const auto& hit_msg : pixel_hit_messages) {
-        const auto& detector_name = hit_msg->getDetector()->getName();
+    // Copy the prepared hits to the branch buffers
+    for(const auto& [detector_name, hits] : prepared) {
         auto& sensor = sensors_[detector_name];
-
-        // Loop over all the hits
-        for(const auto& hit : hit_msg->getData()) {
-            if(sensor_data::kMaxHits <= sensor.nhits_) {
-                LOG(ERROR) << "More than " << sensor_data::kMaxHits << " in detector " << detector_name;
-                continue;
-            }
-
-            // Fill the tree with received messages
+        for(const auto& hit : hits) {
             auto i = sensor.nhits_;
-            sensor.pix_x_[i] = hit.getPixel().getIndex().x();       // NOLINT
-            sensor.pix_y_[i] = hit.getPixel().getIndex().y();       // NOLINT
-            sensor.value_[i] = static_cast<Int_t>(hit.getSignal()); // NOLINT
-            // Assumes that time is correctly digitized
-            sensor.timing_[i] = static_cast<Int_t>(hit.getLocalTime()); // NOLINT
+            sensor.pix_x_[i] = hit.x;       // NOLINT
+            sensor.pix_y_[i] = hit.y;       // NOLINT
+            sensor.value_[i] = hit.value;   // NOLINT
+            sensor.timing_[i] = hit.timing; // NOLINT
             // This contains no useful information but it expected to be present
             sensor.hit_in_cluster_[i] = 0; // NOLINT
             sensor.nhits_ += 1;
-
-            LOG(TRACE) << detector_name << " x=" << hit.getPixel().getIndex().x() << " y=" << hit.getPixel().getIndex().y()
-                       << " t=" << hit.getLocalTime() << " signal=" << hit.getSignal();
         }
     }
 
@@ -11,6 +11,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include <TFile.h>
 #include <TTree.h>
@@ -54,7 +55,12 @@ namespace allpix {
         void initialize() override;
 
         /**
-         * @brief Writes the objects fetched to their specific tree
+         * @brief Collects the hit information of all pixel hits fetched
+         */
+        void prepare(Event* event) override;
+
+        /**
+         * @brief Writes the collected hits to their specific tree
          */
         void run(Event* event) override;
 
@@ -81,6 +87,15 @@ namespace allpix {
         // The map from detector names to the respective sensor_data struct
         std::map<std::string, sensor_data> sensors_;
 
+        // Hit information of an event waiting to be written, per detector name
+        struct hit_data {
+            Int_t x;
+            Int_t y;
+            Int_t value;
+            Int_t timing;
+        };
+        using PreparedEvent = std::map<std::string, std::vector<hit_data>>;
+
         // Relevant information for the Event tree
         ULong64_t timestamp_{};
         ULong64_t frame_number_{};
@@ -107,51 +107,59 @@ bool ROOTObjectWriterModule::filter(const std::shared_ptr<BaseMessage>& message,
     return true;
 }
 
-void ROOTObjectWriterModule::run(Event* event) {
-    auto root_lock = root_process_lock();
-
-    // Retrieve current object count:
-    auto object_count = TProcessID::GetObjectCount();
-
+void ROOTObjectWriterModule::prepare(Event* event) {
     // Fetch filtered messages
     auto messages = messenger_->fetchFilteredMessages(this, event);
 
-    // Mark objects to be stored:
+    PreparedEvent prepared;
+    prepared.reserve(messages.size());
     for(auto& pair : messages) {
         auto& message = pair.first;
+        auto& prepared_message = prepared.emplace_back();
+
+        // Get the detector name
+        if(message->getDetector() != nullptr) {
+            prepared_message.detector_name = message->getDetector()->getName();
+        }
+        prepared_message.message_name = pair.second;
+
+        // Read the object and mark it to be stored, object_array emptiness is checked in the filter
         auto object_array = message->getObjectArray();
+        const Object& first_object = object_array[0];
+        prepared_message.type = typeid(first_object);
+        prepared_message.objects.reserve(object_array.size());
         for(Object& object : object_array) {
             object.markForStorage();
+            prepared_message.objects.push_back(&object);
         }
     }
 
+    store_prepared(event, std::move(prepared));
+}
+
+void ROOTObjectWriterModule::run(Event* event) {
+    auto prepared = take_prepared<PreparedEvent>(event);
+
+    auto root_lock = root_process_lock();
+
+    // Retrieve current object count:
+    auto object_count = TProcessID::GetObjectCount();
+
     // Add event data
     current_event_ = event->number;
     current_seed_ = event->getSeed();
 
     // Generate trees and index data
-    for(auto& pair : messages) {
-        auto& message = pair.first;
-        auto& message_name = pair.second;
-
-        // Get the detector name
-        std::string detector_name;
-        if(message->getDetector() != nullptr) {
-            detector_name = message->getDetector()->getName();
-        }
-
-        // Read the object
-        auto object_array = message->getObjectArray();
-        // object_array emptiness is checked in the filter
-        const Object& first_object = object_array[0];
-        std::type_index type_idx = typeid(first_object);
+    for(auto& prepared_message : prepared) {
+        const auto& detector_name = prepared_message.detector_name;
+        const auto& message_name = prepared_message.message_name;
 
         // Create a new branch of the correct type if this message was not received before
-        auto index_tuple = std::make_tuple(type_idx, detector_name, message_name);
+        auto index_tuple = std::make_tuple(prepared_message.type, detector_name, message_name);
         if(write_list_.find(index_tuple) == write_list_.end()) {
 
-            std::string class_name = allpix::demangle(typeid(first_object).name());
-            std::string class_name_with_namespace = allpix::demangle(typeid(first_object).name(), true);
+            std::string class_name = allpix::demangle(prepared_message.type.name());
+            std::string class_name_with_namespace = allpix::demangle(prepared_message.type.name(), true);
 
             // Add vector of objects to write to the write list
             write_list_[index_tuple] = new std::vector<Object*>();
@@ -194,11 +202,12 @@ void ROOTObjectWriterModule::run(Event* event) {
         }
 
         // Fill the branch vector
-        for(Object& object : object_array) {
+        auto* write_list = write_list_[index_tuple];
+        for(auto* object : prepared_message.objects) {
             // Trigger the creation of TRefs for cross-object references to be able to store them to file.
-            object.petrifyHistory();
+            object->petrifyHistory();
             ++write_cnt_;
-            write_list_[index_tuple]->push_back(&object);
+            write_list->push_back(object);
         }
     }
 
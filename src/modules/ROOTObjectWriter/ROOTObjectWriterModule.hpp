@@ -12,6 +12,8 @@
 #include <atomic>
 #include <map>
 #include <string>
+#include <typeindex>
+#include <vector>
 
 #include <TFile.h>
 #include <TTree.h>
@@ -57,6 +59,11 @@ namespace allpix {
          */
         void initialize() override;
 
+        /**
+         * @brief Marks the objects fetched for storage and groups them by type, detector and message name
+         */
+        void prepare(Event* event) override;
+
         /**
          * @brief Writes the objects fetched to their specific tree, constructing trees on the fly for new objects.
          */
@@ -92,6 +99,15 @@ namespace allpix {
         // List of objects of a particular type, bound to a specific detector and having a particular name
         std::map<std::tuple<std::type_index, std::string, std::string>, std::vector<Object*>*> write_list_;
 
+        // Objects of a message waiting to be written, with the information to select their branch
+        struct PreparedMessage {
+            std::type_index type{typeid(void)};
+            std::string detector_name;
+            std::string message_name;
+            std::vector<Object*> objects;
+        };
+        using PreparedEvent = std::vector<PreparedMessage>;
+
         // Statistical information about number of objects
         std::atomic<unsigned long> write_cnt_{};
     };
@@ -13,7 +13,9 @@
 
 #include <fstream>
 #include <limits>
+#include <map>
 #include <memory>
+#include <memory_resource>
 #include <new>
 #include <stdexcept>
 #include <string>
@@ -93,7 +95,7 @@ void SimpleTransferModule::run(Event* event) {
     // Find corresponding pixels for all propagated charges
     LOG(TRACE) << "Transferring charges to pixels";
     unsigned int transferred_charges_count = 0;
-    std::map<Pixel::Index, std::vector<const PropagatedCharge*>> pixel_map;
+    std::pmr::map<Pixel::Index, std::vector<const PropagatedCharge*>> pixel_map(event->getScratchResource());
     for(const auto& propagated_charge : propagated_message->getData()) {
         auto position = propagated_charge.getLocalPosition();
 
@@ -0,0 +1,540 @@
+/**
+ * @file
+ * @brief Implementation of surrogate charge propagation module sampling from tabulated drift results
+ *
+ * @copyright Copyright (c) 2023 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "SurrogatePropagationModule.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include <Eigen/Core>
+
+#include "core/utils/distributions.h"
+#include "core/utils/log.h"
+#include "core/utils/unit.h"
+#include "tools/ROOT.h"
+#include "tools/runge_kutta.h"
+
+using namespace allpix;
+
+SurrogatePropagationModule::SurrogatePropagationModule(Configuration& config,
+                                                       Messenger* messenger,
+                                                       std::shared_ptr<Detector> detector)
+    : Module(config, detector), messenger_(messenger), detector_(std::move(detector)) {
+    // Save detector model
+    model_ = detector_->getModel();
+
+    // Require deposits message for single detector
+    messenger_->bindSingle<DepositedChargeMessage>(this, MsgFlags::REQUIRED);
+
+    // Set default value for config variables
+    config_.setDefault<double>("spatial_precision", Units::get(0.25, "nm"));
+    config_.setDefault<double>("timestep_start", Units::get(0.01, "ns"));
+    config_.setDefault<double>("timestep_min", Units::get(0.001, "ns"));
+    config_.setDefault<double>("timestep_max", Units::get(0.5, "ns"));
+    config_.setDefault<double>("integration_time", Units::get(25, "ns"));
+    config_.setDefault<unsigned int>("charge_per_step", 10);
+    config_.setDefault<unsigned int>("max_charge_groups", 1000);
+    config_.setDefault<double>("temperature", 293.15);
+
+    // Models:
+    config_.setDefault<std::string>("mobility_model", "jacoboni");
+    config_.setDefault<std::string>("recombination_model", "none");
+    config_.setDefault<std::string>("trapping_model", "none");
+    config_.setDefault<std::string>("detrapping_model", "none");
+
+    config_.setDefault<bool>("propagate_electrons", true);
+    config_.setDefault<bool>("propagate_holes", false);
+    config_.setDefault<bool>("ignore_magnetic_field", false);
+
+    // Granularity of the lookup table
+    config_.setDefault<ROOT::Math::XYZVector>("table_bins", ROOT::Math::XYZVector(10, 10, 10));
+    config_.setDefault<unsigned int>("table_samples", 100);
+
+    // Copy some variables from configuration to avoid lookups:
+    temperature_ = config_.get<double>("temperature");
+    timestep_min_ = config_.get<double>("timestep_min");
+    timestep_max_ = config_.get<double>("timestep_max");
+    timestep_start_ = config_.get<double>("timestep_start");
+    integration_time_ = config_.get<double>("integration_time");
+    target_spatial_precision_ = config_.get<double>("spatial_precision");
+    propagate_electrons_ = config_.get<bool>("propagate_electrons");
+    propagate_holes_ = config_.get<bool>("propagate_holes");
+    charge_per_step_ = config_.get<unsigned int>("charge_per_step");
+    max_charge_groups_ = config_.get<unsigned int>("max_charge_groups");
+
+    // Enable multithreading of this module if multithreading is enabled
+    allow_multithreading();
+
+    // Parameter for charge transport in magnetic field (approximated from graphs:
+    // http://www.ioffe.ru/SVA/NSM/Semicond/Si/electric.html)
+    electron_Hall_ = 1.15;
+    hole_Hall_ = 0.9;
+
+    // Precalculate the Boltzmann constant times the temperature
+    boltzmann_kT_ = Units::get(8.6173333e-5, "eV/K") * temperature_;
+}
+
+void SurrogatePropagationModule::initialize() {
+
+    // Check for electric field and output warning for slow propagation if not defined
+    if(!detector_->hasElectricField()) {
+        LOG(WARNING) << "This detector does not have an electric field.";
+    }
+
+    if(!propagate_electrons_ && !propagate_holes_) {
+        throw InvalidValueError(
+            config_, "propagate_electrons", "Not propagating any charge carrier type, at least one has to be enabled");
+    }
+
+    // Check for magnetic field
+    has_magnetic_field_ = detector_->hasMagneticField();
+    if(has_magnetic_field_) {
+        if(config_.get<bool>("ignore_magnetic_field")) {
+            has_magnetic_field_ = false;
+            LOG(WARNING) << "A magnetic field is switched on, but is set to be ignored for this module.";
+        } else {
+            LOG(DEBUG) << "This detector sees a magnetic field.";
+        }
+    }
+
+    // Prepare physics models
+    mobility_ = Mobility(config_, model_->getSensorMaterial(), detector_->hasDopingProfile());
+    recombination_ = Recombination(config_, detector_->hasDopingProfile());
+    trapping_ = Trapping(config_);
+    detrapping_ = Detrapping(config_);
+
+    // Tabulate the central pixel of the matrix to stay clear of edge effects
+    reference_pixel_ = Pixel::Index(model_->getNPixels().x() / 2, model_->getNPixels().y() / 2);
+
+    // Attempt to read the lookup table from the cache file if it exists and matches the configuration
+    auto header = table_header();
+    if(config_.has("cache_file")) {
+        auto cache_file = config_.getPath("cache_file");
+        if(std::filesystem::exists(cache_file)) {
+            LOG(INFO) << "Reading lookup table from cache file " << cache_file;
+            std::ifstream file(cache_file, std::ios::binary);
+            try {
+                cereal::PortableBinaryInputArchive archive(file);
+                archive(table_);
+            } catch(cereal::Exception& e) {
+                throw InvalidValueError(config_, "cache_file", "could not read lookup table: " + std::string(e.what()));
+            }
+
+            if(table_.getHeader() == header) {
+                return;
+            }
+            LOG(WARNING) << "Cached lookup table has been generated with different parameters, regenerating";
+        }
+    }
+
+    generate_table();
+
+    // Store the lookup table for later use if requested
+    if(config_.has("cache_file")) {
+        auto cache_file = config_.getPath("cache_file");
+        LOG(INFO) << "Writing lookup table to cache file " << cache_file;
+        std::ofstream file(cache_file, std::ios::binary);
+        try {
+            cereal::PortableBinaryOutputArchive archive(file);
+            archive(table_);
+        } catch(cereal::Exception& e) {
+            throw InvalidValueError(config_, "cache_file", "could not write lookup table: " + std::string(e.what()));
+        }
+    }
+}
+
+std::string SurrogatePropagationModule::table_header() const {
+    // Collect all parameters which influence the propagation outcome
+    std::stringstream header;
+    header << "SurrogatePropagation " << model_->getType() << " " << allpix::to_string(detector_->getElectricFieldType())
+           << " " << detector_->hasDopingProfile() << " " << has_magnetic_field_;
+    for(const auto& key : {"table_bins",
+                           "table_samples",
+                           "temperature",
+                           "integration_time",
+                           "spatial_precision",
+                           "timestep_start",
+                           "timestep_min",
+                           "timestep_max",
+                           "mobility_model",
+                           "recombination_model",
+                           "trapping_model",
+                           "detrapping_model",
+                           "fluence",
+                           "propagate_electrons",
+                           "propagate_holes"}) {
+        header << " " << key << "=" << config_.getText(key, "");
+    }
+
+    // Fingerprint of the fields the charge carriers are propagated in, sampled around the reference pixel such that tables
+    // are regenerated whenever field maps, bias voltage or magnetic field change. FNV-1a hash of the sampled values.
+    uint64_t hash = 14695981039346656037ULL;
+    auto add_to_hash = [&hash](double value) {
+        unsigned char bytes[sizeof(double)];
+        std::memcpy(bytes, &value, sizeof(double));
+        for(auto byte : bytes) {
+            hash = (hash ^ byte) * 1099511628211ULL;
+        }
+    };
+
+    const size_t steps = 24;
+    auto pixel_center = model_->getPixelCenter(reference_pixel_.x(), reference_pixel_.y());
+    auto pitch = model_->getPixelSize();
+    auto thickness = model_->getSensorSize().z();
+    auto sensor_bottom = model_->getSensorCenter().z() - thickness / 2;
+    for(size_t x = 0; x < steps; x++) {
+        for(size_t y = 0; y < steps; y++) {
+            for(size_t z = 0; z < steps; z++) {
+                // Cover the reference pixel and its direct neighbors
+                auto position = ROOT::Math::XYZPoint(
+                    pixel_center.x() + 3 * pitch.x() * ((static_cast<double>(x) + 0.5) / steps - 0.5),
+                    pixel_center.y() + 3 * pitch.y() * ((static_cast<double>(y) + 0.5) / steps - 0.5),
+                    sensor_bottom + thickness * (static_cast<double>(z) + 0.5) / steps);
+                auto efield = detector_->getElectricField(position);
+                add_to_hash(efield.x());
+                add_to_hash(efield.y());
+                add_to_hash(efield.z());
+                if(detector_->hasDopingProfile()) {
+                    add_to_hash(detector_->getDopingConcentration(position));
+                }
+            }
+        }
+    }
+    if(has_magnetic_field_) {
+        auto bfield = detector_->getMagneticField(pixel_center);
+        add_to_hash(bfield.x());
+        add_to_hash(bfield.y());
+        add_to_hash(bfield.z());
+    }
+    header << " fields=" << std::hex << hash;
+
+    return header.str();
+}
+
+void SurrogatePropagationModule::generate_table() {
+    auto bins_config = config_.get<ROOT::Math::XYZVector>("table_bins");
+    if(bins_config.x() < 1 || bins_config.y() < 1 || bins_config.z() < 1) {
+        throw InvalidValueError(config_, "table_bins", "number of bins needs to be positive in all dimensions");
+    }
+    std::array<size_t, 3> bins = {static_cast<size_t>(bins_config.x()),
+                                  static_cast<size_t>(bins_config.y()),
+                                  static_cast<size_t>(bins_config.z())};
+    auto samples = config_.get<unsigned int>("table_samples");
+    if(samples == 0) {
+        throw InvalidValueError(config_, "table_samples", "at least one sample per voxel is required");
+    }
+
+    LOG(STATUS) << "Generating lookup table with " << bins[0] << "x" << bins[1] << "x" << bins[2] << " voxels and "
+                << samples << " samples per voxel";
+    table_ = SurrogateTable(table_header(), bins, samples);
+
+    // Seed from the global random seed to obtain reproducible tables
+    RandomNumberGenerator random_generator;
+    random_generator.seed(getConfigManager()->getGlobalConfiguration().get<uint64_t>("random_seed"));
+    allpix::uniform_real_distribution<double> uniform_distribution(0, 1);
+
+    auto pixel_center = model_->getPixelCenter(reference_pixel_.x(), reference_pixel_.y());
+    auto pitch = model_->getPixelSize();
+    auto thickness = model_->getSensorSize().z();
+    auto sensor_bottom = model_->getSensorCenter().z() - thickness / 2;
+
+    for(const auto& type : {CarrierType::ELECTRON, CarrierType::HOLE}) {
+        if((type == CarrierType::ELECTRON && !propagate_electrons_) || (type == CarrierType::HOLE && !propagate_holes_)) {
+            continue;
+        }
+
+        for(size_t z = 0; z < bins[2]; z++) {
+            for(size_t y = 0; y < bins[1]; y++) {
+                for(size_t x = 0; x < bins[0]; x++) {
+                    for(size_t sample = 0; sample < samples; sample++) {
+                        // Draw a random start position within the voxel
+                        auto start = ROOT::Math::XYZPoint(
+                            pixel_center.x() +
+                                ((static_cast<double>(x) + uniform_distribution(random_generator)) / bins[0] - 0.5) *
+                                    pitch.x(),
+                            pixel_center.y() +
+                                ((static_cast<double>(y) + uniform_distribution(random_generator)) / bins[1] - 0.5) *
+                                    pitch.y(),
+                            sensor_bottom +
+                                (static_cast<double>(z) + uniform_distribution(random_generator)) / bins[2] * thickness);
+
+                        auto [end, time, state] = propagate(start, type, random_generator);
+
+                        auto& entry = table_.at(type, x, y, z, sample);
+                        entry.dx = end.x() - start.x();
+                        entry.dy = end.y() - start.y();
+                        entry.z = end.z();
+                        entry.time = time;
+                        entry.state = state;
+                    }
+                }
+            }
+        }
+    }
+
+    LOG(INFO) << "Generated lookup table for pixel " << reference_pixel_ << ", relative statistical uncertainty of "
+              << (100. / std::sqrt(samples)) << "% per voxel";
+}
+
+void SurrogatePropagationModule::run(Event* event) {
+    auto deposits_message = messenger_->fetchMessage<DepositedChargeMessage>(this, event);
+
+    // Create vector of propagated charges to output
+    std::vector<PropagatedCharge> propagated_charges;
+    unsigned int propagated_charges_count = 0;
+
+    allpix::uniform_real_distribution<double> uniform_distribution(0, 1);
+
+    const auto& bins = table_.getBins();
+    auto pitch = model_->getPixelSize();
+    auto thickness = model_->getSensorSize().z();
+    auto sensor_bottom = model_->getSensorCenter().z() - thickness / 2;
+
+    // Find the voxel index along one axis, clamped to the table range
+    auto voxel = [](double fraction, size_t nbins) {
+        auto index = static_cast<long>(std::floor(fraction * static_cast<double>(nbins)));
+        return static_cast<size_t>(std::clamp(index, 0l, static_cast<long>(nbins) - 1));
+    };
+
+    for(const auto& deposit : deposits_message->getData()) {
+
+        if((deposit.getType() == CarrierType::ELECTRON && !propagate_electrons_) ||
+           (deposit.getType() == CarrierType::HOLE && !propagate_holes_)) {
+            LOG(DEBUG) << "Skipping charge carriers (" << deposit.getType() << ") on "
+                       << Units::display(deposit.getLocalPosition(), {"mm", "um"});
+            continue;
+        }
+
+        // Only process if within requested integration time:
+        if(deposit.getLocalTime() > integration_time_) {
+            LOG(DEBUG) << "Skipping charge carriers deposited beyond integration time: "
+                       << Units::display(deposit.getGlobalTime(), "ns") << " global / "
+                       << Units::display(deposit.getLocalTime(), {"ns", "ps"}) << " local";
+            continue;
+        }
+
+        // Find the voxel of the deposit within its pixel cell
+        auto position = deposit.getLocalPosition();
+        auto [xpixel, ypixel] = model_->getPixelIndex(position);
+        auto center = model_->getPixelCenter(xpixel, ypixel);
+        auto voxel_x = voxel((position.x() - center.x()) / pitch.x() + 0.5, bins[0]);
+        auto voxel_y = voxel((position.y() - center.y()) / pitch.y() + 0.5, bins[1]);
+        auto voxel_z = voxel((position.z() - sensor_bottom) / thickness, bins[2]);
+
+        LOG(DEBUG) << "Set of charge carriers (" << deposit.getType() << ") on "
+                   << Units::display(position, {"mm", "um"}) << " in voxel " << voxel_x << "," << voxel_y << ","
+                   << voxel_z;
+
+        unsigned int charges_remaining = deposit.getCharge();
+        auto charge_per_step = charge_per_step_;
+        if(max_charge_groups_ > 0 && deposit.getCharge() / charge_per_step > max_charge_groups_) {
+            charge_per_step = static_cast<unsigned int>(ceil(static_cast<double>(deposit.getCharge()) / max_charge_groups_));
+        }
+        while(charges_remaining > 0) {
+            // Define number of charges to be propagated and remove charges of this step from the total
+            if(charge_per_step > charges_remaining) {
+                charge_per_step = charges_remaining;
+            }
+            charges_remaining -= charge_per_step;
+
+            // Sample the final state of this charge carrier group from the table
+            auto sample = std::min(static_cast<size_t>(uniform_distribution(event->getRandomEngine()) *
+                                                       static_cast<double>(table_.getSamples())),
+                                   table_.getSamples() - 1);
+            const auto& entry = table_.at(deposit.getType(), voxel_x, voxel_y, voxel_z, sample);
+
+            // Carriers still in motion at the end of the integration time of this deposit keep their state
+            auto state = entry.state;
+            auto time = entry.time;
+            if(deposit.getLocalTime() + time > integration_time_) {
+                state = CarrierState::MOTION;
+                time = integration_time_ - deposit.getLocalTime();
+            }
+
+            auto local_position = ROOT::Math::XYZPoint(position.x() + entry.dx, position.y() + entry.dy, entry.z);
+            auto global_position = detector_->getGlobalPosition(local_position);
+
+            LOG(TRACE) << "Propagated " << charge_per_step << " to " << Units::display(local_position, {"mm", "um"})
+                       << " in " << Units::display(time, "ns") << " time, final state: " << allpix::to_string(state);
+
+            propagated_charges.emplace_back(local_position,
+                                            global_position,
+                                            deposit.getType(),
+                                            charge_per_step,
+                                            deposit.getLocalTime() + time,
+                                            deposit.getGlobalTime() + time,
+                                            state,
+                                            &deposit);
+            propagated_charges_count += charge_per_step;
+            total_charge_groups_++;
+        }
+    }
+
+    LOG(INFO) << "Propagated " << propagated_charges_count << " charges using the lookup table";
+    total_propagated_charges_ += propagated_charges_count;
+
+    // Create a new message with propagated charges
+    auto propagated_charge_message = std::make_shared<PropagatedChargeMessage>(std::move(propagated_charges), detector_);
+
+    // Dispatch the message with propagated charges
+    messenger_->dispatchMessage(this, propagated_charge_message, event);
+}
+
+/**
+ * Propagation of a single charge carrier follows the approach of the GenericPropagation module: a Runge-Kutta integration
+ * with adaptive step size is performed, adding a random diffusion in every step, and recombination as well as trapping are
+ * evaluated after each step.
+ */
+std::tuple<ROOT::Math::XYZPoint, double, CarrierState> SurrogatePropagationModule::propagate(
+    const ROOT::Math::XYZPoint& pos, const CarrierType& type, RandomNumberGenerator& random_generator) const {
+
+    Eigen::Vector3d position(pos.x(), pos.y(), pos.z());
+
+    // Define a function to compute the diffusion
+    auto carrier_diffusion = [&](double efield_mag, double doping_concentration, double timestep) -> Eigen::Vector3d {
+        double diffusion_constant = boltzmann_kT_ * mobility_(type, efield_mag, doping_concentration);
+        double diffusion_std_dev = std::sqrt(2. * diffusion_constant * timestep);
+
+        // Compute the independent diffusion in three
+        allpix::normal_distribution<double> gauss_distribution(0, diffusion_std_dev);
+        auto x = gauss_distribution(random_generator);
+        auto y = gauss_distribution(random_generator);
+        auto z = gauss_distribution(random_generator);
+        return Eigen::Vector3d(x, y, z);
+    };
+
+    // Survival or detrap probability of this charge carrier, evaluated at every step
+    allpix::uniform_real_distribution<double> uniform_distribution(0, 1);
+
+    // Define lambda functions to compute the charge carrier velocity with or without magnetic field
+    std::function<Eigen::Vector3d(double, const Eigen::Vector3d&)> carrier_velocity_noB =
+        [&](double, const Eigen::Vector3d& cur_pos) -> Eigen::Vector3d {
+        auto fields = detector_->getFields(static_cast<ROOT::Math::XYZPoint>(cur_pos));
+        Eigen::Vector3d efield(fields.electric_field.x(), fields.electric_field.y(), fields.electric_field.z());
+        auto doping = fields.doping_concentration;
+
+        return static_cast<int>(type) * mobility_(type, efield.norm(), doping) * efield;
+    };
+
+    std::function<Eigen::Vector3d(double, const Eigen::Vector3d&)> carrier_velocity_withB =
+        [&](double, const Eigen::Vector3d& cur_pos) -> Eigen::Vector3d {
+        auto fields = detector_->getFields(static_cast<ROOT::Math::XYZPoint>(cur_pos));
+        Eigen::Vector3d efield(fields.electric_field.x(), fields.electric_field.y(), fields.electric_field.z());
+
+        auto magnetic_field = detector_->getMagneticField(static_cast<ROOT::Math::XYZPoint>(cur_pos));
+        Eigen::Vector3d bfield(magnetic_field.x(), magnetic_field.y(), magnetic_field.z());
+
+        auto doping = fields.doping_concentration;
+
+        auto mob = mobility_(type, efield.norm(), doping);
+        auto exb = efield.cross(bfield);
+
+        Eigen::Vector3d term1;
+        double hallFactor = (type == CarrierType::ELECTRON ? electron_Hall_ : hole_Hall_);
+        term1 = static_cast<int>(type) * mob * hallFactor * exb;
+
+        Eigen::Vector3d term2 = mob * mob * hallFactor * hallFactor * efield.dot(bfield) * bfield;
+
+        auto rnorm = 1 + mob * mob * hallFactor * hallFactor * bfield.dot(bfield);
+        return static_cast<int>(type) * mob * (efield + term1 + term2) / rnorm;
+    };
+
+    // Create the runge kutta solver with an RKF5 tableau
+    auto runge_kutta = make_runge_kutta(
+        tableau::RK5, (has_magnetic_field_ ? carrier_velocity_withB : carrier_velocity_noB), timestep_start_, position);
+
+    // Continue propagation until the carrier is outside the sensor or has reached a final state
+    Eigen::Vector3d last_position = position;
+    ROOT::Math::XYZVector efield{};
+    auto state = CarrierState::MOTION;
+    while(state == CarrierState::MOTION && runge_kutta.getTime() < integration_time_) {
+        last_position = position;
+
+        // Execute a Runge Kutta step
+        auto step = runge_kutta.step();
+
+        // Get the current result and timestep
+        auto timestep = runge_kutta.getTimeStep();
+        position = runge_kutta.getValue();
+
+        // Get electric field at current position and fall back to empty field if it does not exist
+        auto fields = detector_->getFields(static_cast<ROOT::Math::XYZPoint>(position));
+        efield = fields.electric_field;
+        auto doping = fields.doping_concentration;
+
+        // Apply diffusion step
+        auto diffusion = carrier_diffusion(std::sqrt(efield.Mag2()), doping, timestep);
+        position += diffusion;
+        runge_kutta.setValue(position);
+
+        // Check if we are still in the sensor and not in an implant:
+        if(!model_->isWithinSensor(static_cast<ROOT::Math::XYZPoint>(position)) ||
+           model_->isWithinImplant(static_cast<ROOT::Math::XYZPoint>(position))) {
+            state = CarrierState::HALTED;
+        }
+
+        // Check if charge carrier is still alive:
+        if(recombination_(type,
+                          detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(position)),
+                          uniform_distribution(random_generator),
+                          timestep)) {
+            state = CarrierState::RECOMBINED;
+        }
+
+        // Check if the charge carrier has been trapped:
+        if(trapping_(type, uniform_distribution(random_generator), timestep, std::sqrt(efield.Mag2()))) {
+            auto detrap_time = detrapping_(type, uniform_distribution(random_generator), std::sqrt(efield.Mag2()));
+            if((runge_kutta.getTime() + detrap_time) < integration_time_) {
+                runge_kutta.advanceTime(detrap_time);
+            } else {
+                state = CarrierState::TRAPPED;
+            }
+        }
+
+        // Adapt step size to match target precision
+        double uncertainty = step.error.norm();
+
+        // Lower timestep when reaching the sensor edge
+        if(std::fabs(model_->getSensorSize().z() / 2.0 - position.z()) < 2 * step.value.z()) {
+            timestep *= 0.75;
+        } else {
+            if(uncertainty > target_spatial_precision_) {
+                timestep *= 0.75;
+            } else if(2 * uncertainty < target_spatial_precision_) {
+                timestep *= 1.5;
+            }
+        }
+        // Limit the timestep to certain minimum and maximum step sizes
+        timestep = std::clamp(timestep, timestep_min_, timestep_max_);
+        runge_kutta.setTimeStep(timestep);
+    }
+
+    // Find proper final position in the sensor
+    if(state == CarrierState::HALTED && !model_->isWithinSensor(static_cast<ROOT::Math::XYZPoint>(position))) {
+        auto intercept = model_->getSensorIntercept(static_cast<ROOT::Math::XYZPoint>(last_position),
+                                                    static_cast<ROOT::Math::XYZPoint>(position));
+        position = Eigen::Vector3d(intercept.x(), intercept.y(), intercept.z());
+    }
+
+    return {static_cast<ROOT::Math::XYZPoint>(position), runge_kutta.getTime(), state};
+}
+
+void SurrogatePropagationModule::finalize() {
+    LOG(INFO) << "Propagated total of " << total_propagated_charges_ << " charges in " << total_charge_groups_
+              << " groups using the lookup table";
+}
@@ -0,0 +1,132 @@
+/**
+ * @file
+ * @brief Definition of surrogate charge propagation module sampling from tabulated drift results
+ *
+ * @copyright Copyright (c) 2023 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Math/Point3D.h>
+
+#include "core/config/Configuration.hpp"
+#include "core/geometry/DetectorModel.hpp"
+#include "core/messenger/Messenger.hpp"
+#include "core/module/Event.hpp"
+#include "core/module/Module.hpp"
+
+#include "objects/DepositedCharge.hpp"
+#include "objects/PropagatedCharge.hpp"
+
+#include "physics/Detrapping.hpp"
+#include "physics/Mobility.hpp"
+#include "physics/Recombination.hpp"
+#include "physics/Trapping.hpp"
+
+#include "SurrogateTable.hpp"
+
+namespace allpix {
+
+    /**
+     * @ingroup Modules
+     * @brief Module for fast propagation of charge carriers by sampling from tabulated drift-diffusion results
+     * @note This module supports multithreading
+     *
+     * At initialization, single charge carriers are propagated from a grid of start voxels within one pixel cell using the
+     * same Runge-Kutta drift and diffusion approach as the GenericPropagation module. The resulting end positions, arrival
+     * times and final states are stored in a lookup table, which can be cached to disk. During the event loop, the final
+     * state of every charge carrier group is sampled from the table entries of the voxel it has been deposited in.
+     */
+    class SurrogatePropagationModule : public Module {
+    public:
+        /**
+         * @brief Constructor for this detector-specific module
+         * @param config Configuration object for this module as retrieved from the steering file
+         * @param messenger Pointer to the messenger object to allow binding to messages on the bus
+         * @param detector Pointer to the detector for this module instance
+         */
+        SurrogatePropagationModule(Configuration& config, Messenger* messenger, std::shared_ptr<Detector> detector);
+
+        /**
+         * @brief Initialize the physics models and generate or load the lookup table
+         */
+        void initialize() override;
+
+        /**
+         * @brief Propagate all deposited charges by sampling from the lookup table
+         */
+        void run(Event*) override;
+
+        /**
+         * @brief Write statistical summary
+         */
+        void finalize() override;
+
+    private:
+        Messenger* messenger_;
+
+        // General module members
+        std::shared_ptr<const Detector> detector_;
+        std::shared_ptr<DetectorModel> model_;
+
+        /**
+         * @brief Fingerprint of all parameters the lookup table depends on
+         * @return Header string to identify compatible tables
+         */
+        std::string table_header() const;
+
+        /**
+         * @brief Fill the lookup table by propagating charge carriers from every voxel of the pixel cell
+         */
+        void generate_table();
+
+        /**
+         * @brief Propagate a single charge carrier through the sensor
+         * @param pos Start position in local coordinates
+         * @param type Type of the charge carrier
+         * @param random_generator Random number generator to use for diffusion, recombination and trapping
+         * @return Final position, time and state of the charge carrier
+         */
+        std::tuple<ROOT::Math::XYZPoint, double, CarrierState>
+        propagate(const ROOT::Math::XYZPoint& pos, const CarrierType& type, RandomNumberGenerator& random_generator) const;
+
+        // Local copies of configuration parameters to avoid costly lookup:
+        double temperature_{}, timestep_min_{}, timestep_max_{}, timestep_start_{}, integration_time_{},
+            target_spatial_precision_{};
+        bool propagate_electrons_{}, propagate_holes_{};
+        unsigned int charge_per_step_{};
+        unsigned int max_charge_groups_{};
+
+        // Models for electron and hole mobility and lifetime
+        Mobility mobility_;
+        Recombination recombination_;
+        Trapping trapping_;
+        Detrapping detrapping_;
+
+        // Precalculated value for Boltzmann constant:
+        double boltzmann_kT_;
+
+        // Predefined values for electron/hole velocity calculation in magnetic fields
+        double electron_Hall_;
+        double hole_Hall_;
+
+        // Magnetic field
+        bool has_magnetic_field_{};
+
+        // Lookup table and the reference pixel it has been generated for
+        SurrogateTable table_;
+        Pixel::Index reference_pixel_;
+
+        // Statistical information
+        std::atomic<unsigned long> total_propagated_charges_{};
+        std::atomic<unsigned long> total_charge_groups_{};
+    };
+
+} // namespace allpix
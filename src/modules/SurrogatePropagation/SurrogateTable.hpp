@@ -0,0 +1,127 @@
+/**
+ * @file
+ * @brief Lookup table of tabulated charge carrier propagation results
+ *
+ * @copyright Copyright (c) 2023 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_SURROGATE_PROPAGATION_TABLE_H
+#define ALLPIX_SURROGATE_PROPAGATION_TABLE_H
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cereal/archives/portable_binary.hpp>
+#include <cereal/types/array.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
+#include "objects/PropagatedCharge.hpp"
+#include "objects/SensorCharge.hpp"
+
+namespace allpix {
+    /**
+     * @brief Table of propagation outcomes sampled for start positions within a single pixel cell
+     *
+     * The pixel cell is divided into voxels in x, y and depth. For every voxel and carrier type a fixed number of
+     * propagation outcomes is stored, from which the final state of a charge carrier group starting in this voxel can be
+     * sampled. The header identifies the configuration the table has been generated with.
+     */
+    class SurrogateTable {
+    public:
+        /**
+         * @brief Outcome of the propagation of a single charge carrier
+         */
+        struct Entry {
+            double dx{};   ///< Displacement in x from the start position
+            double dy{};   ///< Displacement in y from the start position
+            double z{};    ///< Final position in z
+            double time{}; ///< Time from deposition until the final state has been reached
+            CarrierState state{CarrierState::UNKNOWN};
+
+            template <class Archive> void serialize(Archive& archive) {
+                auto state_value = static_cast<std::uint8_t>(state);
+                archive(dx, dy, z, time, state_value);
+                state = static_cast<CarrierState>(state_value);
+            }
+        };
+
+        SurrogateTable() = default;
+
+        /**
+         * @brief Construct an empty table
+         * @param header Identifier of the configuration this table is generated for
+         * @param bins Number of voxels in x, y and depth
+         * @param samples Number of sampled outcomes per voxel and carrier type
+         */
+        SurrogateTable(std::string header, std::array<size_t, 3> bins, size_t samples)
+            : header_(std::move(header)), bins_(bins), samples_(samples),
+              entries_(2 * bins[0] * bins[1] * bins[2] * samples) {}
+
+        /**
+         * @brief Get the configuration identifier of this table
+         */
+        const std::string& getHeader() const { return header_; }
+
+        /**
+         * @brief Get the number of voxels in x, y and depth
+         */
+        const std::array<size_t, 3>& getBins() const { return bins_; }
+
+        /**
+         * @brief Get the number of sampled outcomes per voxel and carrier type
+         */
+        size_t getSamples() const { return samples_; }
+
+        /**
+         * @brief Access a sampled outcome
+         * @param type Type of the charge carrier
+         * @param x Voxel index in x
+         * @param y Voxel index in y
+         * @param z Voxel index in depth
+         * @param sample Index of the sampled outcome
+         */
+        Entry& at(CarrierType type, size_t x, size_t y, size_t z, size_t sample) {
+            return entries_.at(index(type, x, y, z) + sample);
+        }
+        const Entry& at(CarrierType type, size_t x, size_t y, size_t z, size_t sample) const {
+            return entries_.at(index(type, x, y, z) + sample);
+        }
+
+    private:
+        size_t index(CarrierType type, size_t x, size_t y, size_t z) const {
+            auto carrier = (type == CarrierType::ELECTRON ? 0u : 1u);
+            return (((carrier * bins_[2] + z) * bins_[1] + y) * bins_[0] + x) * samples_;
+        }
+
+        std::string header_;
+        std::array<size_t, 3> bins_{};
+        size_t samples_{};
+        std::vector<Entry> entries_;
+
+        friend class cereal::access;
+
+        // Versioned serialization function:
+        template <class Archive> void serialize(Archive& archive, std::uint32_t const version) {
+            if(version != 1) {
+                throw std::runtime_error("unknown format version " + std::to_string(version));
+            }
+
+            archive(header_);
+            archive(bins_);
+            archive(samples_);
+            archive(entries_);
+        }
+    };
+} // namespace allpix
+
+CEREAL_CLASS_VERSION(allpix::SurrogateTable, 1);
+
+#endif /* ALLPIX_SURROGATE_PROPAGATION_TABLE_H */
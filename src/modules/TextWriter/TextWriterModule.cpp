@@ -12,6 +12,7 @@
 #include "TextWriterModule.hpp"
 
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <utility>
 
@@ -96,29 +97,45 @@ bool TextWriterModule::filter(const std::shared_ptr<BaseMessage>& message, const
     return false;
 }
 
-void TextWriterModule::run(Event* event) {
+void TextWriterModule::prepare(Event* event) {
     auto messages = messenger_->fetchFilteredMessages(this, event);
-    LOG(TRACE) << "Writing new objects to text file";
+    LOG(TRACE) << "Formatting new objects for text file";
+
+    PreparedEvent prepared;
+    std::ostringstream text;
 
     // Print the current event:
-    *output_file_ << "=== " << event->number << " ===" << std::endl;
+    text << "=== " << event->number << " ===\n";
 
     for(auto& pair : messages) {
         auto& message = pair.first;
 
         // Print the current detector:
         if(message->getDetector() != nullptr) {
-            *output_file_ << "--- " << message->getDetector()->getName() << " ---" << std::endl;
+            text << "--- " << message->getDetector()->getName() << " ---\n";
         } else {
-            *output_file_ << "--- <global> ---" << std::endl;
+            text << "--- <global> ---\n";
         }
         for(auto& object : message->getObjectArray()) {
             // Print the object's ASCII representation:
-            *output_file_ << object << std::endl;
-            write_cnt_++;
+            text << object << '\n';
+            prepared.objects++;
         }
-        msg_cnt_++;
+        prepared.messages++;
     }
+
+    prepared.text = text.str();
+    store_prepared(event, std::move(prepared));
+}
+
+void TextWriterModule::run(Event* event) {
+    auto prepared = take_prepared<PreparedEvent>(event);
+    LOG(TRACE) << "Writing new objects to text file";
+
+    // Only append the formatted event in sequence
+    output_file_->write(prepared.text.data(), static_cast<std::streamsize>(prepared.text.size()));
+    write_cnt_ += prepared.objects;
+    msg_cnt_ += prepared.messages;
 }
 
 void TextWriterModule::finalize() {
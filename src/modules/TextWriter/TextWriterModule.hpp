@@ -50,7 +50,12 @@ namespace allpix {
         void initialize() override;
 
         /**
-         * @brief Writes the objects fetched to their specific tree, constructing trees on the fly for new objects.
+         * @brief Formats the ASCII representation of all objects of the event
+         */
+        void prepare(Event* event) override;
+
+        /**
+         * @brief Appends the formatted objects of the event to the text file
          */
         void run(Event* event) override;
 
@@ -71,6 +76,13 @@ namespace allpix {
         std::string output_file_name_{};
         std::unique_ptr<std::ofstream> output_file_;
 
+        // Formatted output of an event waiting to be written
+        struct PreparedEvent {
+            std::string text;
+            unsigned long objects{};
+            unsigned long messages{};
+        };
+
         // Statistical information about number of objects
         std::atomic<unsigned long> write_cnt_{};
         std::atomic<unsigned long> msg_cnt_{};
@@ -39,6 +39,10 @@ TransientPropagationModule::TransientPropagationModule(Configuration& config,
 
     // Set default value for config variables
     config_.setDefault<double>("timestep", Units::get(0.01, "ns"));
+    config_.setDefault<bool>("adaptive_timestep", false);
+    config_.setDefault<double>("spatial_precision", Units::get(0.25, "nm"));
+    config_.setDefault<double>("timestep_min", Units::get(0.001, "ns"));
+    config_.setDefault<double>("timestep_max", Units::get(0.5, "ns"));
     config_.setDefault<double>("integration_time", Units::get(25, "ns"));
     config_.setDefault<unsigned int>("charge_per_step", 10);
     config_.setDefault<unsigned int>("max_charge_groups", 1000);
@@ -75,6 +79,10 @@ TransientPropagationModule::TransientPropagationModule(Configuration& config,
     // Copy some variables from configuration to avoid lookups:
     temperature_ = config_.get<double>("temperature");
     timestep_ = config_.get<double>("timestep");
+    adaptive_timestep_ = config_.get<bool>("adaptive_timestep");
+    target_spatial_precision_ = config_.get<double>("spatial_precision");
+    timestep_min_ = config_.get<double>("timestep_min");
+    timestep_max_ = config_.get<double>("timestep_max");
     integration_time_ = config_.get<double>("integration_time");
     distance_ = config_.get<unsigned int>("distance");
     charge_per_step_ = config_.get<unsigned int>("charge_per_step");
@@ -133,8 +141,18 @@ void TransientPropagationModule::initialize() {
     // Impact ionization model
     multiplication_ = ImpactIonization(config_);
 
+    if(adaptive_timestep_) {
+        if(timestep_min_ > timestep_max_) {
+            throw InvalidCombinationError(
+                config_, {"timestep_min", "timestep_max"}, "Minimum timestep larger than maximum timestep");
+        }
+        LOG(INFO) << "Using adaptive integration steps between " << Units::display(timestep_min_, {"ps", "ns"})
+                  << " and " << Units::display(timestep_max_, {"ps", "ns"}) << ", pulse binning of "
+                  << Units::display(timestep_, {"ps", "ns"});
+    }
+
     // Check multiplication and step size larger than a picosecond:
-    if(!multiplication_.is<NoImpactIonization>() && timestep_ > 0.001) {
+    if(!multiplication_.is<NoImpactIonization>() && (adaptive_timestep_ ? timestep_max_ : timestep_) > 0.001) {
         LOG(WARNING) << "Charge multiplication enabled with maximum timestep larger than 1ps" << std::endl
                      << "This might lead to unphysical gain values.";
     }
@@ -517,24 +535,24 @@ TransientPropagationModule::propagate(Event* event,
     // Define lambda functions to compute the charge carrier velocity with or without magnetic field
     std::function<Eigen::Vector3d(double, const Eigen::Vector3d&)> carrier_velocity_noB =
         [&](double, const Eigen::Vector3d& cur_pos) -> Eigen::Vector3d {
-        auto raw_field = detector_->getElectricField(static_cast<ROOT::Math::XYZPoint>(cur_pos));
-        Eigen::Vector3d efield(raw_field.x(), raw_field.y(), raw_field.z());
+        auto fields = detector_->getFields(static_cast<ROOT::Math::XYZPoint>(cur_pos));
+        Eigen::Vector3d efield(fields.electric_field.x(), fields.electric_field.y(), fields.electric_field.z());
 
-        auto doping = detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(cur_pos));
+        auto doping = fields.doping_concentration;
 
         return static_cast<int>(type) * mobility_(type, efield.norm(), doping) * efield;
     };
 
     std::function<Eigen::Vector3d(double, const Eigen::Vector3d&)> carrier_velocity_withB =
         [&](double, const Eigen::Vector3d& cur_pos) -> Eigen::Vector3d {
-        auto raw_field = detector_->getElectricField(static_cast<ROOT::Math::XYZPoint>(cur_pos));
-        Eigen::Vector3d efield(raw_field.x(), raw_field.y(), raw_field.z());
+        auto fields = detector_->getFields(static_cast<ROOT::Math::XYZPoint>(cur_pos));
+        Eigen::Vector3d efield(fields.electric_field.x(), fields.electric_field.y(), fields.electric_field.z());
 
         Eigen::Vector3d velocity;
         auto magnetic_field = detector_->getMagneticField(static_cast<ROOT::Math::XYZPoint>(cur_pos));
         Eigen::Vector3d bfield(magnetic_field.x(), magnetic_field.y(), magnetic_field.z());
 
-        auto doping = detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(cur_pos));
+        auto doping = fields.doping_concentration;
 
         auto mob = mobility_(type, efield.norm(), doping);
         auto exb = efield.cross(bfield);
@@ -555,6 +573,7 @@ TransientPropagationModule::propagate(Event* event,
 
     // Continue propagation until the deposit is outside the sensor
     Eigen::Vector3d last_position = position;
+    double last_time = 0;
     ROOT::Math::XYZVector efield{}, last_efield{};
     size_t next_idx = 0;
     auto state = CarrierState::MOTION;
@@ -570,20 +589,24 @@ TransientPropagationModule::propagate(Event* event,
 
         // Save previous position and time
         last_position = position;
+        last_time = runge_kutta.getTime();
         last_efield = efield;
 
         // Execute a Runge Kutta step
         auto step = runge_kutta.step();
 
-        // Get the current result
+        // Get the current result and timestep
+        auto timestep = runge_kutta.getTimeStep();
+        auto step_time = runge_kutta.getTime();
         position = runge_kutta.getValue();
 
         // Get electric field at current position and fall back to empty field if it does not exist
-        efield = detector_->getElectricField(static_cast<ROOT::Math::XYZPoint>(position));
-        auto doping = detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(position));
+        auto fields = detector_->getFields(static_cast<ROOT::Math::XYZPoint>(position));
+        efield = fields.electric_field;
+        auto doping = fields.doping_concentration;
 
         // Apply diffusion step
-        auto diffusion = carrier_diffusion(std::sqrt(efield.Mag2()), doping, timestep_);
+        auto diffusion = carrier_diffusion(std::sqrt(efield.Mag2()), doping, timestep);
         position += diffusion;
         runge_kutta.setValue(position);
 
@@ -591,12 +614,12 @@ TransientPropagationModule::propagate(Event* event,
         if(recombination_(type,
                           detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(position)),
                           uniform_distribution(event->getRandomEngine()),
-                          timestep_)) {
+                          timestep)) {
             state = CarrierState::RECOMBINED;
         }
 
         // Check if the charge carrier has been trapped:
-        if(trapping_(type, uniform_distribution(event->getRandomEngine()), timestep_, std::sqrt(efield.Mag2()))) {
+        if(trapping_(type, uniform_distribution(event->getRandomEngine()), timestep, std::sqrt(efield.Mag2()))) {
             if(output_plots_) {
                 trapping_time_histo_->Fill(runge_kutta.getTime(), charge);
             }
@@ -713,67 +736,118 @@ TransientPropagationModule::propagate(Event* event,
                    << Units::display(static_cast<ROOT::Math::XYZPoint>(position), {"um", "mm"}) << ", "
                    << Units::display(initial_time_local + runge_kutta.getTime(), "ns");
 
-        for(const auto& pixel_index : neighbors) {
-            auto ramo = detector_->getWeightingPotential(static_cast<ROOT::Math::XYZPoint>(position), pixel_index);
-            auto last_ramo = detector_->getWeightingPotential(static_cast<ROOT::Math::XYZPoint>(last_position), pixel_index);
-
-            // Induced charge on electrode is q_int = q * (phi(x1) - phi(x0))
-            auto induced = charge * gain * (ramo - last_ramo) * static_cast<std::underlying_type<CarrierType>::type>(type);
-
-            auto induced_primary = charge * (ramo - last_ramo) * static_cast<std::underlying_type<CarrierType>::type>(type);
-            auto induced_secondary =
-                charge * (gain - 1) * (ramo - last_ramo) * static_cast<std::underlying_type<CarrierType>::type>(type);
-            if(level != 0) {
-                induced_primary = 0.;
-                induced_secondary = induced;
+        // Sample the weighting potential along the step. With a fixed timestep, the step is short compared to the pulse
+        // binning and the induced charge is attributed to the end of the step. With adaptive timesteps a step may span
+        // several pulse bins, so the path is sub-sampled at every bin boundary crossed and each segment is attributed to
+        // the bin it lies in.
+        std::vector<std::pair<double, ROOT::Math::XYZPoint>> ramo_samples;
+        ramo_samples.emplace_back(initial_time_local + last_time, static_cast<ROOT::Math::XYZPoint>(last_position));
+        if(adaptive_timestep_) {
+            auto time_start = initial_time_local + last_time;
+            auto time_end = initial_time_local + step_time;
+            for(auto bin_edge = (std::round(time_start / timestep_) + 0.5) * timestep_; bin_edge < time_end;
+                bin_edge += timestep_) {
+                Eigen::Vector3d sample_position =
+                    last_position + (bin_edge - time_start) / (time_end - time_start) * (position - last_position);
+                ramo_samples.emplace_back(bin_edge, static_cast<ROOT::Math::XYZPoint>(sample_position));
             }
+            ramo_samples.emplace_back(time_end, static_cast<ROOT::Math::XYZPoint>(position));
+        } else {
+            ramo_samples.emplace_back(initial_time_local + runge_kutta.getTime(),
+                                      static_cast<ROOT::Math::XYZPoint>(position));
+        }
 
-            LOG(TRACE) << "Pixel " << pixel_index << " dPhi = " << (ramo - last_ramo) << ", induced " << type
-                       << " q = " << Units::display(induced, "e");
-
+        for(const auto& pixel_index : neighbors) {
             // Create pulse if it doesn't exist. Store induced charge in the returned pulse iterator
             auto pixel_map_iterator = pixel_map.emplace(pixel_index, Pulse(timestep_, integration_time_));
-            try {
-                pixel_map_iterator.first->second.addCharge(induced, initial_time_local + runge_kutta.getTime());
-            } catch(const PulseBadAllocException& e) {
-                LOG(ERROR) << e.what() << std::endl
-                           << "Ignoring pulse contribution at time "
-                           << Units::display(initial_time_local + runge_kutta.getTime(), {"ms", "us", "ns"});
-            }
 
-            if(output_plots_) {
-                auto inPixel_um_x = (position.x() - model_->getPixelCenter(xpixel, ypixel).x()) * 1e3;
-                auto inPixel_um_y = (position.y() - model_->getPixelCenter(xpixel, ypixel).y()) * 1e3;
-
-                potential_difference_->Fill(std::fabs(ramo - last_ramo));
-                induced_charge_histo_->Fill(initial_time_local + runge_kutta.getTime(), induced);
-                induced_charge_vs_depth_histo_->Fill(initial_time_local + runge_kutta.getTime(), position.z(), induced);
-                induced_charge_map_->Fill(inPixel_um_x, inPixel_um_y, induced);
-                if(type == CarrierType::ELECTRON) {
-                    induced_charge_e_histo_->Fill(initial_time_local + runge_kutta.getTime(), induced);
-                    induced_charge_e_vs_depth_histo_->Fill(
-                        initial_time_local + runge_kutta.getTime(), position.z(), induced);
-                    induced_charge_e_map_->Fill(inPixel_um_x, inPixel_um_y, induced);
-                } else {
-                    induced_charge_h_histo_->Fill(initial_time_local + runge_kutta.getTime(), induced);
-                    induced_charge_h_vs_depth_histo_->Fill(
-                        initial_time_local + runge_kutta.getTime(), position.z(), induced);
-                    induced_charge_h_map_->Fill(inPixel_um_x, inPixel_um_y, induced);
+            auto last_ramo = detector_->getWeightingPotential(ramo_samples.front().second, pixel_index);
+            for(size_t sample = 1; sample < ramo_samples.size(); sample++) {
+                const auto& [sample_time, sample_position] = ramo_samples[sample];
+                auto ramo = detector_->getWeightingPotential(sample_position, pixel_index);
+
+                // Book sub-sampled segments at their center to place them in the pulse bin they were induced in
+                auto induction_time =
+                    (adaptive_timestep_ ? (ramo_samples[sample - 1].first + sample_time) / 2 : sample_time);
+
+                // Induced charge on electrode is q_int = q * (phi(x1) - phi(x0))
+                auto induced =
+                    charge * gain * (ramo - last_ramo) * static_cast<std::underlying_type<CarrierType>::type>(type);
+
+                auto induced_primary =
+                    charge * (ramo - last_ramo) * static_cast<std::underlying_type<CarrierType>::type>(type);
+                auto induced_secondary =
+                    charge * (gain - 1) * (ramo - last_ramo) * static_cast<std::underlying_type<CarrierType>::type>(type);
+                if(level != 0) {
+                    induced_primary = 0.;
+                    induced_secondary = induced;
+                }
+
+                LOG(TRACE) << "Pixel " << pixel_index << " dPhi = " << (ramo - last_ramo) << ", induced " << type
+                           << " q = " << Units::display(induced, "e");
+
+                try {
+                    pixel_map_iterator.first->second.addCharge(induced, induction_time);
+                } catch(const PulseBadAllocException& e) {
+                    LOG(ERROR) << e.what() << std::endl
+                               << "Ignoring pulse contribution at time "
+                               << Units::display(induction_time, {"ms", "us", "ns"});
                 }
-                if(!multiplication_.is<NoImpactIonization>()) {
-                    induced_charge_primary_histo_->Fill(initial_time_local + runge_kutta.getTime(), induced_primary);
-                    induced_charge_secondary_histo_->Fill(initial_time_local + runge_kutta.getTime(), induced_secondary);
+
+                if(output_plots_) {
+                    auto inPixel_um_x = (sample_position.x() - model_->getPixelCenter(xpixel, ypixel).x()) * 1e3;
+                    auto inPixel_um_y = (sample_position.y() - model_->getPixelCenter(xpixel, ypixel).y()) * 1e3;
+
+                    potential_difference_->Fill(std::fabs(ramo - last_ramo));
+                    induced_charge_histo_->Fill(induction_time, induced);
+                    induced_charge_vs_depth_histo_->Fill(induction_time, sample_position.z(), induced);
+                    induced_charge_map_->Fill(inPixel_um_x, inPixel_um_y, induced);
                     if(type == CarrierType::ELECTRON) {
-                        induced_charge_primary_e_histo_->Fill(initial_time_local + runge_kutta.getTime(), induced_primary);
-                        induced_charge_secondary_e_histo_->Fill(initial_time_local + runge_kutta.getTime(),
-                                                                induced_secondary);
+                        induced_charge_e_histo_->Fill(induction_time, induced);
+                        induced_charge_e_vs_depth_histo_->Fill(induction_time, sample_position.z(), induced);
+                        induced_charge_e_map_->Fill(inPixel_um_x, inPixel_um_y, induced);
                     } else {
-                        induced_charge_primary_h_histo_->Fill(initial_time_local + runge_kutta.getTime(), induced_primary);
-                        induced_charge_secondary_h_histo_->Fill(initial_time_local + runge_kutta.getTime(),
-                                                                induced_secondary);
+                        induced_charge_h_histo_->Fill(induction_time, induced);
+                        induced_charge_h_vs_depth_histo_->Fill(induction_time, sample_position.z(), induced);
+                        induced_charge_h_map_->Fill(inPixel_um_x, inPixel_um_y, induced);
+                    }
+                    if(!multiplication_.is<NoImpactIonization>()) {
+                        induced_charge_primary_histo_->Fill(induction_time, induced_primary);
+                        induced_charge_secondary_histo_->Fill(induction_time, induced_secondary);
+                        if(type == CarrierType::ELECTRON) {
+                            induced_charge_primary_e_histo_->Fill(induction_time, induced_primary);
+                            induced_charge_secondary_e_histo_->Fill(induction_time, induced_secondary);
+                        } else {
+                            induced_charge_primary_h_histo_->Fill(induction_time, induced_primary);
+                            induced_charge_secondary_h_histo_->Fill(induction_time, induced_secondary);
+                        }
                     }
                 }
+                last_ramo = ramo;
+            }
+        }
+
+        // Adapt step size to match target precision
+        if(adaptive_timestep_) {
+            double uncertainty = step.error.norm();
+
+            // Lower timestep when reaching the sensor edge
+            if(std::fabs(model_->getSensorSize().z() / 2.0 - position.z()) < 2 * step.value.z()) {
+                timestep *= 0.75;
+            } else {
+                if(uncertainty > target_spatial_precision_) {
+                    timestep *= 0.75;
+                } else if(2 * uncertainty < target_spatial_precision_) {
+                    timestep *= 1.5;
+                }
+            }
+            // Limit the timestep to certain minimum and maximum step sizes
+            if(timestep > timestep_max_) {
+                timestep = timestep_max_;
+            } else if(timestep < timestep_min_) {
+                timestep = timestep_min_;
             }
+            runge_kutta.setTimeStep(timestep);
         }
     }
 
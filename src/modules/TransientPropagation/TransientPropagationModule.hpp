@@ -105,6 +105,8 @@ namespace allpix {
 
         // Local copies of configuration parameters to avoid costly lookup:
         double temperature_{}, timestep_{}, integration_time_{}, output_plots_step_{};
+        bool adaptive_timestep_{};
+        double timestep_min_{}, timestep_max_{}, target_spatial_precision_{};
         bool output_plots_{}, output_linegraphs_{}, output_linegraphs_collected_{}, output_linegraphs_recombined_{},
             output_linegraphs_trapped_{};
         unsigned int distance_{};
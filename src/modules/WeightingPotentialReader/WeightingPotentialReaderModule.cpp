@@ -57,7 +57,7 @@ void WeightingPotentialReaderModule::initialize() {
                 config_, "field_mapping", "the weighting potential needs to be centered around an electrode");
         }
         LOG(DEBUG) << "Weighting potential maps to " << magic_enum::enum_name(field_mapping);
-        auto field_data = read_field();
+        auto [field_data, field_grid] = read_field_grid();
 
         // By default, set field scale from physical extent read from field file:
         std::array<double, 2> field_scale{{1.0, 1.0}};
@@ -82,7 +82,7 @@ void WeightingPotentialReaderModule::initialize() {
         LOG(DEBUG) << "Weighting potential has offset of " << offset << " fractions of the field size";
 
         // Set the field grid, provide scale factors as fraction of the pixel pitch for correct scaling:
-        detector_->setWeightingPotentialGrid(field_data.getData(),
+        detector_->setWeightingPotentialGrid(field_grid,
                                              field_data.getDimensions(),
                                              field_data.getSize(),
                                              field_mapping,
@@ -157,6 +157,20 @@ WeightingPotentialReaderModule::get_pad_potential_function(const ROOT::Math::XYV
     };
 }
 
+/**
+ * Fields are identified by the file they are read from, which is released from the cache of the field parser after the
+ * conversion.
+ */
+FieldGridCache WeightingPotentialReaderModule::field_grids_("weighting potential");
+std::pair<FieldData<double>, FieldGrid> WeightingPotentialReaderModule::read_field_grid() {
+    auto file_name = config_.getPath("file_name", true);
+    return field_grids_.get(
+        std::filesystem::canonical(file_name).string(),
+        config_.get<FieldPrecision>("field_precision", FieldPrecision::DOUBLE),
+        [&]() { return read_field(); },
+        [&](const FieldData<double>&) { field_parser_.release(file_name); });
+}
+
 void WeightingPotentialReaderModule::create_output_plots() {
     LOG(TRACE) << "Creating output plots";
 
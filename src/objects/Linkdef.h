@@ -45,6 +45,15 @@
 
 #pragma link C++ class allpix::Pulse + ;
 #pragma link C++ class allpix::Pixel + ;
+#pragma link C++ class allpix::Pixel::Placement + ;
+// Pixels of version 3 and earlier store their location and size inline
+#pragma read sourceClass = "allpix::Pixel" targetClass = "allpix::Pixel" version = "[-3]" source =                         \
+    "ROOT::Math::PositionVector3D<ROOT::Math::Cartesian3D<double>,ROOT::Math::DefaultCoordinateSystemTag> local_center_; \
+     ROOT::Math::PositionVector3D<ROOT::Math::Cartesian3D<double>,ROOT::Math::DefaultCoordinateSystemTag> global_center_; \
+     ROOT::Math::DisplacementVector2D<ROOT::Math::Cartesian2D<double>,ROOT::Math::DefaultCoordinateSystemTag> size_"       \
+    target = "placement_" code = "{ delete placement_;                                                                    \
+                                    placement_ = new allpix::Pixel::Placement{                                             \
+                                        onfile.local_center_, onfile.global_center_, onfile.size_}; }"
 
 #pragma link C++ class allpix::PropagatedCharge + ;
 #pragma link C++ class allpix::Object::PointerWrapper < allpix::PropagatedCharge> + ;
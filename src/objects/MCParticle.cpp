@@ -82,6 +82,7 @@ double MCParticle::getLocalTime() const {
 
 void MCParticle::setParent(const MCParticle* mc_particle) {
     parent_ = PointerWrapper<MCParticle>(mc_particle);
+    primary_ = nullptr;
 }
 
 /**
@@ -99,11 +100,25 @@ bool MCParticle::isPrimary() const {
 }
 
 /**
- * Object is stored as \ref allpix::Object::PointerWrapper and can only be accessed if pointed object is in scope
+ * Object is stored as \ref allpix::Object::PointerWrapper and can only be accessed if pointed object is in scope. The
+ * primary of secondary particles is looked up by walking up the chain of parents and cached afterwards. Since parents are
+ * only set once, the only change to the chain of a particle is its former primary being assigned a parent, e.g. if a
+ * descendant is looked up before all parents of the event are set. Cached primaries are therefore only used, both for this
+ * particle and for its ancestors, as long as they have no parent themselves.
  */
-const MCParticle* MCParticle::getPrimary() const { // NOLINT
-    auto* parent = parent_.get();
-    return (parent == nullptr ? this : parent->getPrimary());
+const MCParticle* MCParticle::getPrimary() const {
+    if(primary_ == nullptr || !primary_->isPrimary()) {
+        const MCParticle* parent = parent_.get();
+        if(parent == nullptr) {
+            primary_ = nullptr;
+            return this;
+        }
+        while((parent->primary_ == nullptr || !parent->primary_->isPrimary()) && !parent->isPrimary()) {
+            parent = parent->parent_.get();
+        }
+        primary_ = (parent->isPrimary() ? parent : parent->primary_);
+    }
+    return primary_;
 }
 
 void MCParticle::setTrack(const MCTrack* mc_track) {
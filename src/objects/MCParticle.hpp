@@ -173,6 +173,10 @@ namespace allpix {
 
         PointerWrapper<MCParticle> parent_;
         PointerWrapper<MCTrack> track_;
+
+        // Primary particle of secondaries, never pointing to the particle itself such that copies remain valid. Only used as
+        // long as the cached particle has no parent itself
+        mutable const MCParticle* primary_{}; //! transient value
     };
 
     /**
@@ -140,8 +140,9 @@ namespace allpix {
              * @note A TRef is only constructed if the object the wrapped pointer is referring to has been marked for storage
              */
             void store() {
-                if(markedForStorage()) {
-                    ref_ = get();
+                auto* obj = get();
+                if(obj != nullptr && obj->TestBit(1ull << 14)) {
+                    ref_ = obj;
                 }
             }
 
@@ -214,11 +215,11 @@ namespace allpix {
              * @return Pointer to object
              */
             T* get() const override {
-                // Lazy loading of pointer from TRef
-                if(!this->loaded_) {
+                // Lazy loading of pointer from TRef, the flag is only set once the pointer has been loaded
+                if(!this->loaded_.load(std::memory_order_acquire)) {
                     std::call_once(load_flag_, [&]() {
                         this->ptr_ = static_cast<T*>(this->ref_.GetObject());
-                        this->loaded_ = true;
+                        this->loaded_.store(true, std::memory_order_release);
                     });
                 }
                 return this->ptr_;
@@ -11,8 +11,79 @@
 
 #include "Pixel.hpp"
 
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "exceptions.h"
+
 using namespace allpix;
 
+namespace {
+    // Registry of the detector geometries available to resolve compact pixels, the generation changes with every update
+    std::mutex geometry_mutex;
+    std::atomic<uint64_t> geometry_generation{0};
+    struct GeometryEntry {
+        std::string name;
+        const Pixel::Geometry* geometry;
+    };
+    std::map<uint32_t, GeometryEntry>& geometry_registry() {
+        static std::map<uint32_t, GeometryEntry> registry;
+        return registry;
+    }
+
+    // Geometries already looked up by this thread, valid as long as the registry has not been updated
+    struct GeometryCache {
+        uint64_t generation{};
+        std::map<uint32_t, const Pixel::Geometry*> geometries;
+    };
+    thread_local GeometryCache geometry_cache; // NOLINT
+
+    // FNV-1a hash of the detector name, stable across runs and platforms. Zero is reserved for pixels which are not compact
+    uint32_t geometry_hash(const std::string& name) {
+        uint32_t hash = 2166136261u;
+        for(auto c : name) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 16777619u;
+        }
+        return hash != 0 ? hash : 1u;
+    }
+} // namespace
+
+/**
+ * A geometry registered again under the same name, e.g. when the detector is recreated, replaces the previous one. A
+ * different name mapping to the same identifier cannot be told apart by compact pixels and is rejected.
+ */
+Pixel::Geometry::Geometry(const std::string& name) : geometry_id_(geometry_hash(name)) {
+    std::lock_guard<std::mutex> lock(geometry_mutex);
+    auto [entry, inserted] = geometry_registry().try_emplace(geometry_id_, GeometryEntry{name, this});
+    if(!inserted) {
+        if(entry->second.name != name) {
+            throw GeometryCollisionException(name, entry->second.name);
+        }
+        entry->second.geometry = this;
+    }
+    geometry_generation++;
+}
+
+Pixel::Geometry::~Geometry() {
+    std::lock_guard<std::mutex> lock(geometry_mutex);
+    auto& registry = geometry_registry();
+    auto entry = registry.find(geometry_id_);
+    if(entry != registry.end() && entry->second.geometry == this) {
+        registry.erase(entry);
+        geometry_generation++;
+    }
+}
+
+const Pixel::Geometry* Pixel::Geometry::find(uint32_t geometry_id) {
+    std::lock_guard<std::mutex> lock(geometry_mutex);
+    auto& registry = geometry_registry();
+    auto entry = registry.find(geometry_id);
+    return entry != registry.end() ? entry->second.geometry : nullptr;
+}
+
 bool ROOT::Math::operator<(const ROOT::Math::DisplacementVector2D<ROOT::Math::Cartesian2D<int>>& lhs,
                            const ROOT::Math::DisplacementVector2D<ROOT::Math::Cartesian2D<int>>& rhs) {
     if(lhs.x() == rhs.x()) {
@@ -26,8 +97,47 @@ Pixel::Pixel(Pixel::Index index,
              ROOT::Math::XYZPoint local_center,
              ROOT::Math::XYZPoint global_center,
              ROOT::Math::XYVector size)
-    : index_(std::move(index)), type_(type), local_center_(std::move(local_center)),
-      global_center_(std::move(global_center)), size_(std::move(size)) {}
+    : index_(std::move(index)), type_(type),
+      placement_(new Placement{std::move(local_center), std::move(global_center), std::move(size)}) {}
+
+Pixel::Pixel(Pixel::Index index, Pixel::Type type, const Geometry* geometry)
+    : index_(std::move(index)), type_(type), geometry_id_(geometry->getGeometryId()) {}
+
+Pixel::Pixel(const Pixel& other)
+    : index_(other.index_), type_(other.type_), geometry_id_(other.geometry_id_),
+      placement_(other.placement_ != nullptr ? new Placement(*other.placement_) : nullptr) {}
+
+Pixel& Pixel::operator=(const Pixel& other) {
+    if(this != &other) {
+        index_ = other.index_;
+        type_ = other.type_;
+        geometry_id_ = other.geometry_id_;
+        delete placement_;
+        placement_ = (other.placement_ != nullptr ? new Placement(*other.placement_) : nullptr);
+    }
+    return *this;
+}
+
+Pixel::Pixel(Pixel&& other) noexcept
+    : index_(other.index_), type_(other.type_), geometry_id_(other.geometry_id_), placement_(other.placement_) {
+    other.placement_ = nullptr;
+}
+
+Pixel& Pixel::operator=(Pixel&& other) noexcept {
+    if(this != &other) {
+        index_ = other.index_;
+        type_ = other.type_;
+        geometry_id_ = other.geometry_id_;
+        delete placement_;
+        placement_ = other.placement_;
+        other.placement_ = nullptr;
+    }
+    return *this;
+}
+
+Pixel::~Pixel() {
+    delete placement_;
+}
 
 Pixel::Index Pixel::getIndex() const {
     return index_;
@@ -38,11 +148,41 @@ Pixel::Type Pixel::getType() const {
 }
 
 ROOT::Math::XYZPoint Pixel::getLocalCenter() const {
-    return local_center_;
+    if(isCompact()) {
+        return get_geometry()->getPixelLocalCenter(index_);
+    }
+    return placement_ != nullptr ? placement_->local_center : ROOT::Math::XYZPoint();
 }
 ROOT::Math::XYZPoint Pixel::getGlobalCenter() const {
-    return global_center_;
+    if(isCompact()) {
+        return get_geometry()->getPixelGlobalCenter(index_);
+    }
+    return placement_ != nullptr ? placement_->global_center : ROOT::Math::XYZPoint();
 }
 ROOT::Math::XYVector Pixel::getSize() const {
-    return size_;
+    if(isCompact()) {
+        return get_geometry()->getPixelSize(index_);
+    }
+    return placement_ != nullptr ? placement_->size : ROOT::Math::XYVector();
+}
+
+/**
+ * The geometry is not stored with the pixel to keep compact pixels small. Instead, every thread caches the geometries it has
+ * looked up in the registry until geometries are added or removed.
+ */
+const Pixel::Geometry* Pixel::get_geometry() const {
+    auto generation = geometry_generation.load();
+    if(geometry_cache.generation != generation) {
+        geometry_cache.geometries.clear();
+        geometry_cache.generation = generation;
+    }
+
+    auto& geometry = geometry_cache.geometries[geometry_id_];
+    if(geometry == nullptr) {
+        geometry = Geometry::find(geometry_id_);
+    }
+    if(geometry == nullptr) {
+        throw MissingReferenceException(typeid(Pixel), typeid(Pixel::Geometry));
+    }
+    return geometry;
 }
@@ -12,6 +12,9 @@
 #ifndef ALLPIX_PIXEL_H
 #define ALLPIX_PIXEL_H
 
+#include <cstdint>
+#include <string>
+
 #include <Math/DisplacementVector2D.h>
 #include <Math/Point3D.h>
 #include <Math/Vector2D.h>
@@ -29,11 +32,89 @@ namespace allpix {
      * @ingroup Objects
      * @brief Pixel in the model with indices, location and size
      * @warning This object is special and is not meant to be written directly to a tree (not inheriting from \ref Object)
+     *
+     * The location and size of the pixel are either stored in a separate placement owned by the pixel or, for compact
+     * pixels, resolved on demand through the geometry of the detector the pixel belongs to. Compact pixels only hold the
+     * index, type and an identifier of the detector, which reduces their size in memory and in output files, but requires
+     * the detector to be available when the location or size of the pixel is requested.
      */
     class Pixel {
     public:
         using Index = ROOT::Math::DisplacementVector2D<ROOT::Math::Cartesian2D<int>>;
 
+        /**
+         * @brief Interface for detectors to provide the geometry of compact pixels
+         *
+         * Every geometry is registered under a non-zero identifier derived from the detector name, which is stored with
+         * compact pixels to look up the geometry again after reading them from file.
+         */
+        class Geometry {
+        public:
+            /**
+             * @brief Register the geometry for the given detector name
+             * @param name Name of the detector
+             * @throws GeometryCollisionException If the identifier of the name is already taken by another detector name
+             */
+            explicit Geometry(const std::string& name);
+
+            /**
+             * @brief Remove the geometry from the registry
+             */
+            virtual ~Geometry();
+
+            /// @{
+            /**
+             * @brief Copies share the identifier of the original geometry
+             */
+            Geometry(const Geometry&) = default;
+            Geometry& operator=(const Geometry&) = default;
+            /// @}
+
+            /**
+             * @brief Get the identifier this geometry is registered under
+             * @return Identifier of the geometry
+             */
+            uint32_t getGeometryId() const { return geometry_id_; }
+
+            /**
+             * @brief Get center position of a pixel in local coordinates
+             * @param index Index of the pixel
+             * @return Local center position
+             */
+            virtual ROOT::Math::XYZPoint getPixelLocalCenter(const Pixel::Index& index) const = 0;
+            /**
+             * @brief Get center position of a pixel in global coordinates
+             * @param index Index of the pixel
+             * @return Global center position
+             */
+            virtual ROOT::Math::XYZPoint getPixelGlobalCenter(const Pixel::Index& index) const = 0;
+            /**
+             * @brief Get size of a pixel
+             * @param index Index of the pixel
+             * @return Pixel size
+             */
+            virtual ROOT::Math::XYVector getPixelSize(const Pixel::Index& index) const = 0;
+
+            /**
+             * @brief Find a registered geometry
+             * @param geometry_id Identifier of the geometry
+             * @return Pointer to the geometry, or a nullptr if no geometry is registered under this identifier
+             */
+            static const Geometry* find(uint32_t geometry_id);
+
+        private:
+            uint32_t geometry_id_{};
+        };
+
+        /**
+         * @brief Location and size of pixels which are not compact
+         */
+        struct Placement {
+            ROOT::Math::XYZPoint local_center;
+            ROOT::Math::XYZPoint global_center;
+            ROOT::Math::XYVector size;
+        };
+
         /**
          * @brief Type of pixels
          */
@@ -52,6 +133,31 @@ namespace allpix {
               ROOT::Math::XYZPoint global_center,
               ROOT::Math::XYVector size);
 
+        /**
+         * @brief Construct a new compact pixel resolving its location and size through the geometry
+         */
+        Pixel(Pixel::Index index, Pixel::Type type, const Geometry* geometry);
+
+        /// @{
+        /**
+         * @brief Copies own a copy of the placement of the original pixel
+         */
+        Pixel(const Pixel& other);
+        Pixel& operator=(const Pixel& other);
+        Pixel(Pixel&& other) noexcept;
+        Pixel& operator=(Pixel&& other) noexcept;
+        /// @}
+        /**
+         * @brief Release the placement of the pixel
+         */
+        ~Pixel();
+
+        /**
+         * @brief Check if the location and size of the pixel are resolved through the detector geometry
+         * @return True for compact pixels, false if the location and size are stored with the pixel
+         */
+        bool isCompact() const { return geometry_id_ != 0; }
+
         /**
          * @brief Return index pair of pixel
          * @return Index in x,y-plane
@@ -87,15 +193,22 @@ namespace allpix {
         /**
          * @brief Default constructor for ROOT I/O
          */
-        ClassDef(Pixel, 2); // NOLINT
+        ClassDef(Pixel, 4); // NOLINT
 
     private:
+        /**
+         * @brief Get the geometry to resolve the location and size of compact pixels
+         * @return Pointer to the geometry of the detector
+         * @throws MissingReferenceException If the geometry of the detector is not available
+         */
+        const Geometry* get_geometry() const;
+
         Pixel::Index index_;
         Pixel::Type type_{};
-
-        ROOT::Math::XYZPoint local_center_;
-        ROOT::Math::XYZPoint global_center_;
-        ROOT::Math::XYVector size_;
+        // Identifier of the detector geometry of compact pixels, zero if the location and size are stored with the pixel
+        uint32_t geometry_id_{};
+        // Location and size of pixels which are not compact, a nullptr for compact pixels
+        Placement* placement_{nullptr};
     };
 
 } // namespace allpix
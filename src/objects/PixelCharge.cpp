@@ -11,27 +11,42 @@
 
 #include "PixelCharge.hpp"
 
-#include <set>
+#include <algorithm>
+#include <functional>
+
 #include "objects/exceptions.h"
 
 using namespace allpix;
 
 PixelCharge::PixelCharge(Pixel pixel, long charge, const std::vector<const PropagatedCharge*>& propagated_charges)
     : pixel_(std::move(pixel)), charge_(charge) {
-    // Unique set of MC particles
-    std::set<const MCParticle*> unique_particles;
-    // Store all propagated charges and their MC particles
+    // Store all propagated charges and their MC particles, skipping repetitions of the same particle which are common
+    // since propagated charges are typically ordered by their deposit
+    std::vector<const MCParticle*> unique_particles;
+    propagated_charges_.reserve(propagated_charges.size());
     for(const auto& propagated_charge : propagated_charges) {
         propagated_charges_.emplace_back(propagated_charge);
-        unique_particles.insert(propagated_charge->mc_particle_.get());
+        const auto* mc_particle = propagated_charge->mc_particle_.get();
+        if(unique_particles.empty() || unique_particles.back() != mc_particle) {
+            unique_particles.push_back(mc_particle);
+        }
     }
+    // Unique set of MC particles, ordered by address
+    std::sort(unique_particles.begin(), unique_particles.end(), std::less<>());
+    unique_particles.erase(std::unique(unique_particles.begin(), unique_particles.end()), unique_particles.end());
+
     // Store the MC particle references
+    mc_particles_.reserve(unique_particles.size());
+    const MCParticle* last_primary = nullptr;
     for(const auto& mc_particle : unique_particles) {
         // Local and global time are set as the earliest time found among the MCParticles:
         if(mc_particle != nullptr) {
             const auto* primary = mc_particle->getPrimary();
-            local_time_ = std::min(local_time_, primary->getLocalTime());
-            global_time_ = std::min(global_time_, primary->getGlobalTime());
+            if(primary != last_primary) {
+                local_time_ = std::min(local_time_, primary->getLocalTime());
+                global_time_ = std::min(global_time_, primary->getGlobalTime());
+                last_primary = primary;
+            }
         }
         mc_particles_.emplace_back(mc_particle);
     }
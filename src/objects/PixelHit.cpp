@@ -11,7 +11,8 @@
 
 #include "PixelHit.hpp"
 
-#include <set>
+#include <algorithm>
+#include <functional>
 
 #include "DepositedCharge.hpp"
 #include "PropagatedCharge.hpp"
@@ -30,12 +31,17 @@ PixelHit::PixelHit(Pixel pixel,
     pixel_pulse_ = PointerWrapper<PixelPulse>(pixel_pulse);
     pixel_charge_ = PointerWrapper<PixelCharge>(pixel_charge);
     if(pixel_charge != nullptr) {
-        // Get the unique set of MC particles
-        std::set<const MCParticle*> unique_particles;
+        // Get the unique set of MC particles, ordered by address
+        std::vector<const MCParticle*> unique_particles;
+        unique_particles.reserve(pixel_charge->mc_particles_.size());
         for(const auto& mc_particle : pixel_charge->mc_particles_) {
-            unique_particles.insert(mc_particle.get());
+            unique_particles.push_back(mc_particle.get());
         }
+        std::sort(unique_particles.begin(), unique_particles.end(), std::less<>());
+        unique_particles.erase(std::unique(unique_particles.begin(), unique_particles.end()), unique_particles.end());
+
         // Store the MC particle references
+        mc_particles_.reserve(unique_particles.size());
         for(const auto& mc_particle : unique_particles) {
             mc_particles_.emplace_back(mc_particle);
         }
@@ -88,6 +88,23 @@ namespace allpix {
             }
         }
     };
+
+    /**
+     * @ingroup Exceptions
+     * @brief Indicates that the geometries of two detectors are registered under the same identifier
+     */
+    class GeometryCollisionException : public RuntimeError {
+    public:
+        /**
+         * @brief Constructs an error for two detector names mapping to the same geometry identifier
+         * @param name Name of the detector whose geometry is registered
+         * @param other Name of the detector already registered under the same identifier
+         */
+        GeometryCollisionException(const std::string& name, const std::string& other) {
+            error_message_ = "Geometry of detector " + name + " cannot be registered, its identifier is already taken by ";
+            error_message_ += "detector " + other + ", choose a different name";
+        }
+    };
 } // namespace allpix
 
 #endif /* ALLPIX_OBJECT_EXCEPTIONS_H */
@@ -0,0 +1,102 @@
+/**
+ * @file
+ * @brief Utility to share field grids stored with reduced precision between module instantiations
+ *
+ * @copyright Copyright (c) 2023 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_FIELD_GRID_CACHE_H
+#define ALLPIX_FIELD_GRID_CACHE_H
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include <magic_enum/magic_enum.hpp>
+
+#include "core/geometry/FieldGrid.hpp"
+#include "core/utils/log.h"
+#include "core/utils/unit.h"
+#include "tools/field_parser.h"
+
+namespace allpix {
+
+    /**
+     * @brief Cache of field grids converted to the precision requested by the reader modules
+     *
+     * Fields stored in double precision are passed on as read. Fields stored with reduced precision are converted once and
+     * shared between module instantiations reading the same field with the same precision. After the conversion, the field
+     * data read from file can be released to not keep the values in double precision in memory.
+     */
+    class FieldGridCache {
+    public:
+        /**
+         * @brief Construct a cache for field grids of one quantity
+         * @param quantity Name of the field quantity used in log messages
+         * @param units Units to display the quantization error in, internal units are displayed if empty
+         */
+        explicit FieldGridCache(std::string quantity, std::string units = std::string())
+            : quantity_(std::move(quantity)), units_(std::move(units)) {}
+
+        /**
+         * @brief Get the field with the requested precision
+         * @param key Identifier of the field data, e.g. the canonical paths of the files it is read from
+         * @param precision Precision to store the values with
+         * @param read Callable returning the field data in double precision
+         * @param release Callable taking the field data read after its conversion to release it from other caches
+         * @return Data of the field without values and the grid holding the values, the field data holds the values if they
+         *         are stored in double precision
+         */
+        template <typename R, typename F>
+        std::pair<FieldData<double>, FieldGrid> get(const std::string& key, FieldPrecision precision, R read, F release) {
+            if(precision == FieldPrecision::DOUBLE) {
+                auto field_data = read();
+                return {field_data, field_data.getData()};
+            }
+
+            // Look for a field with the same identifier stored with the same precision
+            auto cache_key = std::string(magic_enum::enum_name(precision)) + ":" + key;
+            auto cached = field_grids_.find(cache_key);
+            if(cached != field_grids_.end()) {
+                LOG(INFO) << "Using cached " << quantity_ << " stored with " << magic_enum::enum_name(precision)
+                          << " precision";
+                return cached->second;
+            }
+
+            auto field_data = read();
+            FieldGrid field_grid(*field_data.getData(), precision);
+            auto error = field_grid.getMaximumError();
+            std::stringstream error_text;
+            if(units_.empty()) {
+                error_text << error;
+            } else {
+                error_text << Units::display(error, units_);
+            }
+            LOG(INFO) << "Stored " << quantity_ << " with " << magic_enum::enum_name(precision) << " precision in "
+                      << (field_grid.getMemorySize() >> 20) << " MiB, maximum quantization error of "
+                      << error_text.str() << " or "
+                      << (field_grid.getMaximumValue() > 0 ? error / field_grid.getMaximumValue() : 0.)
+                      << " of the maximum value";
+            release(field_data);
+
+            auto grid = std::make_pair(
+                FieldData<double>(field_data.getHeader(), field_data.getDimensions(), field_data.getSize(), nullptr),
+                field_grid);
+            field_grids_.emplace(cache_key, grid);
+            return grid;
+        }
+
+    private:
+        std::string quantity_;
+        std::string units_;
+
+        std::map<std::string, std::pair<FieldData<double>, FieldGrid>> field_grids_;
+    };
+} // namespace allpix
+
+#endif /* ALLPIX_FIELD_GRID_CACHE_H */
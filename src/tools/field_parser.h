@@ -18,6 +18,7 @@
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <type_traits>
 
 #include "core/utils/log.h"
 #include "core/utils/unit.h"
@@ -32,6 +33,8 @@
 
 // Mime type version for APF files
 #define APF_MIME_TYPE_VERSION 1
+// Mime type version for APF files with field data stored in single precision
+#define APF_MIME_TYPE_VERSION_FLOAT 2
 
 namespace allpix {
 
@@ -122,18 +125,36 @@ namespace allpix {
 
         friend class cereal::access;
 
-        // Versioned serialization function:
+        // Versioned serialization function, selecting the type of the stored values from the format version:
         template <class Archive> void serialize(Archive& archive, std::uint32_t const version) {
-            // For now, we only know one version of this file type:
-            if(version != 1) {
+            if(version == APF_MIME_TYPE_VERSION) {
+                serialize_as<double>(archive);
+            } else if(version == APF_MIME_TYPE_VERSION_FLOAT) {
+                serialize_as<float>(archive);
+            } else {
                 throw std::runtime_error("unknown format version " + std::to_string(version));
             }
+        }
 
-            // (De-) Serialize the data:
+        // (De-) Serialize the data stored as values of type S, converting them when loading into field data of other type
+        template <typename S, class Archive> void serialize_as(Archive& archive) {
             archive(header_);
             archive(dimensions_);
-            archive(size_);
-            archive(data_);
+            if constexpr(std::is_same_v<S, T>) {
+                archive(size_);
+                archive(data_);
+            } else if constexpr(Archive::is_loading::value) {
+                std::array<S, 3> size{};
+                std::shared_ptr<std::vector<S>> data;
+                archive(size);
+                archive(data);
+                LOG(DEBUG) << "Converting " << data->size() << " field values stored with " << sizeof(S)
+                           << " bytes per value to " << sizeof(T) << " bytes per value";
+                std::transform(size.begin(), size.end(), size_.begin(), [](S value) { return static_cast<T>(value); });
+                data_ = std::make_shared<std::vector<T>>(data->begin(), data->end());
+            } else {
+                throw std::runtime_error("field data can only be stored with their own value type");
+            }
         }
     };
 } // namespace allpix
@@ -145,7 +166,8 @@ namespace cereal {
             static const std::uint32_t version;
             static std::uint32_t registerVersion() {
                 ::cereal::detail::StaticObject<Versions>::getInstance().mapping.emplace(
-                    std::type_index(typeid(allpix::FieldData<T>)).hash_code(), APF_MIME_TYPE_VERSION);
+                    std::type_index(typeid(allpix::FieldData<T>)).hash_code(),
+                    std::is_same_v<T, float> ? APF_MIME_TYPE_VERSION_FLOAT : APF_MIME_TYPE_VERSION);
                 return 3;
             }
             static void unused() { (void)version; } // NOLINT
@@ -227,6 +249,14 @@ namespace allpix {
             return field_data;
         }
 
+        /**
+         * @brief Remove field data from the cache
+         * @param file_name File name of the field data to be removed
+         *
+         * The memory of the field data is freed as soon as no other copies of the field data object are in use.
+         */
+        void release(const std::filesystem::path& file_name) { field_map_.erase(std::filesystem::canonical(file_name)); }
+
     private:
         /**
          * @brief Check if the file is a binary file
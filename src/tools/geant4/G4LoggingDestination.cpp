@@ -39,7 +39,7 @@ void G4LoggingDestination::process_message(LogLevel level, std::string& msg) con
         msg.pop_back();
         auto prev_section = Log::getSection();
         Log::setSection("Geant4");
-        allpix::Log().getStream(level, __FILE_NAME__, std::string(static_cast<const char*>(__func__)), __LINE__) << msg;
+        allpix::Log().getStream(level, __FILE_NAME__, static_cast<const char*>(__func__), __LINE__) << msg;
         Log::setSection(prev_section);
     }
 }
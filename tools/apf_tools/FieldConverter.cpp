@@ -10,6 +10,7 @@
  */
 
 #include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <string>
 
@@ -46,6 +47,7 @@ int main(int argc, const char* argv[]) {
         std::string file_output;
         std::string units;
         bool scalar = false;
+        bool single_precision = false;
         for(int i = 1; i < argc; i++) {
             if(strcmp(argv[i], "-h") == 0) {
                 print_help = true;
@@ -68,6 +70,8 @@ int main(int argc, const char* argv[]) {
                 units = std::string(argv[++i]);
             } else if(strcmp(argv[i], "--scalar") == 0) {
                 scalar = true;
+            } else if(strcmp(argv[i], "--float") == 0) {
+                single_precision = true;
             } else {
                 LOG(ERROR) << "Unrecognized command line argument \"" << argv[i] << "\"";
                 print_help = true;
@@ -88,6 +92,8 @@ int main(int argc, const char* argv[]) {
             std::cout << "  --units <units>  units the field is provided in" << std::endl << std::endl;
             std::cout << "Options:" << std::endl;
             std::cout << "  --scalar         Convert scalar field. Default is vector field" << std::endl;
+            std::cout << "  --float          Store field values in single precision (APF only). Default is double precision"
+                      << std::endl;
             std::cout << std::endl;
             std::cout << "For more help, please see <https://cern.ch/allpix-squared>" << std::endl;
             return return_code;
@@ -98,9 +104,32 @@ int main(int argc, const char* argv[]) {
         FieldParser<double> field_parser(quantity);
         LOG(STATUS) << "Reading input file from " << file_input;
         auto field_data = field_parser.getByFileName(file_input, units);
-        FieldWriter<double> field_writer(quantity);
         LOG(STATUS) << "Writing output file to " << file_output;
-        field_writer.writeFile(field_data, file_output, format_to, (format_to == FileType::INIT ? units : ""));
+        if(single_precision) {
+            // Convert the field values and report the largest deviation introduced by the conversion
+            auto data = std::make_shared<std::vector<float>>();
+            data->reserve(field_data.getData()->size());
+            double max_value = 0, max_error = 0;
+            for(const auto& value : *field_data.getData()) {
+                data->push_back(static_cast<float>(value));
+                max_value = std::max(max_value, std::fabs(value));
+                max_error = std::max(max_error, std::fabs(static_cast<double>(data->back()) - value));
+            }
+            LOG(STATUS) << "Converted field values to single precision, maximum deviation is " << max_error << " ("
+                        << (max_value > 0 ? max_error / max_value : 0.) << " of the maximum field value)";
+
+            auto size = field_data.getSize();
+            FieldData<float> float_data(
+                field_data.getHeader(),
+                field_data.getDimensions(),
+                {{static_cast<float>(size[0]), static_cast<float>(size[1]), static_cast<float>(size[2])}},
+                data);
+            FieldWriter<float> field_writer(quantity);
+            field_writer.writeFile(float_data, file_output, format_to, (format_to == FileType::INIT ? units : ""));
+        } else {
+            FieldWriter<double> field_writer(quantity);
+            field_writer.writeFile(field_data, file_output, format_to, (format_to == FileType::INIT ? units : ""));
+        }
     } catch(std::exception& e) {
         LOG(FATAL) << "Fatal internal error" << std::endl << e.what() << std::endl << "Cannot continue.";
         return_code = 127;
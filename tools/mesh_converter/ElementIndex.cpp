@@ -0,0 +1,101 @@
+/**
+ * @file
+ *
+ * @copyright Copyright (c) 2023 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "ElementIndex.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+#include "core/utils/log.h"
+
+// Maximum number of elements stored in a leaf node
+#define LEAF_SIZE 8
+
+using namespace mesh_converter;
+
+ElementIndex::ElementIndex(const std::vector<Point>& points, const std::vector<Simplex>& elements, size_t dimension) {
+    if(elements.size() >= std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Too many mesh elements to build element index");
+    }
+
+    // Calculate bounding boxes and centers of all elements
+    boxes_.reserve(elements.size());
+    centers_.reserve(elements.size());
+    for(const auto& element : elements) {
+        Box box{};
+        box.min.fill(std::numeric_limits<double>::max());
+        box.max.fill(std::numeric_limits<double>::lowest());
+        for(size_t i = 0; i <= dimension; i++) {
+            const auto& vertex = points[element[i]];
+            std::array<double, 3> coordinates{{vertex.x, vertex.y, vertex.z}};
+            for(size_t axis = 0; axis < 3; axis++) {
+                box.min[axis] = std::min(box.min[axis], coordinates[axis]);
+                box.max[axis] = std::max(box.max[axis], coordinates[axis]);
+            }
+        }
+        centers_.push_back({{(box.min[0] + box.max[0]) / 2, (box.min[1] + box.max[1]) / 2, (box.min[2] + box.max[2]) / 2}});
+        boxes_.push_back(box);
+    }
+
+    order_.resize(elements.size());
+    std::iota(order_.begin(), order_.end(), 0);
+    if(!elements.empty()) {
+        nodes_.reserve(2 * elements.size() / LEAF_SIZE + 1);
+        build(0, static_cast<uint32_t>(elements.size()));
+    }
+
+    // Centers are only required to construct the hierarchy
+    centers_ = {};
+    LOG(DEBUG) << "Built element index with " << nodes_.size() << " nodes for " << elements.size() << " elements";
+}
+
+uint32_t ElementIndex::build(uint32_t first, uint32_t count) {
+    auto index = static_cast<uint32_t>(nodes_.size());
+
+    // Bounding box of all elements in this node, and of their centers to determine the split axis
+    Box box{}, center_box{};
+    box.min.fill(std::numeric_limits<double>::max());
+    box.max.fill(std::numeric_limits<double>::lowest());
+    center_box = box;
+    for(auto i = first; i < first + count; i++) {
+        for(size_t axis = 0; axis < 3; axis++) {
+            box.min[axis] = std::min(box.min[axis], boxes_[order_[i]].min[axis]);
+            box.max[axis] = std::max(box.max[axis], boxes_[order_[i]].max[axis]);
+            center_box.min[axis] = std::min(center_box.min[axis], centers_[order_[i]][axis]);
+            center_box.max[axis] = std::max(center_box.max[axis], centers_[order_[i]][axis]);
+        }
+    }
+    nodes_.push_back({box, first, count});
+    if(count <= LEAF_SIZE) {
+        return index;
+    }
+
+    // Split at the median of the element centers along the longest axis
+    size_t axis = 0;
+    for(size_t i = 1; i < 3; i++) {
+        if(center_box.max[i] - center_box.min[i] > center_box.max[axis] - center_box.min[axis]) {
+            axis = i;
+        }
+    }
+    auto half = count / 2;
+    std::nth_element(order_.begin() + first,
+                     order_.begin() + first + half,
+                     order_.begin() + first + count,
+                     [&](uint32_t a, uint32_t b) { return centers_[a][axis] < centers_[b][axis]; });
+
+    // The first child directly follows this node, the second child is referenced
+    build(first, half);
+    auto second = build(first + half, count - half);
+    nodes_[index].first = second;
+    nodes_[index].count = 0;
+    return index;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file
+ *
+ * @copyright Copyright (c) 2023 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_ELEMENTINDEX_H
+#define ALLPIX_ELEMENTINDEX_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "MeshElement.hpp"
+
+namespace mesh_converter {
+
+    /**
+     * @brief Bounding volume hierarchy over the simplex elements of the input mesh
+     *
+     * The hierarchy is built from axis-aligned bounding boxes of the elements, split at the median of the element centers
+     * along the longest axis. Locating a point only descends into the nodes whose bounding box contains the point, such that
+     * the number of elements to test stays small independent of the size of the mesh.
+     */
+    class ElementIndex {
+    public:
+        /**
+         * @brief Construct the hierarchy
+         * @param points   Vertices of the mesh
+         * @param elements Simplex elements with indices into the vertices
+         * @param dimension Dimension of the mesh, 2 for triangles and 3 for tetrahedra
+         */
+        ElementIndex(const std::vector<Point>& points, const std::vector<Simplex>& elements, size_t dimension);
+
+        /**
+         * @brief Visit all elements whose bounding box contains the given point
+         * @param point   Point to locate
+         * @param visitor Callable receiving the element index, returning true to stop the search
+         * @return True if the search has been stopped by the visitor, false otherwise
+         */
+        template <typename Visitor> bool find(const Point& point, Visitor&& visitor) const;
+
+    private:
+        struct Box {
+            std::array<double, 3> min;
+            std::array<double, 3> max;
+
+            bool contains(const Point& point) const {
+                return point.x >= min[0] && point.x <= max[0] && point.y >= min[1] && point.y <= max[1] &&
+                       point.z >= min[2] && point.z <= max[2];
+            }
+        };
+
+        /**
+         * @brief Node of the hierarchy, either holding a range of elements or two child nodes
+         */
+        struct Node {
+            Box box;
+            uint32_t first; ///< First element of leaf nodes or index of the second child of inner nodes
+            uint32_t count; ///< Number of elements of leaf nodes, zero for inner nodes
+        };
+
+        /**
+         * @brief Recursively build the node for a range of elements
+         * @return Index of the created node
+         */
+        uint32_t build(uint32_t first, uint32_t count);
+
+        std::vector<Box> boxes_;
+        std::vector<std::array<double, 3>> centers_;
+        std::vector<uint32_t> order_;
+        std::vector<Node> nodes_;
+    };
+
+    template <typename Visitor> bool ElementIndex::find(const Point& point, Visitor&& visitor) const {
+        if(nodes_.empty()) {
+            return false;
+        }
+
+        // Depth-first traversal, the first child of an inner node directly follows its parent
+        std::vector<uint32_t> stack{0};
+        while(!stack.empty()) {
+            const auto& node = nodes_[stack.back()];
+            auto node_index = stack.back();
+            stack.pop_back();
+            if(!node.box.contains(point)) {
+                continue;
+            }
+
+            if(node.count == 0) {
+                stack.push_back(node.first);
+                stack.push_back(node_index + 1);
+                continue;
+            }
+
+            for(auto i = node.first; i < node.first + node.count; i++) {
+                if(boxes_[order_[i]].contains(point) && visitor(static_cast<size_t>(order_[i]))) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+} // namespace mesh_converter
+
+#endif // ALLPIX_ELEMENTINDEX_H
@@ -9,6 +9,7 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <cfloat>
 #include <chrono>
 #include <climits>
@@ -16,6 +17,8 @@
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -35,6 +38,7 @@
 #include "tools/field_parser.h"
 #include "tools/units.h"
 
+#include "ElementIndex.hpp"
 #include "MeshElement.hpp"
 #include "MeshParser.hpp"
 #include "combinations/combinations.h"
@@ -223,6 +227,7 @@ int main(int argc, char** argv) {
 
         std::string grid_file = file_prefix + ".grd";
         std::vector<Point> points = parser->getMesh(grid_file, regions);
+        std::vector<Simplex> elements = parser->getElements(grid_file, regions);
 
         // Obtain number of mesh dimensions from mesh point:
         XYZVectorUInt divisions;
@@ -353,6 +358,47 @@ int main(int argc, char** argv) {
         unibn::Octree<Point> octree;
         octree.initialize(points);
 
+        // Index the mesh elements to locate the element containing a point directly, if connectivity is available
+        std::unique_ptr<ElementIndex> element_index;
+        if(interpolate && !elements.empty()) {
+            LOG(STATUS) << "Indexing " << elements.size() << " mesh elements for point location";
+            element_index = std::make_unique<ElementIndex>(points, elements, dimension);
+        } else if(interpolate) {
+            LOG(STATUS) << "No mesh element connectivity available, interpolating from neighbor search only";
+        }
+        std::atomic<uint64_t> points_located{0};
+
+        // Interpolate within the mesh element containing the point, trying the previously found element first
+        auto locate = [&](const Point& q, size_t& last_element, Point& result) {
+            auto interpolate_element = [&](size_t idx) {
+                std::array<Point, 4> grid_elements;
+                std::array<Point, 4> field_elements;
+                for(size_t i = 0; i <= dimension; i++) {
+                    grid_elements[i] = points[elements[idx][i]];
+                    field_elements[i] = field[elements[idx][i]];
+                }
+
+                // Elements of the mesh are not subject to the volume cut, only degenerate elements are skipped
+                auto reference = q;
+                MeshElement element(dimension, grid_elements, field_elements);
+                if(!element.isValid(std::numeric_limits<double>::min(), reference)) {
+                    return false;
+                }
+                LOG(DEBUG) << element.print(reference);
+                result = element.getObservable(reference);
+                if(!result.isFinite()) {
+                    return false;
+                }
+                last_element = idx;
+                return true;
+            };
+
+            if(last_element < elements.size() && interpolate_element(last_element)) {
+                return true;
+            }
+            return element_index->find(q, interpolate_element);
+        };
+
         unsigned int mesh_points_done = 0;
         auto mesh_section = [&](double x, double y) {
             Log::setReportingLevel(log_level);
@@ -360,6 +406,9 @@ int main(int argc, char** argv) {
             // New mesh slice
             std::vector<Point> new_mesh;
 
+            // Consecutive points are close, the element found last is likely to contain the next point as well
+            size_t last_element = std::numeric_limits<size_t>::max();
+
             double z = minz + zstep / 2.0;
             for(unsigned int k = 0; k < divisions.z(); ++k) {
                 // New mesh vertex and field
@@ -374,6 +423,14 @@ int main(int argc, char** argv) {
                     continue;
                 }
 
+                // Use the mesh element containing the point if available
+                if(element_index && locate(q, last_element, e)) {
+                    points_located++;
+                    new_mesh.push_back(e);
+                    z += zstep;
+                    continue;
+                }
+
                 bool valid = false;
                 bool allow_zero_volume = false;
                 size_t prev_neighbours = 0;
@@ -504,6 +561,10 @@ int main(int argc, char** argv) {
         end = std::chrono::system_clock::now();
         elapsed_seconds = std::chrono::duration_cast<std::chrono::seconds>(end - start).count();
         LOG(INFO) << "New mesh created in " << elapsed_seconds << " seconds.";
+        if(element_index) {
+            LOG(INFO) << "Located " << points_located.load() << " of " << mesh_points_total
+                      << " points in mesh elements, used neighbor search for the remaining points";
+        }
 
         // Prepare header and auxiliary information:
         std::string header =
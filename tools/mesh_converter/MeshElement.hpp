@@ -38,6 +38,10 @@ namespace mesh_converter {
         }
     };
 
+    // Connectivity of a triangle or tetrahedron of the input mesh as indices of its vertices, the last index is unused for
+    // triangles of 2D meshes
+    using Simplex = std::array<size_t, 4>;
+
     /**
      * @brief Tetrahedron class for the 3D barycentric interpolation
      */
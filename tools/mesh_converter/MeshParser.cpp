@@ -8,6 +8,7 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <cstdlib>
 #include <iomanip>
 
 #include "MeshParser.hpp"
@@ -32,7 +33,7 @@ std::vector<Point> MeshParser::getMesh(const std::string& file, const std::vecto
     // Populate mesh map once:
     if(mesh_map_[file].empty()) {
         LOG(STATUS) << "Reading mesh grid from file \"" << file << "\"";
-        mesh_map_[file] = read_meshes(file);
+        mesh_map_[file] = read_meshes(file, element_map_[file]);
         LOG(INFO) << "Grid sizes for all regions:";
         for(auto& reg : mesh_map_[file]) {
             LOG(INFO) << "\t" << std::left << std::setw(25) << reg.first << " " << reg.second.size();
@@ -59,6 +60,31 @@ std::vector<Point> MeshParser::getMesh(const std::string& file, const std::vecto
     return points;
 }
 
+std::vector<Simplex> MeshParser::getElements(const std::string& file, const std::vector<std::string>& regions) {
+    if(mesh_map_.find(file) == mesh_map_.end()) {
+        throw std::runtime_error("Mesh elements requested before reading mesh grid from file \"" + file + "\"");
+    }
+
+    // Append the elements of all regions, shifting vertex indices by the points of preceding regions:
+    std::vector<Simplex> elements;
+    size_t offset = 0;
+    for(const auto& region : regions) {
+        auto region_elements = element_map_[file].find(region);
+        if(region_elements != element_map_[file].end()) {
+            for(auto element : region_elements->second) {
+                for(auto& vertex : element) {
+                    vertex += offset;
+                }
+                elements.push_back(element);
+            }
+        }
+        offset += mesh_map_[file][region].size();
+    }
+
+    LOG(DEBUG) << "Mesh connectivity with " << elements.size() << " elements";
+    return elements;
+}
+
 std::vector<Point>
 MeshParser::getField(const std::string& file, const std::string& observable, const std::vector<std::string>& regions) {
 
@@ -97,3 +123,37 @@ MeshParser::getField(const std::string& file, const std::string& observable, con
 
     return field;
 }
+
+void MeshParser::parse_numbers(const std::string& line, std::vector<double>& numbers) {
+    const char* pos = line.c_str();
+    char* end = nullptr;
+    while(true) {
+        auto value = std::strtod(pos, &end);
+        if(end == pos) {
+            break;
+        }
+        numbers.push_back(value);
+        pos = end;
+    }
+}
+
+void MeshParser::parse_numbers(const std::string& line, std::vector<long>& numbers) {
+    const char* pos = line.c_str();
+    char* end = nullptr;
+    while(true) {
+        auto value = std::strtol(pos, &end, 10);
+        if(end == pos) {
+            break;
+        }
+        numbers.push_back(value);
+        pos = end;
+    }
+}
+
+long long MeshParser::parsing_progress(std::ifstream& file, std::uintmax_t file_size) {
+    auto position = static_cast<long long>(file.tellg());
+    if(position < 0 || file_size == 0) {
+        return 100;
+    }
+    return 100 * position / static_cast<long long>(file_size);
+}
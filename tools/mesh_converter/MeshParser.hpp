@@ -14,6 +14,8 @@
 #include "MeshElement.hpp"
 #include "core/config/Configuration.hpp"
 
+#include <cstdint>
+#include <fstream>
 #include <map>
 #include <memory>
 #include <string>
@@ -22,6 +24,7 @@
 namespace mesh_converter {
 
     using MeshMap = std::map<std::string, std::vector<Point>>;
+    using ElementMap = std::map<std::string, std::vector<Simplex>>;
     using FieldMap = std::map<std::string, std::map<std::string, std::vector<Point>>>;
 
     /**
@@ -36,6 +39,16 @@ namespace mesh_converter {
         virtual ~MeshParser() = default;
 
         std::vector<Point> getMesh(const std::string& file, const std::vector<std::string>& regions);
+
+        /**
+         * @brief Obtain the connectivity of the mesh elements for the given regions
+         * @param  file    Canonical path of the grid file, which has to be read via \ref getMesh before
+         * @param  regions Regions to obtain the elements for, in the same order as for \ref getMesh
+         * @return         Simplex elements with vertex indices referring to the points returned by \ref getMesh. Empty if
+         *                 the file format does not provide connectivity information
+         */
+        std::vector<Simplex> getElements(const std::string& file, const std::vector<std::string>& regions);
+
         std::vector<Point>
         getField(const std::string& file, const std::string& observable, const std::vector<std::string>& regions);
 
@@ -48,9 +61,11 @@ namespace mesh_converter {
         /**
          * @brief Method to read grids of mesh points from the given file
          * @param  file_name Canonical path of the input file
+         * @param  elements  Map to store the simplex elements of all regions in, if available from the file format. Vertex
+         *                   indices refer to the mesh points of the respective region
          * @return           Map with mesh points for all regions found in the file
          */
-        virtual MeshMap read_meshes(const std::string& file_name) = 0;
+        virtual MeshMap read_meshes(const std::string& file_name, ElementMap& elements) = 0;
 
         /**
          * @brief Method to read fields from the given file
@@ -60,9 +75,27 @@ namespace mesh_converter {
          */
         virtual FieldMap read_fields(const std::string& file_name, const std::string& observable = "") = 0;
 
+        /**
+         * @brief Helper to parse all numbers of a line of the input files, avoiding the overhead of string streams
+         * @param line    Line to parse
+         * @param numbers Vector to append the numbers to
+         */
+        static void parse_numbers(const std::string& line, std::vector<double>& numbers);
+        static void parse_numbers(const std::string& line, std::vector<long>& numbers);
+
+        /**
+         * @brief Helper to determine the parsing progress of a file from the current read position
+         * @param file      Stream of the file being parsed
+         * @param file_size Total size of the file in bytes
+         * @return          Parsing progress in percent
+         */
+        static long long parsing_progress(std::ifstream& file, std::uintmax_t file_size);
+
     private:
         // Cache of parsed meshes for all regions
         std::map<std::string, MeshMap> mesh_map_;
+        // Cache of parsed mesh elements for all regions
+        std::map<std::string, ElementMap> element_map_;
         // Cache of parsed fields for all regions
         std::map<std::string, FieldMap> field_map_;
     };
@@ -13,6 +13,7 @@
 #include <cassert>
 #include <cstdlib>
 #include <exception>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <regex>
@@ -26,17 +27,20 @@
 
 using namespace mesh_converter;
 
-MeshMap DFISEParser::read_meshes(const std::string& file_name) {
+MeshMap DFISEParser::read_meshes(const std::string& file_name, ElementMap& region_elements) {
     std::ifstream file(file_name);
     if(!file) {
         throw std::runtime_error("file cannot be accessed");
     }
 
-    // Get the total number of lines to parse and reset file to the start:
-    auto num_lines = std::count(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>(), '\n');
-    file.clear();
-    file.seekg(0, std::ios::beg);
-    LOG(DEBUG) << "Grid file contains " << num_lines << " lines to parse";
+    // Get the file size to report the parsing progress without reading the file twice:
+    auto file_size = std::filesystem::file_size(file_name);
+    LOG(DEBUG) << "Grid file contains " << file_size << " bytes to parse";
+
+    // Regular expressions for section headers
+    static const std::regex header_regex("([a-zA-Z]+) \\{");
+    static const std::regex header_data_regex("([a-zA-Z]+) \\((\\S+)\\) \\{");
+    static const std::regex key_value_regex("([a-zA-Z]+)\\s+=\\s+([\\S ]+)");
 
     DFSection main_section = DFSection::HEADER;
     DFSection sub_section = DFSection::NONE;
@@ -44,22 +48,29 @@ MeshMap DFISEParser::read_meshes(const std::string& file_name) {
     std::vector<Point> vertices;
     std::vector<std::pair<long unsigned int, long unsigned int>> edges;
     std::vector<std::vector<long unsigned int>> faces;
-    std::vector<std::vector<long unsigned int>> elements;
 
-    std::map<std::string, std::vector<long unsigned int>> regions_vertices;
+    // Unique vertices of all elements, stored consecutively with the offset of every element
+    std::vector<long unsigned int> element_vertices;
+    std::vector<size_t> element_offsets{0};
+    std::vector<char> element_types;
+    size_t elements_count = 0;
+
+    std::map<std::string, std::vector<long unsigned int>> regions_elements;
 
     std::string region;
     long unsigned int dimension = 1;
     long unsigned int data_count = 0;
     bool in_data_block = false;
     long long num_lines_parsed = 0;
+    std::vector<long> numbers;
+    std::vector<double> coordinates;
     while(!file.eof()) {
         std::string line;
         std::getline(file, line);
 
         // Log the parsing progress:
-        if(num_lines > 0 && num_lines_parsed % 1000 == 0) {
-            LOG_PROGRESS(STATUS, "gridlines") << "Parsing grid file: " << (100 * num_lines_parsed / num_lines) << "%";
+        if(num_lines_parsed % 1000 == 0) {
+            LOG_PROGRESS(STATUS, "gridlines") << "Parsing grid file: " << parsing_progress(file, file_size) << "%";
         }
         num_lines_parsed++;
 
@@ -71,9 +82,8 @@ MeshMap DFISEParser::read_meshes(const std::string& file_name) {
         // Check if line with begin of section
         if(line.find('{') != std::string::npos) {
             // Search for new simple headers
-            auto base_regex = std::regex("([a-zA-Z]+) \\{");
             std::smatch base_match;
-            if(std::regex_match(line, base_match, base_regex) && base_match.ready()) {
+            if(std::regex_match(line, base_match, header_regex) && base_match.ready()) {
                 auto header_string = base_match[1].str();
 
                 if(header_string == "Info") {
@@ -90,8 +100,7 @@ MeshMap DFISEParser::read_meshes(const std::string& file_name) {
             }
 
             // Search for headers with data
-            base_regex = std::regex("([a-zA-Z]+) \\((\\S+)\\) \\{");
-            if(std::regex_match(line, base_match, base_regex) && base_match.ready()) {
+            if(std::regex_match(line, base_match, header_data_regex) && base_match.ready()) {
                 auto header_string = base_match[1].str();
                 auto header_data = base_match[2].str();
 
@@ -101,17 +110,22 @@ MeshMap DFISEParser::read_meshes(const std::string& file_name) {
                 } else if(header_string == "Vertices") {
                     main_section = DFSection::VERTICES;
                     data_count = std::stoul(header_data);
+                    vertices.reserve(data_count);
                 } else if(header_string == "Edges") {
                     main_section = DFSection::EDGES;
                     data_count = std::stoul(header_data);
+                    edges.reserve(data_count);
                 } else if(header_string == "Faces") {
                     main_section = DFSection::FACES;
                     data_count = std::stoul(header_data);
+                    faces.reserve(data_count);
                 } else if(header_string == "Elements") {
                     if(main_section == DFSection::REGION) {
                         sub_section = DFSection::ELEMENTS;
                     } else {
                         main_section = DFSection::ELEMENTS;
+                        element_offsets.reserve(std::stoul(header_data) + 1);
+                        element_types.reserve(std::stoul(header_data));
                     }
                     data_count = std::stoul(header_data);
                 } else {
@@ -145,7 +159,7 @@ MeshMap DFISEParser::read_meshes(const std::string& file_name) {
                 }
                 break;
             case DFSection::ELEMENTS:
-                if(elements.size() != data_count) {
+                if(elements_count != data_count) {
                     throw std::runtime_error("incorrect number of elements");
                 }
                 break;
@@ -169,9 +183,8 @@ MeshMap DFISEParser::read_meshes(const std::string& file_name) {
 
         // Look for key data pairs
         if(line.find('=') != std::string::npos) {
-            auto base_regex = std::regex("([a-zA-Z]+)\\s+=\\s+([\\S ]+)");
             std::smatch base_match;
-            if(std::regex_match(line, base_match, base_regex) && base_match.ready()) {
+            if(std::regex_match(line, base_match, key_value_regex) && base_match.ready()) {
                 auto key = base_match[1].str();
                 auto value = allpix::trim(base_match[2].str());
 
@@ -189,7 +202,6 @@ MeshMap DFISEParser::read_meshes(const std::string& file_name) {
         }
 
         // Handle data
-        std::stringstream sstr(line);
         switch(main_section) {
         case DFSection::HEADER:
             if(line != "DF-ISE text") {
@@ -199,24 +211,27 @@ MeshMap DFISEParser::read_meshes(const std::string& file_name) {
             break;
         case DFSection::VERTICES: {
             // Read vertex points
+            coordinates.clear();
+            parse_numbers(line, coordinates);
             if(dimension == 3) {
-                double x = 0, y = 0, z = 0;
-                while(sstr >> x >> y >> z) {
-                    vertices.emplace_back(x, y, z);
+                for(size_t i = 0; i + 2 < coordinates.size(); i += 3) {
+                    vertices.emplace_back(coordinates[i], coordinates[i + 1], coordinates[i + 2]);
                 }
             }
             if(dimension == 2) {
-                double y = 0, z = 0;
-                while(sstr >> y >> z) {
-                    vertices.emplace_back(y, z);
+                for(size_t i = 0; i + 1 < coordinates.size(); i += 2) {
+                    vertices.emplace_back(coordinates[i], coordinates[i + 1]);
                 }
             }
         } break;
         case DFSection::EDGES: {
             // Read edges
-            std::pair<long unsigned int, long unsigned int> edge;
-            while(sstr >> edge.first >> edge.second) {
-                if(edge.first >= vertices.size() || edge.second >= vertices.size()) {
+            numbers.clear();
+            parse_numbers(line, numbers);
+            for(size_t i = 0; i + 1 < numbers.size(); i += 2) {
+                std::pair<long unsigned int, long unsigned int> edge(numbers[i], numbers[i + 1]);
+                if(numbers[i] < 0 || numbers[i + 1] < 0 || edge.first >= vertices.size() ||
+                   edge.second >= vertices.size()) {
                     throw std::runtime_error("vertex index is higher than number of vertices");
                 }
                 edges.push_back(edge);
@@ -224,12 +239,15 @@ MeshMap DFISEParser::read_meshes(const std::string& file_name) {
         } break;
         case DFSection::FACES: {
             // Get vertex indices for every face
-            size_t n = 0;
-            sstr >> n;
+            numbers.clear();
+            parse_numbers(line, numbers);
+            size_t n = (numbers.empty() ? 0 : static_cast<size_t>(numbers.front()));
+            if(numbers.size() < n + 1) {
+                throw std::runtime_error("incomplete face definition");
+            }
             std::vector<long unsigned int> face;
             for(size_t i = 0; i < n; ++i) {
-                long edge_idx = 0;
-                sstr >> edge_idx;
+                long edge_idx = numbers[i + 1];
 
                 bool swap = false;
                 if(edge_idx < 0) {
@@ -267,10 +285,11 @@ MeshMap DFISEParser::read_meshes(const std::string& file_name) {
             faces.push_back(face);
         } break;
         case DFSection::ELEMENTS: {
-            int k = 0;
-            sstr >> k;
-            std::vector<long unsigned int> element;
+            numbers.clear();
+            parse_numbers(line, numbers);
+            auto k = (numbers.empty() ? -1 : numbers.front());
 
+            // Number of edges (two-dimensional elements) or faces (three-dimensional elements) the element consists of
             size_t size = 0;
             switch(k) {
             case 0: /* vertex */
@@ -300,10 +319,13 @@ MeshMap DFISEParser::read_meshes(const std::string& file_name) {
             default:
                 throw std::runtime_error("element type " + std::to_string(k) + " is not supported");
             }
+            if(numbers.size() < size + 1) {
+                throw std::runtime_error("incomplete element definition");
+            }
 
+            auto element_begin = element_vertices.size();
             for(size_t i = 0; i < size; ++i) {
-                long element_idx = 0;
-                sstr >> element_idx;
+                long element_idx = numbers[i + 1];
 
                 bool reverse = false;
                 if(element_idx < 0) {
@@ -311,7 +333,7 @@ MeshMap DFISEParser::read_meshes(const std::string& file_name) {
                     element_idx = -element_idx - 1;
                 }
 
-                if(size == 3 || size == 2) {
+                if(k >= 1 && k <= 3) {
                     if(element_idx >= static_cast<long>(edges.size())) {
                         throw std::runtime_error("edge index is higher than number of faces");
                     }
@@ -319,36 +341,38 @@ MeshMap DFISEParser::read_meshes(const std::string& file_name) {
                     if(reverse) {
                         std::swap(edge.first, edge.second);
                     }
-                    element.push_back(edge.first);
-                    element.push_back(edge.second);
+                    element_vertices.push_back(edge.first);
+                    element_vertices.push_back(edge.second);
                 }
-                if(size == 4) {
+                if(k >= 5) {
                     if(element_idx >= static_cast<long>(faces.size())) {
                         throw std::runtime_error("face index is higher than number of faces");
                     }
-                    auto face = faces[static_cast<size_t>(element_idx)];
-                    if(reverse) {
-                        std::reverse(face.begin() + 1, face.end());
-                    }
-                    element.insert(element.end(), face.begin(), face.end());
+                    const auto& face = faces[static_cast<size_t>(element_idx)];
+                    element_vertices.insert(element_vertices.end(), face.begin(), face.end());
                 }
             }
 
-            elements.push_back(element);
+            // Only keep the unique vertices of the element
+            auto element_begin_it = element_vertices.begin() + static_cast<std::ptrdiff_t>(element_begin);
+            std::sort(element_begin_it, element_vertices.end());
+            element_vertices.erase(std::unique(element_begin_it, element_vertices.end()), element_vertices.end());
+            element_offsets.push_back(element_vertices.size());
+            element_types.push_back(static_cast<char>(k));
+            elements_count++;
             break;
         }
         case DFSection::REGION: {
             if(sub_section != DFSection::ELEMENTS) {
                 continue;
             }
-            long unsigned int elem_idx = 0;
-            while(sstr >> elem_idx) {
-                if(elem_idx >= elements.size()) {
+            numbers.clear();
+            parse_numbers(line, numbers);
+            for(auto elem_idx : numbers) {
+                if(elem_idx < 0 || static_cast<size_t>(elem_idx) >= elements_count) {
                     throw std::runtime_error("element index is higher than number of elements");
                 }
-
-                regions_vertices[region].insert(
-                    regions_vertices[region].end(), elements[elem_idx].begin(), elements[elem_idx].end());
+                regions_elements[region].push_back(static_cast<long unsigned int>(elem_idx));
             }
 
         } break;
@@ -358,21 +382,47 @@ MeshMap DFISEParser::read_meshes(const std::string& file_name) {
     }
     LOG_PROGRESS(STATUS, "gridlines") << "Parsing grid file: done.";
 
-    std::map<std::string, std::vector<Point>> ret_map;
-    for(auto& name_region_vertices : regions_vertices) {
-        auto region_vertices = name_region_vertices.second;
+    // Edges and faces are only required to resolve the element vertices
+    edges = {};
+    faces = {};
 
-        std::sort(region_vertices.begin(), region_vertices.end());
-        auto iter = std::unique(region_vertices.begin(), region_vertices.end());
-        region_vertices.erase(iter, region_vertices.end());
+    std::map<std::string, std::vector<Point>> ret_map;
+    std::vector<size_t> region_index(vertices.size());
+    for(auto& [name, elements] : regions_elements) {
+        // Mark all vertices of the region, keeping them ordered by their index as the values in the data file are
+        std::vector<bool> in_region(vertices.size(), false);
+        for(auto& elem_idx : elements) {
+            for(auto idx = element_offsets[elem_idx]; idx < element_offsets[elem_idx + 1]; ++idx) {
+                in_region[element_vertices[idx]] = true;
+            }
+        }
 
         std::vector<Point> ret_vector;
-        ret_vector.reserve(region_vertices.size());
-        for(auto& vertex_idx : region_vertices) {
-            ret_vector.push_back(vertices[vertex_idx]);
+        for(size_t vertex_idx = 0; vertex_idx < vertices.size(); ++vertex_idx) {
+            if(in_region[vertex_idx]) {
+                region_index[vertex_idx] = ret_vector.size();
+                ret_vector.push_back(vertices[vertex_idx]);
+            }
+        }
+
+        // Store the connectivity of triangles in 2D and tetrahedra in 3D meshes, referring to the points of the region
+        auto& simplices = region_elements[name];
+        const char simplex_type = (dimension == 3 ? 5 : 2);
+        for(auto& elem_idx : elements) {
+            auto begin = element_offsets[elem_idx];
+            if(element_types[elem_idx] != simplex_type || element_offsets[elem_idx + 1] - begin != dimension + 1) {
+                continue;
+            }
+            Simplex simplex{};
+            for(size_t i = 0; i <= dimension; ++i) {
+                simplex[i] = region_index[element_vertices[begin + i]];
+            }
+            simplices.push_back(simplex);
         }
 
-        ret_map[name_region_vertices.first] = ret_vector;
+        LOG(DEBUG) << "Region " << name << " with " << ret_vector.size() << " vertices and " << simplices.size()
+                   << " simplex elements";
+        ret_map[name] = std::move(ret_vector);
     }
 
     return ret_map;
@@ -384,18 +434,24 @@ FieldMap DFISEParser::read_fields(const std::string& file_name, const std::strin
         throw std::runtime_error("file cannot be accessed");
     }
 
-    // Get the total number of lines to parse and reset file to the start:
-    auto num_lines = std::count(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>(), '\n');
-    file.clear();
-    file.seekg(0, std::ios::beg);
-    LOG(DEBUG) << "Field data file contains " << num_lines << " lines to parse";
+    // Get the file size to report the parsing progress without reading the file twice:
+    auto file_size = std::filesystem::file_size(file_name);
+    LOG(DEBUG) << "Field data file contains " << file_size << " bytes to parse";
+
+    // Regular expressions for section headers, key-value pairs and validity regions
+    static const std::regex header_regex("([a-zA-Z]+) \\{");
+    static const std::regex header_data_regex("([a-zA-Z]+) \\((\\S+)\\) \\{");
+    static const std::regex key_value_regex("([a-zA-Z]+)\\s+=\\s+([\\S ]+)");
+    static const std::regex validity_regex("\\[\\s+\"([-\\w\\.]+)\"\\s+\\]");
 
     DFSection main_section = DFSection::HEADER;
     DFSection sub_section = DFSection::NONE;
 
     // std::map<std::string, std::vector<Point>> region_electric_field_map;
     std::map<std::string, std::map<std::string, std::vector<Point>>> region_electric_field_map;
+    // Values which do not yet form a complete data point, and the number of values read for the current dataset
     std::vector<double> region_electric_field_num;
+    size_t values_count = 0;
 
     std::string region;
     std::string observable;
@@ -409,8 +465,8 @@ FieldMap DFISEParser::read_fields(const std::string& file_name, const std::strin
         line = allpix::trim(line);
 
         // Log the parsing progress:
-        if(num_lines > 0 && num_lines_parsed % 1000 == 0) {
-            LOG_PROGRESS(STATUS, "fieldlines") << "Parsing field data file: " << (100 * num_lines_parsed / num_lines) << "%";
+        if(num_lines_parsed % 1000 == 0) {
+            LOG_PROGRESS(STATUS, "fieldlines") << "Parsing field data file: " << parsing_progress(file, file_size) << "%";
         }
         num_lines_parsed++;
 
@@ -421,9 +477,8 @@ FieldMap DFISEParser::read_fields(const std::string& file_name, const std::strin
         // Check if line with begin of section
         if(line.find('{') != std::string::npos) {
             // Search for new simple headers
-            auto base_regex = std::regex("([a-zA-Z]+) \\{");
             std::smatch base_match;
-            if(std::regex_match(line, base_match, base_regex) && base_match.ready()) {
+            if(std::regex_match(line, base_match, header_regex) && base_match.ready()) {
                 auto header_string = base_match[1].str();
                 LOG(TRACE) << "Opening section " << header_string;
 
@@ -441,8 +496,7 @@ FieldMap DFISEParser::read_fields(const std::string& file_name, const std::strin
             }
 
             // Search for headers with data
-            base_regex = std::regex("([a-zA-Z]+) \\((\\S+)\\) \\{");
-            if(std::regex_match(line, base_match, base_regex) && base_match.ready()) {
+            if(std::regex_match(line, base_match, header_data_regex) && base_match.ready()) {
                 auto header_string = base_match[1].str();
                 auto header_data = base_match[2].str();
 
@@ -467,6 +521,7 @@ FieldMap DFISEParser::read_fields(const std::string& file_name, const std::strin
                     LOG(DEBUG) << "Opening value section with " << header_data << " entries";
                     sub_section = DFSection::VALUES;
                     data_count = std::stoul(header_data);
+                    values_count = 0;
                 } else {
                     if(main_section != DFSection::NONE) {
                         sub_section = DFSection::IGNORED;
@@ -481,17 +536,14 @@ FieldMap DFISEParser::read_fields(const std::string& file_name, const std::strin
 
         // Look for key data pairs
         if(line.find('=') != std::string::npos) {
-            auto base_regex = std::regex("([a-zA-Z]+)\\s+=\\s+([\\S ]+)");
             std::smatch base_match;
-            if(std::regex_match(line, base_match, base_regex) && base_match.ready()) {
+            if(std::regex_match(line, base_match, key_value_regex) && base_match.ready()) {
                 auto key = base_match[1].str();
                 auto value = allpix::trim(base_match[2].str());
 
-                // Regular expression for matching validity region:
-                base_regex = std::regex("\\[\\s+\"([-\\w\\.]+)\"\\s+\\]");
                 if(key == "validity") {
                     // Ignore any electric field valid for multiple regions
-                    if(std::regex_match(value, base_match, base_regex) && base_match.ready()) {
+                    if(std::regex_match(value, base_match, validity_regex) && base_match.ready()) {
                         region = base_match[1].str();
                     } else {
                         LOG(INFO) << "Could not determine validity region for string \"" << value << "\", ignoring.";
@@ -576,84 +628,17 @@ FieldMap DFISEParser::read_fields(const std::string& file_name, const std::strin
             continue;
         }
 
+        // Data sections of the observables of interest
+        auto in_values = (main_section == DFSection::ELECTRIC_FIELD || main_section == DFSection::ELECTROSTATIC_POTENTIAL ||
+                          main_section == DFSection::DOPING_CONCENTRATION ||
+                          main_section == DFSection::DONOR_CONCENTRATION ||
+                          main_section == DFSection::ACCEPTOR_CONCENTRATION) &&
+                         sub_section == DFSection::VALUES;
+
         // Look for close of section
         if(line.find('}') != std::string::npos) {
-
-            if(main_section == DFSection::ELECTROSTATIC_POTENTIAL && sub_section == DFSection::VALUES) {
-                if(data_count != region_electric_field_num.size()) {
-                    throw std::runtime_error("incorrect number of electrostatic potential points");
-                }
-
-                for(size_t i = 0; i < region_electric_field_num.size(); i += 1) {
-                    auto x = region_electric_field_num[i];
-                    region_electric_field_map[region][observable].emplace_back(x, 0, 0);
-                }
-
-                region_electric_field_num.clear();
-            }
-
-            if(main_section == DFSection::ELECTRIC_FIELD && sub_section == DFSection::VALUES) {
-                if(data_count != region_electric_field_num.size()) {
-                    throw std::runtime_error("incorrect number of electric field points");
-                }
-
-                if(dimension == 3) {
-                    for(size_t i = 0; i < region_electric_field_num.size(); i += 3) {
-                        auto x = region_electric_field_num[i];
-                        auto y = region_electric_field_num[i + 1];
-                        auto z = region_electric_field_num[i + 2];
-                        region_electric_field_map[region][observable].emplace_back(x, y, z);
-                    }
-                }
-
-                if(dimension == 2) {
-                    for(size_t i = 0; i < region_electric_field_num.size(); i += 2) {
-                        auto x = region_electric_field_num[i];
-                        auto y = region_electric_field_num[i + 1];
-                        region_electric_field_map[region][observable].emplace_back(0, x, y);
-                    }
-                }
-
-                region_electric_field_num.clear();
-            }
-
-            if(main_section == DFSection::DOPING_CONCENTRATION && sub_section == DFSection::VALUES) {
-                if(data_count != region_electric_field_num.size()) {
-                    throw std::runtime_error("incorrect number of points");
-                }
-
-                for(size_t i = 0; i < region_electric_field_num.size(); i += 1) {
-                    auto x = region_electric_field_num[i];
-                    region_electric_field_map[region][observable].emplace_back(x, 0, 0);
-                }
-
-                region_electric_field_num.clear();
-            }
-
-            if(main_section == DFSection::DONOR_CONCENTRATION && sub_section == DFSection::VALUES) {
-                if(data_count != region_electric_field_num.size()) {
-                    throw std::runtime_error("incorrect number of points");
-                }
-
-                for(size_t i = 0; i < region_electric_field_num.size(); i += 1) {
-                    auto x = region_electric_field_num[i];
-                    region_electric_field_map[region][observable].emplace_back(x, 0, 0);
-                }
-
-                region_electric_field_num.clear();
-            }
-
-            if(main_section == DFSection::ACCEPTOR_CONCENTRATION && sub_section == DFSection::VALUES) {
-                if(data_count != region_electric_field_num.size()) {
-                    throw std::runtime_error("incorrect number of points");
-                }
-
-                for(size_t i = 0; i < region_electric_field_num.size(); i += 1) {
-                    auto x = region_electric_field_num[i];
-                    region_electric_field_map[region][observable].emplace_back(x, 0, 0);
-                }
-
-                region_electric_field_num.clear();
+            if(in_values && (data_count != values_count || !region_electric_field_num.empty())) {
+                throw std::runtime_error("incorrect number of " + observable + " points");
             }
 
             // Close section
@@ -670,16 +655,28 @@ FieldMap DFISEParser::read_fields(const std::string& file_name, const std::strin
             continue;
         }
 
-        // Handle data
-        if((main_section == DFSection::ELECTRIC_FIELD || main_section == DFSection::ELECTROSTATIC_POTENTIAL ||
-            main_section == DFSection::DOPING_CONCENTRATION || main_section == DFSection::DONOR_CONCENTRATION ||
-            main_section == DFSection::ACCEPTOR_CONCENTRATION) &&
-           sub_section == DFSection::VALUES) {
-            std::stringstream sstr(line);
-            double num = NAN;
-            while(sstr >> num) {
-                region_electric_field_num.push_back(num);
+        // Handle data, storing data points as soon as all their components have been read
+        if(in_values) {
+            auto pending = region_electric_field_num.size();
+            parse_numbers(line, region_electric_field_num);
+            values_count += region_electric_field_num.size() - pending;
+
+            // Vector fields have two or three components, all other observables are scalar
+            auto components = (main_section == DFSection::ELECTRIC_FIELD ? dimension : 1);
+            auto& points = region_electric_field_map[region][observable];
+            size_t i = 0;
+            for(; i + components <= region_electric_field_num.size(); i += components) {
+                if(components == 3) {
+                    points.emplace_back(
+                        region_electric_field_num[i], region_electric_field_num[i + 1], region_electric_field_num[i + 2]);
+                } else if(components == 2) {
+                    points.emplace_back(0, region_electric_field_num[i], region_electric_field_num[i + 1]);
+                } else {
+                    points.emplace_back(region_electric_field_num[i], 0, 0);
+                }
             }
+            region_electric_field_num.erase(region_electric_field_num.begin(),
+                                            region_electric_field_num.begin() + static_cast<std::ptrdiff_t>(i));
         }
     }
     LOG_PROGRESS(STATUS, "fieldlines") << "Parsing field data file: done.";
@@ -13,6 +13,7 @@
 #include <cassert>
 #include <cstdlib>
 #include <exception>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <regex>
@@ -27,31 +28,30 @@
 
 using namespace mesh_converter;
 
-MeshMap SilvacoParser::read_meshes(const std::string& file_name) {
+MeshMap SilvacoParser::read_meshes(const std::string& file_name, ElementMap&) {
 
     std::ifstream file(file_name);
     if(!file) {
         throw std::runtime_error("file cannot be accessed");
     }
 
-    // Get the total number of lines to parse and reset file to the start:
-    auto num_lines = std::count(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>(), '\n');
-    file.clear();
-    file.seekg(0, std::ios::beg);
-    LOG(DEBUG) << "Grid file contains " << num_lines << " lines to parse";
+    // Get the file size to report the parsing progress without reading the file twice:
+    auto file_size = std::filesystem::file_size(file_name);
+    LOG(DEBUG) << "Grid file contains " << file_size << " bytes to parse";
 
     std::vector<Point> vertices;
 
     long unsigned int dimension = 1;
     long unsigned int columns_count = 0;
     long long num_lines_parsed = 0;
+    std::vector<double> coordinates;
     while(!file.eof()) {
         std::string line;
         std::getline(file, line);
 
         // Log the parsing progress:
-        if(num_lines > 0 && num_lines_parsed % 1000 == 0) {
-            LOG_PROGRESS(STATUS, "gridlines") << "Parsing grid file: " << (100 * num_lines_parsed / num_lines) << "%";
+        if(num_lines_parsed % 1000 == 0) {
+            LOG_PROGRESS(STATUS, "gridlines") << "Parsing grid file: " << parsing_progress(file, file_size) << "%";
         }
         num_lines_parsed++;
 
@@ -60,31 +60,25 @@ MeshMap SilvacoParser::read_meshes(const std::string& file_name) {
             continue;
         }
 
+        // Handle data
+        coordinates.clear();
+        parse_numbers(line, coordinates);
+
         // Determining number of columns by counting fields in first line
         if(num_lines_parsed == 1) {
-            std::istringstream iss;
-            iss.str(line);
-            double val = NAN;
-            while(iss >> val) {
-                columns_count++;
-            }
+            columns_count = coordinates.size();
             dimension = columns_count;
-            iss.clear();
         }
 
-        // Handle data
-        std::stringstream sstr(line);
         // Read vertex points
         if(dimension == 3) {
-            double x = 0, y = 0, z = 0;
-            while(sstr >> x >> y >> z) {
-                vertices.emplace_back(x, y, z);
+            for(size_t i = 0; i + 2 < coordinates.size(); i += 3) {
+                vertices.emplace_back(coordinates[i], coordinates[i + 1], coordinates[i + 2]);
             }
         }
         if(dimension == 2) {
-            double y = 0, z = 0;
-            while(sstr >> y >> z) {
-                vertices.emplace_back(y, z);
+            for(size_t i = 0; i + 1 < coordinates.size(); i += 2) {
+                vertices.emplace_back(coordinates[i], coordinates[i + 1]);
             }
         }
     }
@@ -99,11 +93,9 @@ FieldMap SilvacoParser::read_fields(const std::string& file_name, const std::str
         throw std::runtime_error("file cannot be accessed");
     }
 
-    // Get the total number of lines to parse and reset file to the start:
-    auto num_lines = std::count(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>(), '\n');
-    file.clear();
-    file.seekg(0, std::ios::beg);
-    LOG(DEBUG) << "Field data file contains " << num_lines << " lines to parse";
+    // Get the file size to report the parsing progress without reading the file twice:
+    auto file_size = std::filesystem::file_size(file_name);
+    LOG(DEBUG) << "Field data file contains " << file_size << " bytes to parse";
 
     // std::map<std::string, std::vector<Point>> region_electric_field_map;
     std::map<std::string, std::map<std::string, std::vector<Point>>> region_electric_field_map;
@@ -119,8 +111,8 @@ FieldMap SilvacoParser::read_fields(const std::string& file_name, const std::str
         line = allpix::trim(line);
 
         // Log the parsing progress:
-        if(num_lines > 0 && num_lines_parsed % 1000 == 0) {
-            LOG_PROGRESS(STATUS, "fieldlines") << "Parsing field data file: " << (100 * num_lines_parsed / num_lines) << "%";
+        if(num_lines_parsed % 1000 == 0) {
+            LOG_PROGRESS(STATUS, "fieldlines") << "Parsing field data file: " << parsing_progress(file, file_size) << "%";
         }
         num_lines_parsed++;
 
@@ -128,24 +120,13 @@ FieldMap SilvacoParser::read_fields(const std::string& file_name, const std::str
             continue;
         }
 
+        // Handle data
+        parse_numbers(line, region_electric_field_num);
+
         // Determining number of columns by counting fields in first line
         if(num_lines_parsed == 1) {
-            std::istringstream iss;
-            iss.str(line);
-            double val = NAN;
-            while(iss >> val) {
-                columns_count++;
-            }
+            columns_count = region_electric_field_num.size();
             dimension = columns_count;
-
-            iss.clear();
-        }
-
-        // Handle data
-        std::stringstream sstr(line);
-        double num = NAN;
-        while(sstr >> num) {
-            region_electric_field_num.push_back(num);
         }
 
         // Determining data type from dimensions